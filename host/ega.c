@@ -0,0 +1,371 @@
+/*
+ * ega.c - Software EGA for the host-native build
+ *
+ * See host_ega.h. Writes follow the EGA data path: in write mode 0 the CPU
+ * byte is rotated, replaced per plane by Set/Reset where enabled, combined
+ * with the latch by the logical function and merged with the latch under
+ * the Bit Mask; write mode 1 stores the latches; write mode 2 expands the
+ * low four CPU bits to whole planes. Only planes enabled in the Map Mask
+ * are written. Every read loads all four latches.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "host_ega.h"
+
+/* Sequencer registers */
+#define SEQ_MAP_MASK            0x02
+
+/* Graphics Controller registers */
+#define GC_SET_RESET            0x00
+#define GC_ENABLE_SET_RESET     0x01
+#define GC_COLOR_COMPARE        0x02
+#define GC_DATA_ROTATE          0x03
+#define GC_READ_MAP_SELECT      0x04
+#define GC_MODE                 0x05
+#define GC_COLOR_DONT_CARE      0x07
+#define GC_BIT_MASK             0x08
+
+/* CRTC registers */
+#define CRTC_START_HIGH         0x0c
+#define CRTC_START_LOW          0x0d
+
+/* Bytes per scan line in mode 0Dh */
+#define EGA_ROW_BYTES           40
+
+static uint8_t planes[4][HOST_EGA_PLANE_SIZE];
+static uint8_t latch[4];
+
+static uint8_t seq_index;
+static uint8_t seq_regs[8];
+static uint8_t gc_index;
+static uint8_t gc_regs[16];
+static uint8_t crtc_index;
+static uint8_t crtc_regs[32];
+static uint8_t attr_flip_flop;     /* 0 = next 0x3C0 write is an index */
+static uint8_t attr_index;
+static uint8_t palette[16];
+static uint8_t input_status;
+
+/* Palette after a mode 0Dh set by the game (see init_default_palette) */
+static const uint8_t default_palette[16] = {
+    0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+    0x38, 0x39, 0x3a, 0x3b, 0x3c, 0x3d, 0x3e, 0x3f
+};
+
+void host_ega_reset(void)
+{
+    memset(planes, 0, sizeof(planes));
+    memset(latch, 0, sizeof(latch));
+    memset(seq_regs, 0, sizeof(seq_regs));
+    memset(gc_regs, 0, sizeof(gc_regs));
+    memset(crtc_regs, 0, sizeof(crtc_regs));
+    seq_index = 0;
+    gc_index = 0;
+    crtc_index = 0;
+    attr_flip_flop = 0;
+    attr_index = 0;
+    input_status = 0;
+
+    seq_regs[SEQ_MAP_MASK] = 0x0f;
+    gc_regs[GC_COLOR_DONT_CARE] = 0x0f;
+    gc_regs[GC_BIT_MASK] = 0xff;
+    memcpy(palette, default_palette, sizeof(palette));
+}
+
+uint8_t host_ega_read(uint16_t offset)
+{
+    uint8_t plane;
+    uint8_t result;
+    uint8_t care;
+    uint8_t compare;
+
+    for (plane = 0; plane < 4; plane++) {
+        latch[plane] = planes[plane][offset];
+    }
+
+    if ((gc_regs[GC_MODE] & 0x08) == 0) {
+        return latch[gc_regs[GC_READ_MAP_SELECT] & 0x03];
+    }
+
+    /* Read mode 1: bit set where every cared-about plane matches Color Compare */
+    result = 0xff;
+    care = gc_regs[GC_COLOR_DONT_CARE];
+    compare = gc_regs[GC_COLOR_COMPARE];
+    for (plane = 0; plane < 4; plane++) {
+        if (care & (1 << plane)) {
+            result &= (uint8_t)~(latch[plane] ^ ((compare & (1 << plane)) ? 0xff : 0x00));
+        }
+    }
+    return result;
+}
+
+/*
+ * combine - Apply the logical function and Bit Mask to one plane's byte
+ */
+static uint8_t combine(uint8_t value, uint8_t plane)
+{
+    uint8_t bit_mask = gc_regs[GC_BIT_MASK];
+
+    switch ((gc_regs[GC_DATA_ROTATE] >> 3) & 0x03) {
+    case 1:
+        value &= latch[plane];
+        break;
+    case 2:
+        value |= latch[plane];
+        break;
+    case 3:
+        value ^= latch[plane];
+        break;
+    default:
+        break;
+    }
+    return (uint8_t)((value & bit_mask) | (latch[plane] & ~bit_mask));
+}
+
+/*
+ * plain_writes - Nonzero when a CPU byte goes unchanged to every enabled plane
+ */
+static uint8_t plain_writes(void)
+{
+    return (gc_regs[GC_MODE] & 0x03) == 0 && (gc_regs[GC_ENABLE_SET_RESET] & 0x0f) == 0 &&
+           gc_regs[GC_DATA_ROTATE] == 0 && gc_regs[GC_BIT_MASK] == 0xff;
+}
+
+void host_ega_write(uint16_t offset, uint8_t value)
+{
+    uint8_t map_mask = seq_regs[SEQ_MAP_MASK] & 0x0f;
+    uint8_t write_mode = gc_regs[GC_MODE] & 0x03;
+    uint8_t enable_set_reset = gc_regs[GC_ENABLE_SET_RESET] & 0x0f;
+    uint8_t set_reset = gc_regs[GC_SET_RESET];
+    uint8_t rotate = gc_regs[GC_DATA_ROTATE] & 0x07;
+    uint8_t plane;
+    uint8_t plane_value;
+
+    /* Plain writes are by far the most common; skip the data path */
+    if (plain_writes()) {
+        for (plane = 0; plane < 4; plane++) {
+            if (map_mask & (1 << plane)) {
+                planes[plane][offset] = value;
+            }
+        }
+        return;
+    }
+
+    if (rotate != 0) {
+        value = (uint8_t)((value >> rotate) | (value << (8 - rotate)));
+    }
+
+    for (plane = 0; plane < 4; plane++) {
+        if ((map_mask & (1 << plane)) == 0) {
+            continue;
+        }
+        switch (write_mode) {
+        case 1:
+            plane_value = latch[plane];
+            break;
+        case 2:
+            plane_value = combine((value & (1 << plane)) ? 0xff : 0x00, plane);
+            break;
+        default:
+            if (enable_set_reset & (1 << plane)) {
+                plane_value = combine((set_reset & (1 << plane)) ? 0xff : 0x00, plane);
+            } else {
+                plane_value = combine(value, plane);
+            }
+            break;
+        }
+        planes[plane][offset] = plane_value;
+    }
+}
+
+void host_ega_write16(uint16_t offset, uint16_t value)
+{
+    host_ega_write(offset, (uint8_t)value);
+    host_ega_write((uint16_t)(offset + 1), (uint8_t)(value >> 8));
+}
+
+void host_ega_fill(uint16_t offset, uint8_t value, uint16_t count)
+{
+    uint8_t plane;
+
+    if (plain_writes() && (uint32_t)offset + count <= HOST_EGA_PLANE_SIZE) {
+        for (plane = 0; plane < 4; plane++) {
+            if (seq_regs[SEQ_MAP_MASK] & (1 << plane)) {
+                memset(&planes[plane][offset], value, count);
+            }
+        }
+        return;
+    }
+    while (count-- > 0) {
+        host_ega_write(offset++, value);
+    }
+}
+
+void host_ega_copy_to(uint16_t offset, const void *src, uint16_t count)
+{
+    const uint8_t *bytes = (const uint8_t *)src;
+    uint8_t plane;
+
+    if (plain_writes() && (uint32_t)offset + count <= HOST_EGA_PLANE_SIZE) {
+        for (plane = 0; plane < 4; plane++) {
+            if (seq_regs[SEQ_MAP_MASK] & (1 << plane)) {
+                memcpy(&planes[plane][offset], bytes, count);
+            }
+        }
+        return;
+    }
+    while (count-- > 0) {
+        host_ega_write(offset++, *bytes++);
+    }
+}
+
+void host_ega_copy_from(void *dst, uint16_t offset, uint16_t count)
+{
+    uint8_t *bytes = (uint8_t *)dst;
+
+    while (count-- > 0) {
+        *bytes++ = host_ega_read(offset++);
+    }
+}
+
+void host_ega_set_palette(uint8_t index, uint8_t color)
+{
+    palette[index & 0x0f] = color & 0x3f;
+}
+
+uint8_t host_ega_port_out(uint16_t port, uint8_t value)
+{
+    switch (port) {
+    case 0x3c0:
+        if (attr_flip_flop == 0) {
+            attr_index = value & 0x1f;
+        } else if (attr_index < 0x10) {
+            palette[attr_index] = value & 0x3f;
+        }
+        attr_flip_flop ^= 1;
+        break;
+    case 0x3c4:
+        seq_index = value & 0x07;
+        break;
+    case 0x3c5:
+        seq_regs[seq_index] = value;
+        break;
+    case 0x3ce:
+        gc_index = value & 0x0f;
+        break;
+    case 0x3cf:
+        gc_regs[gc_index] = value;
+        break;
+    case 0x3d4:
+        crtc_index = value & 0x1f;
+        break;
+    case 0x3d5:
+        crtc_regs[crtc_index] = value;
+        break;
+    default:
+        return 0;
+    }
+    return 1;
+}
+
+uint8_t host_ega_port_in(uint16_t port, uint8_t *value)
+{
+    switch (port) {
+    case 0x3c4:
+        *value = seq_index;
+        break;
+    case 0x3c5:
+        *value = seq_regs[seq_index];
+        break;
+    case 0x3ce:
+        *value = gc_index;
+        break;
+    case 0x3cf:
+        *value = gc_regs[gc_index];
+        break;
+    case 0x3d4:
+        *value = crtc_index;
+        break;
+    case 0x3d5:
+        *value = crtc_regs[crtc_index];
+        break;
+    case 0x3da:
+        /* Input Status 1: alternate display enable and vertical retrace so
+         * that retrace waits finish; reading also resets the 0x3C0 flip-flop */
+        input_status ^= 0x09;
+        attr_flip_flop = 0;
+        *value = input_status;
+        break;
+    default:
+        return 0;
+    }
+    return 1;
+}
+
+uint16_t host_ega_display_start(void)
+{
+    return (uint16_t)((crtc_regs[CRTC_START_HIGH] << 8) | crtc_regs[CRTC_START_LOW]);
+}
+
+void host_ega_render_indexed(uint8_t *pixels)
+{
+    uint16_t row_offset = host_ega_display_start();
+    uint16_t offset;
+    uint16_t y;
+    uint16_t x;
+    uint8_t bit;
+    uint8_t b0, b1, b2, b3;
+
+    for (y = 0; y < HOST_EGA_HEIGHT; y++) {
+        offset = row_offset;
+        for (x = 0; x < EGA_ROW_BYTES; x++) {
+            b0 = planes[0][offset];
+            b1 = planes[1][offset];
+            b2 = planes[2][offset];
+            b3 = planes[3][offset];
+            for (bit = 0x80; bit != 0; bit >>= 1) {
+                *pixels++ = (uint8_t)(((b0 & bit) ? 1 : 0) | ((b1 & bit) ? 2 : 0) |
+                                      ((b2 & bit) ? 4 : 0) | ((b3 & bit) ? 8 : 0));
+            }
+            offset++;
+        }
+        row_offset += EGA_ROW_BYTES;
+    }
+}
+
+/*
+ * ega_color_level - One RGB channel of a 6-bit EGA color (rgbRGB)
+ */
+static uint8_t ega_color_level(uint8_t color, uint8_t primary_bit, uint8_t secondary_bit)
+{
+    return (uint8_t)(((color & primary_bit) ? 0xaa : 0x00) + ((color & secondary_bit) ? 0x55 : 0x00));
+}
+
+int host_ega_write_ppm(const char *path)
+{
+    static uint8_t pixels[HOST_EGA_FRAME_SIZE];
+    static uint8_t rgb[HOST_EGA_FRAME_SIZE * 3];
+    FILE *out;
+    uint32_t i;
+    uint8_t color;
+
+    host_ega_render_indexed(pixels);
+    for (i = 0; i < HOST_EGA_FRAME_SIZE; i++) {
+        color = palette[pixels[i]];
+        rgb[i * 3 + 0] = ega_color_level(color, 0x04, 0x20);
+        rgb[i * 3 + 1] = ega_color_level(color, 0x02, 0x10);
+        rgb[i * 3 + 2] = ega_color_level(color, 0x01, 0x08);
+    }
+
+    out = fopen(path, "wb");
+    if (out == NULL) {
+        fprintf(stderr, "ERROR: Cannot create '%s'\n", path);
+        return -1;
+    }
+    fprintf(out, "P6\n%d %d\n255\n", HOST_EGA_WIDTH, HOST_EGA_HEIGHT);
+    fwrite(rgb, 1, sizeof(rgb), out);
+    fclose(out);
+    return 0;
+}
@@ -0,0 +1,465 @@
+/*
+ * host_sim.c - Headless simulation driver for the host-native build
+ *
+ * Runs the game's own level loading and game tick code (run_game_tick() in
+ * game_main.c, with physics, actors, doors and the rest linked in) as fast
+ * as the host allows. Input comes from a seeded pseudo-random player that
+ * presses and releases the default keymap's keys, so a given seed always
+ * produces the same run.
+ *
+ * Usage:
+ *   comic-sim [-d datadir] [-l level] [-t ticks] [-s seed] [-o prefix] [-f every]
+ *             [-r file.rpl | -p file.rpl] [-k tick] [-b ticks] [-m] [-P] [-T] [-i]
+ *
+ *   -d datadir  directory holding the original game data (.TT2, .PT, .SHP)
+ *   -l level    level number to start on (0-7, default 1 = forest)
+ *   -t ticks    number of game ticks to run (default 100000)
+ *   -s seed     input seed (default 1)
+ *   -o prefix   write the displayed frame as <prefix>NNNNNN.ppm, NNNNNN
+ *               being the tick number
+ *   -f every    with -o, write every Nth tick's frame (default 1)
+ *   -r file     record the run's input to a replay file (see replay.h)
+ *   -p file     play a replay file back instead of generating input; runs
+ *               to the end of the recording unless -t is given
+ *   -k tick     take a snapshot (see snapshot.h) after that tick and restore
+ *               it when the run ends, so the summary shows the state at that
+ *               tick as restored from the snapshot
+ *   -b ticks    when the run ends, step back that many ticks through the
+ *               rewind buffer (see rewind.h), as F9 does in the game, so
+ *               the summary shows the state the run had that many ticks
+ *               before its end
+ *   -m          draw masked sprites with the Bit Mask engine, as /BITMASK
+ *               does in the game
+ *   -P          time each phase of every tick (see profile.h) and print
+ *               the table, in host microseconds (to DEBUG.LOG in datadir,
+ *               as on DOS, if the game exits)
+ *   -T          record the tick trace (see trace.h) and write TRACE.BIN
+ *               into datadir when the run ends
+ *   -i          instead of a normal run, check that games are independent:
+ *               step two games (seeds s and s+1) in turn for the given
+ *               number of ticks, then run each again on its own and
+ *               compare their final snapshots; exits with 1 if they differ
+ *
+ * Rendering runs against the software EGA (host/ega.c). Prints the tick
+ * rate, a summary of the final game state and a checksum of the final
+ * displayed frame, which is stable for a given data set, level and seed.
+ * The run ends early if the game exits (game over or win).
+ */
+
+#include <stdint.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <limits.h>
+#include <string.h>
+#include <setjmp.h>
+#include <time.h>
+#include <unistd.h>
+#include "host_platform.h"
+#include "host_ega.h"
+#include "i86.h"
+#include "globals.h"
+#include "graphics.h"
+#include "replay.h"
+#include "game_state.h"
+#include "snapshot.h"
+#include "rewind.h"
+#include "profile.h"
+#include "log.h"
+#include "trace.h"
+#include "vram.h"
+
+/* Default keymap scancodes (see default_keymap[] in game_state.c) */
+#define SCANCODE_JUMP       0x39  /* Space */
+#define SCANCODE_FIRE       0x52  /* Insert */
+#define SCANCODE_LEFT       0x4b  /* Left arrow */
+#define SCANCODE_RIGHT      0x4d  /* Right arrow */
+#define SCANCODE_OPEN       0x38  /* Alt */
+#define SCANCODE_TELEPORT   0x3a  /* Caps Lock */
+#define SCANCODE_BREAK      0x80
+
+#define NUM_SIM_KEYS        6
+
+/* Game entry points from game_main.c */
+extern void install_interrupt_handlers(void);
+extern int begin_game(void);
+extern uint8_t run_game_tick(void);
+
+static const uint8_t sim_keys[NUM_SIM_KEYS] = {
+    SCANCODE_JUMP, SCANCODE_FIRE, SCANCODE_LEFT,
+    SCANCODE_RIGHT, SCANCODE_OPEN, SCANCODE_TELEPORT
+};
+
+/* Chance per tick, out of 256, that a key changes state (pressed, released) */
+static const uint8_t sim_key_press_odds[NUM_SIM_KEYS] = { 24, 16, 8, 24, 4, 1 };
+static const uint8_t sim_key_release_odds[NUM_SIM_KEYS] = { 32, 32, 48, 8, 64, 128 };
+
+/* A pseudo-random player and the game it plays */
+typedef struct {
+    game_state_t *state;
+    uint8_t key_down[NUM_SIM_KEYS];
+    uint32_t random_state;
+} sim_player_t;
+
+static sim_player_t sim_player;
+
+/* Games for -i: two stepped in turn, and one to rerun each alone */
+static game_state_t check_games[3];
+
+/* File scope so that they survive the longjmp from terminate_program() */
+static unsigned long ticks_run = 0;
+static struct timespec start_time;
+static uint8_t snapshot[SNAPSHOT_SIZE];
+static uint8_t snapshot_taken = 0;
+static unsigned long rewind_ticks = 0;
+
+static uint8_t sim_random(sim_player_t *player)
+{
+    player->random_state = player->random_state * 1103515245UL + 12345UL;
+    return (uint8_t)(player->random_state >> 16);
+}
+
+/*
+ * sim_input - Feed one tick of pseudo-random key presses to the keyboard ISR
+ *
+ * The scancodes go to the current game, which must be player->state.
+ */
+static void sim_input(sim_player_t *player)
+{
+    uint8_t i;
+
+    for (i = 0; i < NUM_SIM_KEYS; i++) {
+        if (!player->key_down[i] && sim_random(player) < sim_key_press_odds[i]) {
+            player->key_down[i] = 1;
+            host_keyboard_scancode(sim_keys[i]);
+        } else if (player->key_down[i] && sim_random(player) < sim_key_release_odds[i]) {
+            player->key_down[i] = 0;
+            host_keyboard_scancode((uint8_t)(sim_keys[i] | SCANCODE_BREAK));
+        }
+    }
+}
+
+/*
+ * start_player_game - Start a fresh game for a player and make it current
+ *
+ * Input:
+ *   player = player, with state pointing at the game to start
+ *   level  = level to start on
+ *   seed   = the player's input seed
+ *
+ * Returns:
+ *   0 on success, -1 if the game could not start
+ */
+static int start_player_game(sim_player_t *player, uint8_t level, uint32_t seed)
+{
+    memset(player->key_down, 0, sizeof(player->key_down));
+    player->random_state = seed;
+    game_state_init(player->state);
+    game_select(player->state);
+    GAME->current_level_number = level;
+    return begin_game();
+}
+
+/*
+ * check_interleaved - Check that games stepped in turn do not affect each other
+ *
+ * Steps two games a tick at a time in turn, saving each one's final
+ * snapshot, then plays each again alone from the same seed and compares.
+ * Only game state is compared: the screen is shared, so it shows
+ * whichever game was drawn last.
+ *
+ * Input:
+ *   level = level both games start on
+ *   ticks = ticks each game runs
+ *   seed  = seed of the first game; the second uses seed + 1
+ *
+ * Returns:
+ *   0 if each game ended as it does alone, -1 otherwise
+ */
+static int check_interleaved(uint8_t level, unsigned long ticks, uint32_t seed)
+{
+    static uint8_t interleaved[2][SNAPSHOT_SIZE];
+    static uint8_t alone[SNAPSHOT_SIZE];
+    sim_player_t players[2];
+    sim_player_t single;
+    unsigned long tick;
+    uint8_t g;
+    int result = 0;
+
+    for (g = 0; g < 2; g++) {
+        players[g].state = &check_games[g];
+        if (start_player_game(&players[g], level, seed + g) != 0) {
+            return -1;
+        }
+    }
+    for (tick = 0; tick < ticks; tick++) {
+        for (g = 0; g < 2; g++) {
+            game_select(players[g].state);
+            sim_input(&players[g]);
+            run_game_tick();
+        }
+    }
+    for (g = 0; g < 2; g++) {
+        game_select(players[g].state);
+        snapshot_save(interleaved[g]);
+    }
+
+    single.state = &check_games[2];
+    for (g = 0; g < 2; g++) {
+        if (start_player_game(&single, level, seed + g) != 0) {
+            return -1;
+        }
+        for (tick = 0; tick < ticks; tick++) {
+            sim_input(&single);
+            run_game_tick();
+        }
+        snapshot_save(alone);
+        if (memcmp(alone, interleaved[g], SNAPSHOT_SIZE) == 0) {
+            printf("Interleave: seed %lu matches after %lu ticks\n", (unsigned long)(seed + g), ticks);
+        } else {
+            printf("Interleave: seed %lu differs after %lu ticks\n", (unsigned long)(seed + g), ticks);
+            result = -1;
+        }
+    }
+    return result;
+}
+
+/*
+ * frame_checksum - FNV-1a hash of the displayed frame's color indices
+ */
+static uint32_t frame_checksum(void)
+{
+    static uint8_t pixels[HOST_EGA_FRAME_SIZE];
+    uint32_t hash = 2166136261UL;
+    uint32_t i;
+
+    host_ega_render_indexed(pixels);
+    for (i = 0; i < HOST_EGA_FRAME_SIZE; i++) {
+        hash = (hash ^ pixels[i]) * 16777619UL;
+    }
+    return hash;
+}
+
+/*
+ * dump_frame - Write the displayed frame for one tick as a PPM file
+ */
+static int dump_frame(const char *prefix, unsigned long tick)
+{
+    char path[512];
+
+    snprintf(path, sizeof(path), "%s%06lu.ppm", prefix, tick);
+    return host_ega_write_ppm(path);
+}
+
+static double elapsed_seconds(const struct timespec *start, const struct timespec *end)
+{
+    return (double)(end->tv_sec - start->tv_sec) +
+           (double)(end->tv_nsec - start->tv_nsec) / 1e9;
+}
+
+/* profile_report() prints through a void function */
+static void print_profile(const char *format, ...)
+{
+    va_list args;
+
+    va_start(args, format);
+    vprintf(format, args);
+    va_end(args);
+}
+
+static void usage(const char *program)
+{
+    fprintf(stderr, "Usage: %s [-d datadir] [-l level] [-t ticks] [-s seed] "
+            "[-o prefix] [-f every] [-r file.rpl | -p file.rpl] [-k tick] [-b ticks] [-m] [-P] [-T] [-i]\n", program);
+}
+
+int main(int argc, char *argv[])
+{
+    jmp_buf exit_jump;
+    union REGS regs;
+    const char *data_dir = NULL;
+    const char *frame_prefix = NULL;
+    unsigned long frame_every = 1;
+    const char *record_file = NULL;
+    const char *playback_file = NULL;
+    uint8_t ticks_given = 0;
+    unsigned long max_ticks = 100000UL;
+    unsigned long snapshot_tick = 0;
+    unsigned long rewound = 0;
+    struct timespec restore_start;
+    uint8_t start_level = LEVEL_NUMBER_FOREST;
+    uint32_t seed = 1;
+    uint8_t interleave = 0;
+    struct timespec end_time;
+    double seconds;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "d:l:t:s:o:f:r:p:k:b:mPTi")) != -1) {
+        switch (opt) {
+        case 'd':
+            data_dir = optarg;
+            break;
+        case 'l':
+            start_level = (uint8_t)atoi(optarg);
+            break;
+        case 't':
+            max_ticks = strtoul(optarg, NULL, 10);
+            ticks_given = 1;
+            break;
+        case 's':
+            seed = (uint32_t)strtoul(optarg, NULL, 10);
+            break;
+        case 'o':
+            frame_prefix = optarg;
+            break;
+        case 'f':
+            frame_every = strtoul(optarg, NULL, 10);
+            if (frame_every == 0) {
+                frame_every = 1;
+            }
+            break;
+        case 'r':
+            record_file = optarg;
+            break;
+        case 'p':
+            playback_file = optarg;
+            break;
+        case 'k':
+            snapshot_tick = strtoul(optarg, NULL, 10);
+            break;
+        case 'b':
+            rewind_ticks = strtoul(optarg, NULL, 10);
+            break;
+        case 'm':
+            set_masked_blit_engine(MASKED_BLIT_ENGINE_BITMASK);
+            break;
+        case 'P':
+            profile_start(PROFILE_BARS_OFF);
+            break;
+        case 'T':
+            if (trace_start() != 0) {
+                return 1;
+            }
+            break;
+        case 'i':
+            interleave = 1;
+            break;
+        default:
+            usage(argv[0]);
+            return 1;
+        }
+    }
+
+    /* Replay files are named relative to where comic-sim was started, and
+     * belong to the game they are opened for */
+    game_state_init(&game_state);
+    if (playback_file != NULL) {
+        if (replay_open_playback(playback_file) != 0) {
+            return 1;
+        }
+        if (!ticks_given) {
+            max_ticks = ULONG_MAX;
+        }
+    } else if (record_file != NULL && replay_open_record(record_file) != 0) {
+        return 1;
+    }
+
+    if (data_dir != NULL && chdir(data_dir) != 0) {
+        fprintf(stderr, "ERROR: Cannot change to data directory '%s'\n", data_dir);
+        return 1;
+    }
+
+    /* terminate_program() lands here instead of ending the process */
+    clock_gettime(CLOCK_MONOTONIC, &start_time);
+    host_exit_jump = &exit_jump;
+    if (setjmp(exit_jump) != 0) {
+        clock_gettime(CLOCK_MONOTONIC, &end_time);
+        printf("Game exited (code %d)\n", host_exit_code);
+        if (interleave) {
+            fprintf(stderr, "ERROR: A game exited before the interleave check finished; use fewer ticks\n");
+            return 1;
+        }
+        goto report;
+    }
+
+    install_interrupt_handlers();
+
+    /* Same video setup as title_sequence(): mode 0Dh, write mode 0, palette */
+    regs.h.ah = 0x00;
+    regs.h.al = 0x0d;
+    int86(0x10, &regs, &regs);
+    init_ega_graphics();
+    init_default_palette();
+
+    if (interleave) {
+        return check_interleaved(start_level, max_ticks, seed) == 0 ? 0 : 1;
+    }
+
+    sim_player.state = &game_state;
+    sim_player.random_state = seed;
+    GAME->current_level_number = start_level;
+    if (begin_game() != 0) {
+        return 1;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &start_time);
+    while (ticks_run < max_ticks) {
+        if (GAME->replay.mode != REPLAY_PLAYBACK) {
+            sim_input(&sim_player);
+        }
+        ticks_run++;
+        if (!run_game_tick()) {
+            break;
+        }
+        if (ticks_run == snapshot_tick) {
+            snapshot_save(snapshot);
+            snapshot_taken = 1;
+        }
+        if (frame_prefix != NULL && ticks_run % frame_every == 0 &&
+            dump_frame(frame_prefix, ticks_run) != 0) {
+            return 1;
+        }
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end_time);
+    replay_close();
+    log_flush();
+    debug_log_close();
+    trace_dump();
+
+report:
+    seconds = elapsed_seconds(&start_time, &end_time);
+    printf("Ticks:  %lu in %.3f s (%.0f ticks/s)\n", ticks_run, seconds,
+           seconds > 0.0 ? (double)ticks_run / seconds : 0.0);
+    if (snapshot_taken) {
+        clock_gettime(CLOCK_MONOTONIC, &restore_start);
+        if (snapshot_restore(snapshot) != 0) {
+            return 1;
+        }
+        clock_gettime(CLOCK_MONOTONIC, &end_time);
+        printf("Snapshot: %u bytes from tick %lu, restored in %.1f us\n",
+               (unsigned)SNAPSHOT_SIZE, snapshot_tick,
+               elapsed_seconds(&restore_start, &end_time) * 1e6);
+    }
+    profile_report(print_profile);
+    VRAM_STATS_REPORT(print_profile);
+    if (rewind_ticks > 0) {
+        printf("Rewind: %u ticks held in %u bytes", rewind_ticks_held(), rewind_bytes_used());
+        clock_gettime(CLOCK_MONOTONIC, &restore_start);
+        while (rewound < rewind_ticks && rewind_step_back() == 0) {
+            rewound++;
+        }
+        clock_gettime(CLOCK_MONOTONIC, &end_time);
+        printf(", stepped back %lu in %.1f us\n", rewound,
+               elapsed_seconds(&restore_start, &end_time) * 1e6);
+    }
+    printf("Level:  %u stage %u\n", GAME->current_level_number, GAME->current_stage_number);
+    printf("Comic:  x=%u y=%u hp=%u camera_x=%u\n", GAME->comic_x, GAME->comic_y, GAME->comic_hp, GAME->camera_x);
+    printf("Score:  %lu\n", ((unsigned long)GAME->score_bytes[2] * 10000UL +
+           (unsigned long)GAME->score_bytes[1] * 100UL + GAME->score_bytes[0]) * 100UL);
+    if (record_file != NULL || playback_file != NULL) {
+        printf("Replay: %lu ticks\n", (unsigned long)GAME->replay.ticks);
+    }
+    printf("Frame:  start=0x%04x checksum=%08lx\n", host_ega_display_start(),
+           (unsigned long)frame_checksum());
+    return 0;
+}
@@ -0,0 +1,15 @@
+/*
+ * conio.h - Host stand-in for Open Watcom's <conio.h>
+ *
+ * Port I/O against the host port latches.
+ */
+
+#ifndef HOST_CONIO_H
+#define HOST_CONIO_H
+
+#include "host_platform.h"
+
+unsigned inp(unsigned port);
+unsigned outp(unsigned port, unsigned value);
+
+#endif /* HOST_CONIO_H */
@@ -0,0 +1,16 @@
+/*
+ * dos.h - Host stand-in for Open Watcom's <dos.h>
+ *
+ * Interrupt vector calls backed by the host vector table.
+ */
+
+#ifndef HOST_DOS_H
+#define HOST_DOS_H
+
+#include "i86.h"
+
+host_isr_t _dos_getvect(unsigned vector);
+void _dos_setvect(unsigned vector, host_isr_t handler);
+void _chain_intr(host_isr_t handler);
+
+#endif /* HOST_DOS_H */
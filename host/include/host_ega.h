@@ -0,0 +1,64 @@
+/*
+ * host_ega.h - Software EGA for the host-native build
+ *
+ * Emulates the parts of an EGA card in mode 0Dh (320x200, 16 colors) that
+ * the game programs: four 64 KB bit planes, the Sequencer Map Mask, the
+ * Graphics Controller (Set/Reset, Enable Set/Reset, Color Compare, Data
+ * Rotate and logical function, Read Map Select, Mode, Color Don't Care,
+ * Bit Mask), the four latches, the CRTC start address and the 16 Attribute
+ * Controller palette registers.
+ *
+ * Rendering code reaches the planes through the VRAM_* macros in vram.h,
+ * which in the host build call host_ega_read()/host_ega_write() with the
+ * offset into segment 0xA000. Register writes arrive through outp() (see
+ * platform.c) and palette changes through INT 10h AH=10h.
+ */
+
+#ifndef HOST_EGA_H
+#define HOST_EGA_H
+
+#include <stdint.h>
+#include "host_platform.h"
+
+#define HOST_EGA_PLANE_SIZE     0x10000UL
+#define HOST_EGA_WIDTH          320
+#define HOST_EGA_HEIGHT         200
+#define HOST_EGA_FRAME_SIZE     (HOST_EGA_WIDTH * HOST_EGA_HEIGHT)
+
+/* Offset into segment 0xA000 of a pointer made with MK_FP(0xa000, offset) */
+#define HOST_EGA_OFFSET(ptr) \
+    ((uint16_t)((const uint8_t *)(ptr) - (host_memory + 0xa0000UL)))
+
+/* Put the card in its power-on state: planes cleared, default registers */
+void host_ega_reset(void);
+
+/* CPU access to video memory */
+uint8_t host_ega_read(uint16_t offset);
+void host_ega_write(uint16_t offset, uint8_t value);
+void host_ega_write16(uint16_t offset, uint16_t value);
+void host_ega_fill(uint16_t offset, uint8_t value, uint16_t count);
+void host_ega_copy_to(uint16_t offset, const void *src, uint16_t count);
+void host_ega_copy_from(void *dst, uint16_t offset, uint16_t count);
+
+/* Register ports 0x3C0-0x3DF; returns 1 if the port belongs to the EGA */
+uint8_t host_ega_port_out(uint16_t port, uint8_t value);
+uint8_t host_ega_port_in(uint16_t port, uint8_t *value);
+
+/* Attribute Controller palette register (INT 10h AX=1000h) */
+void host_ega_set_palette(uint8_t index, uint8_t color);
+
+/* CRTC start address: the offset of the displayed page */
+uint16_t host_ega_display_start(void);
+
+/*
+ * host_ega_render_indexed - Decode the displayed page into 320x200 pixels
+ *
+ * Each output byte is the 4-bit color index from the planes (before the
+ * palette), one byte per pixel, rows top to bottom.
+ */
+void host_ega_render_indexed(uint8_t *pixels);
+
+/* Write the displayed page through the palette as a binary PPM (P6) */
+int host_ega_write_ppm(const char *path);
+
+#endif /* HOST_EGA_H */
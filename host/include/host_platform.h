@@ -0,0 +1,91 @@
+/*
+ * host_platform.h - Platform shim for the host-native (Linux) build
+ *
+ * The game sources are written for Open Watcom's 16-bit DOS target. For
+ * `make host` they are compiled unchanged with the host C compiler against
+ * the stand-in <dos.h>, <conio.h>, <i86.h> and <io.h> in this directory,
+ * which all include this header. The shim covers:
+ *   - far pointers: __far and __interrupt compile away and MK_FP(seg, off)
+ *     addresses host_memory, a flat copy of the real-mode address space
+ *     (so segment 0x0000 is the BIOS data area); pointers into segment
+ *     0xA000 only mark a video memory offset for the VRAM_* macros
+ *   - port I/O: outp() latches the value per port, inp() returns it;
+ *     the EGA register ports go to the software EGA (host_ega.h)
+ *   - interrupts: _dos_setvect() fills a host vector table; INT 28h (DOS
+ *     idle, issued by every tick wait) delivers one timer interrupt
+ *   - BIOS and DOS services through int86(): just enough of INT 10h, 16h,
+ *     1Ah and 21h for the game to run headless
+ *   - DOS file calls: _open() and friends map onto POSIX, with DOS-style
+ *     case-insensitive filename matching
+ */
+
+#ifndef HOST_PLATFORM_H
+#define HOST_PLATFORM_H
+
+#include <stdint.h>
+#include <string.h>
+#include <strings.h>
+#include <setjmp.h>
+
+/* Open Watcom keywords */
+#ifndef __far
+#define __far
+#endif
+#ifndef __interrupt
+#define __interrupt
+#endif
+#ifndef __cdecl
+#define __cdecl
+#endif
+
+/* Open Watcom far-memory and string helpers */
+#define _fmemcpy    memcpy
+#define _fmemset    memset
+#define _fmemcmp    memcmp
+#define stricmp     strcasecmp
+#define strnicmp    strncasecmp
+
+/* Real-mode address space: 1 MB plus the 64 KB a segment can reach past it */
+#define HOST_MEMORY_SIZE    0x110000UL
+
+extern uint8_t host_memory[HOST_MEMORY_SIZE];
+
+#define HOST_LINEAR(seg, off) (((uint32_t)(uint16_t)(seg) << 4) + (uint16_t)(off))
+
+/* Interrupt handlers as installed with _dos_setvect() */
+typedef void (*host_isr_t)(void);
+
+extern host_isr_t host_vectors[256];
+
+/* Port latches: the last value written to each I/O port */
+extern uint8_t host_ports[65536];
+
+/* BIOS tick count (INT 1Ah AH=00h), advanced by every timer interrupt */
+extern uint32_t host_bios_ticks;
+
+/*
+ * host_exit_jump - Where terminate_program's INT 21h AH=4Ch returns to
+ *
+ * When set, exiting to DOS longjmps here (with host_exit_code holding AL)
+ * instead of ending the host process.
+ */
+extern jmp_buf *host_exit_jump;
+extern int host_exit_code;
+
+/* Deliver a hardware interrupt to the installed handler, if any */
+void host_raise_interrupt(uint8_t vector);
+
+/* One IRQ0 (INT 8); the game's handler sets the tick flag every second one */
+void host_timer_interrupt(void);
+
+/* Put a scancode on port 0x60 and deliver IRQ1 (INT 9) */
+void host_keyboard_scancode(uint8_t scancode);
+
+/* Convert between host pointers into host_memory and segment:offset */
+uint16_t host_fp_seg(const void *ptr);
+uint16_t host_fp_off(const void *ptr);
+
+/* Backing for the <io.h> stand-in */
+int host_open(const char *path, int flags, ...);
+
+#endif /* HOST_PLATFORM_H */
@@ -0,0 +1,44 @@
+/*
+ * i86.h - Host stand-in for Open Watcom's <i86.h>
+ *
+ * Register structures and int86()/int86x() for the host build; see
+ * host_platform.h for which services are emulated.
+ */
+
+#ifndef HOST_I86_H
+#define HOST_I86_H
+
+#include "host_platform.h"
+
+struct WORDREGS {
+    uint16_t ax, bx, cx, dx, si, di;
+    uint16_t cflag;
+};
+
+struct BYTEREGS {
+    uint8_t al, ah, bl, bh, cl, ch, dl, dh;
+};
+
+union REGS {
+    struct WORDREGS x;
+    struct WORDREGS w;
+    struct BYTEREGS h;
+};
+
+struct SREGS {
+    uint16_t es, cs, ss, ds;
+};
+
+int int86(int vector, union REGS *in, union REGS *out);
+int int86x(int vector, union REGS *in, union REGS *out, struct SREGS *sregs);
+void segread(struct SREGS *sregs);
+
+#define MK_FP(seg, off) ((void *)(host_memory + HOST_LINEAR(seg, off)))
+#define FP_SEG(ptr)     host_fp_seg(ptr)
+#define FP_OFF(ptr)     host_fp_off(ptr)
+
+/* Nothing interrupts the host build asynchronously */
+#define _disable()      ((void)0)
+#define _enable()       ((void)0)
+
+#endif /* HOST_I86_H */
@@ -0,0 +1,25 @@
+/*
+ * io.h - Host stand-in for Open Watcom's <io.h>
+ *
+ * DOS file calls mapped onto POSIX. _open() matches filenames
+ * case-insensitively, as DOS does.
+ */
+
+#ifndef HOST_IO_H
+#define HOST_IO_H
+
+#include <fcntl.h>
+#include <unistd.h>
+#include "host_platform.h"
+
+#ifndef O_BINARY
+#define O_BINARY    0
+#endif
+
+#define _open       host_open
+#define _read       read
+#define _write      write
+#define _close      close
+#define _lseek      lseek
+
+#endif /* HOST_IO_H */
@@ -0,0 +1,292 @@
+/*
+ * platform.c - Platform shim for the host-native (Linux) build
+ *
+ * Implements the stand-in DOS headers in host/include. Only the services the
+ * game actually uses are emulated; anything else is accepted and ignored so
+ * that the simulation keeps running. See host_platform.h for an overview.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+#include <strings.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <dirent.h>
+#include <sys/stat.h>
+#include "host_platform.h"
+#include "dos.h"
+#include "conio.h"
+#include "host_ega.h"
+
+/* Video mode 0x0D: 320x200 16-color EGA */
+#define HOST_VIDEO_MODE_EGA     0x0d
+
+/* Key returned by INT 16h AH=00h: Enter (scancode 0x1C, ASCII 0x0D) */
+#define HOST_BIOS_KEY           0x1c0d
+
+uint8_t host_memory[HOST_MEMORY_SIZE];
+host_isr_t host_vectors[256];
+uint8_t host_ports[65536];
+uint32_t host_bios_ticks = 0;
+jmp_buf *host_exit_jump = NULL;
+int host_exit_code = 0;
+
+static uint8_t host_video_mode = 0x03;
+
+void host_raise_interrupt(uint8_t vector)
+{
+    if (host_vectors[vector] != NULL) {
+        host_vectors[vector]();
+    }
+}
+
+void host_timer_interrupt(void)
+{
+    host_bios_ticks++;
+    host_raise_interrupt(0x08);
+}
+
+void host_keyboard_scancode(uint8_t scancode)
+{
+    host_ports[0x60] = scancode;
+    host_raise_interrupt(0x09);
+}
+
+uint16_t host_fp_seg(const void *ptr)
+{
+    const uint8_t *p = (const uint8_t *)ptr;
+
+    if (p < host_memory || p >= host_memory + HOST_MEMORY_SIZE) {
+        return 0;
+    }
+    return (uint16_t)((uint32_t)(p - host_memory) >> 4);
+}
+
+uint16_t host_fp_off(const void *ptr)
+{
+    const uint8_t *p = (const uint8_t *)ptr;
+
+    if (p < host_memory || p >= host_memory + HOST_MEMORY_SIZE) {
+        return (uint16_t)(uintptr_t)ptr;
+    }
+    return (uint16_t)((uint32_t)(p - host_memory) & 0x0f);
+}
+
+/*
+ * host_exit - Leave the program the way INT 21h AH=4Ch would
+ */
+static void host_exit(int code)
+{
+    host_exit_code = code;
+    if (host_exit_jump != NULL) {
+        longjmp(*host_exit_jump, 1);
+    }
+    exit(code);
+}
+
+/*
+ * video_bios - INT 10h: mode set/query, palette and the EGA information call
+ */
+static void video_bios(union REGS *out)
+{
+    switch (out->h.ah) {
+    case 0x00:  /* Set video mode */
+        host_video_mode = out->h.al & 0x7f;
+        /* Entering mode 0Dh starts the card over with cleared planes. The
+         * text mode set on exit leaves them, so the last frame can still be
+         * inspected after the game ends. */
+        if (host_video_mode == HOST_VIDEO_MODE_EGA) {
+            host_ega_reset();
+        }
+        break;
+    case 0x0f:  /* Get video mode */
+        out->h.al = host_video_mode;
+        out->h.ah = 40;
+        out->h.bh = 0;
+        break;
+    case 0x10:  /* Set one palette register */
+        if (out->h.al == 0x00) {
+            host_ega_set_palette(out->h.bl, out->h.bh);
+        }
+        break;
+    case 0x12:  /* EGA information: 256 KB, color */
+        if (out->h.bl == 0x10) {
+            out->h.bh = 0;
+            out->h.bl = 3;
+        }
+        break;
+    default:    /* Teletype output, ... */
+        break;
+    }
+}
+
+/*
+ * dos_services - INT 21h
+ *
+ * Programs exit through here. The handle-based file calls receive near
+ * (16-bit) buffer offsets, which cannot be mapped back to host pointers;
+ * they fail with the carry flag set, and the game falls back to defaults.
+ * Code that needs files uses _open() and friends instead.
+ */
+static void dos_services(union REGS *out, struct SREGS *sregs)
+{
+    switch (out->h.ah) {
+    case 0x4c:  /* Terminate */
+        host_exit(out->h.al);
+        break;
+    case 0x35:  /* Get interrupt vector: nothing lives in host_memory */
+        if (sregs != NULL) {
+            sregs->es = 0;
+        }
+        out->x.bx = 0;
+        break;
+    case 0x3c:  /* Create file */
+    case 0x3d:  /* Open file */
+    case 0x3f:  /* Read file */
+    case 0x40:  /* Write file */
+        out->x.ax = 5;  /* Access denied */
+        out->x.cflag = 1;
+        break;
+    default:    /* Print string, close file, ... */
+        break;
+    }
+}
+
+int int86x(int vector, union REGS *in, union REGS *out, struct SREGS *sregs)
+{
+    if (out != in) {
+        *out = *in;
+    }
+    out->x.cflag = 0;
+
+    switch (vector) {
+    case 0x10:
+        video_bios(out);
+        break;
+    case 0x16:  /* Keyboard BIOS: every wait for a key sees Enter */
+        if (out->h.ah == 0x00) {
+            out->x.ax = HOST_BIOS_KEY;
+        }
+        break;
+    case 0x1a:  /* Read system timer */
+        if (out->h.ah == 0x00) {
+            out->x.cx = (uint16_t)(host_bios_ticks >> 16);
+            out->x.dx = (uint16_t)host_bios_ticks;
+            out->h.al = 0;
+        }
+        break;
+    case 0x21:
+        dos_services(out, sregs);
+        break;
+    case 0x28:  /* DOS idle: the game is waiting, so let time pass */
+        host_timer_interrupt();
+        break;
+    default:
+        break;
+    }
+    return out->x.ax;
+}
+
+int int86(int vector, union REGS *in, union REGS *out)
+{
+    return int86x(vector, in, out, NULL);
+}
+
+void segread(struct SREGS *sregs)
+{
+    memset(sregs, 0, sizeof(*sregs));
+}
+
+host_isr_t _dos_getvect(unsigned vector)
+{
+    return host_vectors[vector & 0xff];
+}
+
+void _dos_setvect(unsigned vector, host_isr_t handler)
+{
+    host_vectors[vector & 0xff] = handler;
+}
+
+void _chain_intr(host_isr_t handler)
+{
+    handler();
+}
+
+unsigned inp(unsigned port)
+{
+    uint8_t value;
+
+    if (host_ega_port_in((uint16_t)port, &value)) {
+        return value;
+    }
+    return host_ports[port & 0xffff];
+}
+
+unsigned outp(unsigned port, unsigned value)
+{
+    host_ports[port & 0xffff] = (uint8_t)value;
+    host_ega_port_out((uint16_t)port, (uint8_t)value);
+    return value;
+}
+
+/*
+ * host_open - open() with DOS filename semantics
+ *
+ * DOS filenames are case-insensitive; the game asks for "LAKE.TT2" while
+ * the file on disk may be "lake.tt2". When the exact name does not exist,
+ * the containing directory is searched for a case-insensitive match.
+ */
+int host_open(const char *path, int flags, ...)
+{
+    va_list args;
+    int mode = 0;
+    int fd;
+    const char *slash;
+    char dir_name[256];
+    const char *base_name;
+    char match[512];
+    DIR *dir;
+    struct dirent *entry;
+
+    if (flags & O_CREAT) {
+        va_start(args, flags);
+        mode = va_arg(args, int);
+        va_end(args);
+    }
+
+    fd = open(path, flags, mode);
+    if (fd != -1 || errno != ENOENT) {
+        return fd;
+    }
+
+    slash = strrchr(path, '/');
+    if (slash != NULL) {
+        if ((size_t)(slash - path) >= sizeof(dir_name)) {
+            return -1;
+        }
+        memcpy(dir_name, path, (size_t)(slash - path));
+        dir_name[slash - path] = '\0';
+        base_name = slash + 1;
+    } else {
+        strcpy(dir_name, ".");
+        base_name = path;
+    }
+
+    dir = opendir(dir_name);
+    if (dir == NULL) {
+        return -1;
+    }
+    fd = -1;
+    while ((entry = readdir(dir)) != NULL) {
+        if (strcasecmp(entry->d_name, base_name) == 0) {
+            snprintf(match, sizeof(match), "%s/%s", dir_name, entry->d_name);
+            fd = open(match, flags, mode);
+            break;
+        }
+    }
+    closedir(dir);
+    return fd;
+}
@@ -73,14 +73,8 @@ typedef struct {
     uint8_t num_animation_frames; /* Always 2 for fireballs */
 } fireball_t;
 
-/* ===== Global Actor Arrays ===== */
-/*
- * These arrays store the state of all enemies and fireballs.
- * Declared in game_main.c as static arrays.
- */
-extern enemy_t enemies[MAX_NUM_ENEMIES];
-extern fireball_t fireballs[MAX_NUM_FIREBALLS];
-extern uint8_t enemy_shp_index[MAX_NUM_ENEMIES];
+/* The enemy and fireball arrays are in game_state_t (GAME->enemies,
+ * GAME->fireballs) */
 
 /* ===== Actor System Functions ===== */
 
@@ -148,6 +142,14 @@ void handle_item(void);
  */
 void handle_enemies(void);
 
+/*
+ * render_actors - Draw the live enemies and fireballs where they are
+ * 
+ * Draws what handle_enemies() and handle_fireballs() would, without moving
+ * or animating anything. Used to show a game state restored by rewinding.
+ */
+void render_actors(void);
+
 /*
  * maybe_spawn_enemy - Attempt to spawn one enemy
  * 
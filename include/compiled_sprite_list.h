@@ -0,0 +1,63 @@
+/*
+ * compiled_sprite_list.h - Sprites turned into compiled blit routines
+ * 
+ * X-macro list shared by the build-time generator (utils/compile_sprites.c)
+ * and the runtime dispatch table (src/compiled_sprites.c). Define
+ * COMPILED_SPRITE(id, group, data, rows) before including this file.
+ * 
+ *   id    - Suffix for the COMPILED_SPRITE_<id> enumerator
+ *   group - Generated source file the routine is emitted into
+ *           (build/gen/cspr_<group>.c); groups keep each generated
+ *           code segment well under 64KB
+ *   data  - Embedded masked sprite from sprite_data.c (16 pixels wide)
+ *   rows  - Sprite height in pixel rows (8, 16 or 32)
+ * 
+ * Only sprites drawn every tick are listed: Comic's 10 animation frames,
+ * the item pickups, sparks and fireballs.
+ * 
+ * No include guard: this file is meant to be included more than once.
+ */
+
+/* Comic (16x32) */
+COMPILED_SPRITE(COMIC_STANDING_LEFT,   comic, sprite_R4_comic_standing_left_16x32m,   32)
+COMPILED_SPRITE(COMIC_STANDING_RIGHT,  comic, sprite_R4_comic_standing_right_16x32m,  32)
+COMPILED_SPRITE(COMIC_JUMPING_LEFT,    comic, sprite_R4_comic_jumping_left_16x32m,    32)
+COMPILED_SPRITE(COMIC_JUMPING_RIGHT,   comic, sprite_R4_comic_jumping_right_16x32m,   32)
+COMPILED_SPRITE(COMIC_RUNNING_1_LEFT,  comic, sprite_R4_comic_running_1_left_16x32m,  32)
+COMPILED_SPRITE(COMIC_RUNNING_1_RIGHT, comic, sprite_R4_comic_running_1_right_16x32m, 32)
+COMPILED_SPRITE(COMIC_RUNNING_2_LEFT,  comic, sprite_R4_comic_running_2_left_16x32m,  32)
+COMPILED_SPRITE(COMIC_RUNNING_2_RIGHT, comic, sprite_R4_comic_running_2_right_16x32m, 32)
+COMPILED_SPRITE(COMIC_RUNNING_3_LEFT,  comic, sprite_R4_comic_running_3_left_16x32m,  32)
+COMPILED_SPRITE(COMIC_RUNNING_3_RIGHT, comic, sprite_R4_comic_running_3_right_16x32m, 32)
+
+/* Item pickups (16x16) */
+COMPILED_SPRITE(BLASTOLA_COLA_EVEN,    items, sprite_blastola_cola_even_16x16m,       16)
+COMPILED_SPRITE(BLASTOLA_COLA_ODD,     items, sprite_blastola_cola_odd_16x16m,        16)
+COMPILED_SPRITE(CORKSCREW_EVEN,        items, sprite_corkscrew_even_16x16m,           16)
+COMPILED_SPRITE(CORKSCREW_ODD,         items, sprite_corkscrew_odd_16x16m,            16)
+COMPILED_SPRITE(DOOR_KEY_EVEN,         items, sprite_door_key_even_16x16m,            16)
+COMPILED_SPRITE(DOOR_KEY_ODD,          items, sprite_door_key_odd_16x16m,             16)
+COMPILED_SPRITE(BOOTS_EVEN,            items, sprite_boots_even_16x16m,               16)
+COMPILED_SPRITE(BOOTS_ODD,             items, sprite_boots_odd_16x16m,                16)
+COMPILED_SPRITE(LANTERN_EVEN,          items, sprite_lantern_even_16x16m,             16)
+COMPILED_SPRITE(LANTERN_ODD,           items, sprite_lantern_odd_16x16m,              16)
+COMPILED_SPRITE(TELEPORT_WAND_EVEN,    items, sprite_teleport_wand_even_16x16m,       16)
+COMPILED_SPRITE(TELEPORT_WAND_ODD,     items, sprite_teleport_wand_odd_16x16m,        16)
+COMPILED_SPRITE(GEMS_EVEN,             items, sprite_gems_even_16x16m,                16)
+COMPILED_SPRITE(GEMS_ODD,              items, sprite_gems_odd_16x16m,                 16)
+COMPILED_SPRITE(CROWN_EVEN,            items, sprite_crown_even_16x16m,               16)
+COMPILED_SPRITE(CROWN_ODD,             items, sprite_crown_odd_16x16m,                16)
+COMPILED_SPRITE(GOLD_EVEN,             items, sprite_gold_even_16x16m,                16)
+COMPILED_SPRITE(GOLD_ODD,              items, sprite_gold_odd_16x16m,                 16)
+COMPILED_SPRITE(SHIELD_EVEN,           items, sprite_shield_even_16x16m,              16)
+COMPILED_SPRITE(SHIELD_ODD,            items, sprite_shield_odd_16x16m,               16)
+
+/* Effects: sparks (16x16) and fireballs (16x8) */
+COMPILED_SPRITE(RED_SPARK_0,           effects, sprite_red_spark_0_16x16m,            16)
+COMPILED_SPRITE(RED_SPARK_1,           effects, sprite_red_spark_1_16x16m,            16)
+COMPILED_SPRITE(RED_SPARK_2,           effects, sprite_red_spark_2_16x16m,            16)
+COMPILED_SPRITE(WHITE_SPARK_0,         effects, sprite_white_spark_0_16x16m,          16)
+COMPILED_SPRITE(WHITE_SPARK_1,         effects, sprite_white_spark_1_16x16m,          16)
+COMPILED_SPRITE(WHITE_SPARK_2,         effects, sprite_white_spark_2_16x16m,          16)
+COMPILED_SPRITE(FIREBALL_0,            effects, sprite_fireball_0_16x8m,               8)
+COMPILED_SPRITE(FIREBALL_1,            effects, sprite_fireball_1_16x8m,               8)
@@ -0,0 +1,50 @@
+/*
+ * compiled_sprites.h - Compiled (straight-line code) masked sprite blitters
+ * 
+ * Each sprite listed in compiled_sprite_list.h is turned into dedicated
+ * routines (one per plane) at build time by utils/compile_sprites.c. Each
+ * routine writes constant offsets: fully transparent bytes are skipped,
+ * fully opaque bytes are stored without reading video memory, and only
+ * partially masked bytes do a read-modify-write.
+ */
+
+#ifndef COMPILED_SPRITES_H
+#define COMPILED_SPRITES_H
+
+#include <stdint.h>
+
+/* Sprite IDs, in compiled_sprite_list.h order */
+enum {
+#define COMPILED_SPRITE(id, group, data, rows) COMPILED_SPRITE_##id,
+#include "compiled_sprite_list.h"
+#undef COMPILED_SPRITE
+    NUM_COMPILED_SPRITES
+};
+
+/* "No sprite" marker for callers that select an ID conditionally */
+#define COMPILED_SPRITE_NONE 0xff
+
+/* Signature of a generated plane routine: draws one plane of the sprite
+ * with its top-left byte at dst, using the page's 40-byte row stride. The
+ * caller selects the plane for reading and writing first. */
+typedef void (*compiled_plane_fn)(uint8_t __far *dst);
+
+/* Generated routines (build/gen/cspr_<group>.c) */
+#define COMPILED_SPRITE(id, group, data, rows) \
+    void cspr_##data##_p0(uint8_t __far *dst); \
+    void cspr_##data##_p1(uint8_t __far *dst); \
+    void cspr_##data##_p2(uint8_t __far *dst); \
+    void cspr_##data##_p3(uint8_t __far *dst);
+#include "compiled_sprite_list.h"
+#undef COMPILED_SPRITE
+
+/* Blit a compiled sprite to the offscreen gameplay buffer at a pixel position */
+void blit_compiled_sprite(uint8_t sprite_id, uint16_t pixel_x, uint16_t pixel_y);
+
+/* Draw one plane of a compiled sprite at dst (plane already selected) */
+void draw_compiled_sprite_plane(uint8_t sprite_id, uint8_t plane, uint8_t __far *dst);
+
+/* Embedded sprite data behind a compiled sprite (NULL for an invalid ID) */
+const uint8_t __far *compiled_sprite_data(uint8_t sprite_id);
+
+#endif /* COMPILED_SPRITES_H */
@@ -0,0 +1,36 @@
+/*
+ * dirty_rects.h - Per-page dirty rectangle tracking for the playfield
+ *
+ * Records the screen regions that sprite blits touch in each gameplay page
+ * so the next playfield refresh of that page only restores those regions
+ * from the rendered map buffer instead of copying the whole 24x160 area.
+ */
+
+#ifndef DIRTY_RECTS_H
+#define DIRTY_RECTS_H
+
+#include <stdint.h>
+
+/* Maximum rectangles tracked per page before falling back to a full copy.
+ * Each page collects the sprites of one tick: Comic, 4 enemies, 5 fireballs,
+ * the item and sparks, with room to spare. */
+#define DIRTY_RECTS_MAX_PER_PAGE 32
+
+/* Record a rectangle at an absolute offset in segment 0xa000.
+ * Offsets outside the two gameplay pages are ignored. */
+void dirty_rects_mark_offset(uint16_t video_offset, uint8_t width_bytes, uint8_t rows);
+
+/* Record a rectangle at the same page-relative offset in both gameplay pages */
+void dirty_rects_mark_both_pages(uint16_t page_offset, uint8_t width_bytes, uint8_t rows);
+
+/* Forget all tracking; the next refresh of each page is a full copy */
+void dirty_rects_invalidate(void);
+
+/* Restore only the dirty regions of a page's playfield.
+ * Returns 1 if the page was refreshed, 0 if the caller must do a full copy. */
+uint8_t dirty_rects_restore_playfield(uint16_t page, uint16_t camera_x);
+
+/* Note that a page's playfield was fully refreshed at camera_x */
+void dirty_rects_playfield_refreshed(uint16_t page, uint16_t camera_x);
+
+#endif /* DIRTY_RECTS_H */
@@ -0,0 +1,209 @@
+/*
+ * game_state.h - Mutable state of one game
+ *
+ * Everything a game tick reads and changes -- Comic's physics, the camera,
+ * the loaded level and stage maps, enemies, fireballs, inventory, score,
+ * lives and the decoded input -- lives in one game_state_t, together with
+ * what feeds it: the level's tileset and enemy sprites, the scancode queue,
+ * tick flag and keymap, and the turbo, rewind and replay state. Game code
+ * reaches the current game through GAME, as in GAME->comic_x.
+ *
+ * On DOS there is a single game: GAME is the address of the static
+ * game_state, so GAME->comic_x compiles to the same direct memory access
+ * as the global it replaced. In the host build (make host) GAME is the
+ * pointer game_current, and game_select() switches it between games, so
+ * one process can step several independent games a tick at a time
+ * (comic-sim -i checks this).
+ *
+ * Shared by the whole process, because there is one screen and one
+ * machine: the EGA pages and everything drawn on them (the rendered map,
+ * the dirty rect, status panel and map caches, the sprite queue), the
+ * blit engine, sound, and the profiler, log and trace. None of it feeds
+ * back into a game tick, so games stepped in turn still evolve exactly as
+ * they would alone; only what is on screen is the last game drawn.
+ */
+
+#ifndef GAME_STATE_H
+#define GAME_STATE_H
+
+#include <stdint.h>
+#include "globals.h"
+#include "level_data.h"
+#include "file_loaders.h"
+#include "actors.h"
+#include "tile_query.h"
+#include "replay.h"
+#include "rewind.h"
+
+/* Keyboard scancode capture buffer (direct from INT 9) */
+#define MAX_SCANCODE_QUEUE 16
+
+typedef struct {
+    /* Loaded level data: filled by load_new_level() and load_new_stage()
+     * from the level number and stage number, so snapshots leave it out */
+    level_t current_level;
+    const level_t *current_level_ptr;   /* Level descriptor in level_data_pointers */
+    pt_file_t pt0;                      /* Stage maps: three .PT files per level */
+    pt_file_t pt1;
+    pt_file_t pt2;
+    uint8_t *current_tiles_ptr;         /* Current stage's tile map (one of the above) */
+    uint8_t tileset_last_passable;      /* From the .TT2 header */
+    uint8_t tileset_flags;
+    uint8_t solid_rows[MAP_HEIGHT_TILES][TILE_QUERY_ROW_BYTES];  /* Current stage, see tile_query.h */
+    uint16_t solid_columns[MAP_WIDTH_TILES];
+    uint8_t tileset_graphics[TILESET_MAX_TILES * 128];  /* .TT2 tiles, plane-major (see TILESET_ROW_OFFSET) */
+    shp_runtime_t loaded_shps[4];       /* Enemy sprites, see load_level_shp_files() */
+
+    /* Input: int9_handler() queues scancodes, int8_handler() sets
+     * game_tick_flag, update_keyboard_input() decodes them with keymap */
+    uint8_t scancode_queue[MAX_SCANCODE_QUEUE];
+    uint8_t scancode_queue_head;
+    uint8_t scancode_queue_tail;
+    uint8_t extended_prefix;
+    volatile uint8_t game_tick_flag;
+    uint8_t keymap[6];                  /* Jump, fire, left, right, open, teleport */
+
+    /* Turbo mode (/TURBO[:n] or F10): ticks run back to back instead of
+     * waiting for the timer, and only every turbo_draw_interval-th tick is
+     * drawn */
+    uint8_t turbo_mode;
+    uint8_t turbo_draw_interval;
+    uint8_t turbo_draw_counter;
+    uint8_t key_state_turbo;
+
+    /* Rewind (F9): each press steps back one tick, and the game holds the
+     * rewound tick on screen until a game key is pressed */
+    uint8_t rewind_key_pressed;
+    uint8_t rewind_hold;
+    rewind_context_t rewind;
+
+    /* F8 asks for the lag frame totals (see profile.h) in DEBUG.LOG; they
+     * are written at the next pause or stage load */
+    uint8_t lag_status_key_pressed;
+
+    replay_context_t replay;
+
+    /* Everything from here on is plain data, saved by snapshot_save() */
+
+    /* Level and stage */
+    uint8_t current_level_number;
+    uint8_t current_stage_number;
+    int8_t source_door_level_number;    /* Stage entry: -2=first spawn, -1=boundary, >=0=door from level */
+    int8_t source_door_stage_number;
+    uint8_t comic_y_checkpoint;         /* Respawn and boundary crossing position */
+    uint8_t comic_x_checkpoint;
+
+    /* Comic */
+    uint8_t comic_x;
+    uint8_t comic_y;
+    uint8_t comic_animation;
+    uint8_t comic_facing;
+    uint8_t comic_run_cycle;
+    uint8_t comic_is_falling_or_jumping;
+    uint8_t comic_is_teleporting;
+    int8_t comic_x_momentum;
+    int8_t comic_y_vel;
+    uint8_t comic_jump_counter;         /* Current jump countdown (0 when standing) */
+    uint8_t comic_jump_power;           /* Base jump power (4 default, 5 with Boots) */
+    uint8_t ceiling_stick_flag;         /* Whether Comic is jumping upward against a ceiling */
+    uint8_t comic_fall_delay;           /* Ticks to hover at jump apex */
+    uint8_t minimum_jump_frames;        /* Quick taps still get 2 frames of acceleration */
+    uint8_t comic_hp;
+    uint8_t comic_hp_pending_increase;  /* HP still to fill, one unit per tick */
+    uint8_t comic_num_lives;
+    uint16_t camera_x;
+
+    /* Per-tick flags */
+    uint8_t landed_this_tick;           /* Set by physics when hitting ground */
+    uint8_t stage_transitioned_this_tick;  /* Stage-edge transition occurred mid-tick */
+    uint8_t inhibit_death_by_enemy_collision;  /* Death animation is running */
+    uint8_t comic_death_animation_finished;    /* Skip the partial sprite in comic_dies */
+    uint8_t win_counter;                /* Countdown to the victory sequence */
+
+    /* Teleport */
+    uint8_t teleport_animation;
+    uint8_t teleport_source_x;
+    uint8_t teleport_source_y;
+    uint8_t teleport_destination_x;
+    uint8_t teleport_destination_y;
+    uint8_t teleport_camera_counter;
+    int8_t teleport_camera_vel;
+
+    /* Input decoded from scancodes by update_keyboard_input() */
+    uint8_t key_state_esc;
+    uint8_t key_state_jump;
+    uint8_t key_state_fire;
+    uint8_t key_state_left;
+    uint8_t key_state_right;
+    uint8_t key_state_open;
+    uint8_t key_state_teleport;
+    uint8_t key_state_cheat_wand;       /* W */
+    uint8_t key_state_cheat_key;        /* K */
+    uint8_t key_state_cheat_cola;       /* B */
+    uint8_t key_state_cheat_corkscrew;  /* C */
+    uint8_t key_state_cheat_boots;      /* O */
+    uint8_t key_state_cheat_lantern;    /* L */
+    uint8_t key_state_cheat_shield;     /* S */
+    uint8_t key_state_cheat_level;      /* P */
+    uint8_t key_state_cheat_stage;      /* Q */
+
+    /* Previous tick's input, for edge-triggered keys */
+    uint8_t previous_key_state_jump;
+    uint8_t previous_key_state_teleport;
+    uint8_t previous_key_state_cheat_wand;
+    uint8_t previous_key_state_cheat_key;
+    uint8_t previous_key_state_cheat_cola;
+    uint8_t previous_key_state_cheat_corkscrew;
+    uint8_t previous_key_state_cheat_boots;
+    uint8_t previous_key_state_cheat_lantern;
+    uint8_t previous_key_state_cheat_shield;
+    uint8_t previous_key_state_cheat_level;
+    uint8_t previous_key_state_cheat_stage;
+    uint8_t teleport_key_pressed;       /* Teleport key edge seen this tick */
+
+    /* Fireballs and items */
+    uint8_t fireball_meter;
+    uint8_t fireball_meter_counter;
+    uint8_t comic_firepower;            /* Number of active fireball slots (0-5) */
+    uint8_t comic_has_door_key;
+    uint8_t comic_has_teleport_wand;
+    uint8_t comic_has_corkscrew;
+    uint8_t comic_has_lantern;          /* Only affects darkness in the Castle */
+    uint8_t comic_num_treasures;        /* Crown, Gold and Gems collected (0-3) */
+    uint8_t comic_has_gems;
+    uint8_t comic_has_crown;
+    uint8_t comic_has_gold;
+    uint8_t items_collected[8][16];     /* Per level and stage */
+    uint8_t item_animation_counter;     /* 0 or 1, toggles for item animation */
+
+    /* Score: 3 base-100 digit pairs, see globals.h */
+    uint8_t score_bytes[3];
+    uint8_t score_10000_counter;        /* Carries into score_bytes[2], for extra lives */
+
+    /* Actors */
+    enemy_t enemies[MAX_NUM_ENEMIES];
+    fireball_t fireballs[MAX_NUM_FIREBALLS];
+    uint8_t enemy_shp_index[MAX_NUM_ENEMIES];
+    uint8_t enemy_respawn_counter_cycle;  /* Cycles: 20, 40, 60, 80, 100 */
+    uint8_t spawned_this_tick;          /* At most one enemy spawns per tick */
+    uint8_t spawn_offset_cycle;         /* Cycles: 24, 26, 28, 30 */
+} game_state_t;
+
+/* The DOS game's state; also the host build's default */
+extern game_state_t game_state;
+
+#ifdef HOST_BUILD
+/* The game being run; starts at game_state */
+extern game_state_t *game_current;
+#define GAME game_current
+
+/* Make state the game being run */
+void game_select(game_state_t *state);
+#else
+#define GAME (&game_state)
+#endif
+
+/* Put a game in its power-on state (before the first begin_game) */
+void game_state_init(game_state_t *state);
+
+#endif /* GAME_STATE_H */
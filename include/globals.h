@@ -39,6 +39,15 @@ void debug_log_close(void);
 #define SCREEN_HEIGHT           200     /* in pixels - EGA mode 0x0D: 320x200 */
 #define RENDERED_MAP_BUFFER     0x4000  /* offset in video segment 0xa000 */
 
+/* Tileset layout. A .TT2 file stores each 16x16 tile as 4 planes of 16 rows
+ * (128 bytes per tile). load_new_level() transposes tileset_graphics to
+ * plane-major order: all tiles' plane 0 rows, then plane 1, and so on, so
+ * the map renderer walks one plane as a table of 16-bit pixel rows. */
+#define TILESET_MAX_TILES       128
+#define TILESET_PLANE_SIZE      (TILESET_MAX_TILES * 32)  /* bytes per plane */
+#define TILESET_ROW_OFFSET(tile_id, plane, row) \
+    ((uint16_t)(plane) * TILESET_PLANE_SIZE + (uint16_t)(tile_id) * 32 + (uint16_t)(row) * 2)
+
 /* ===== Level Numbers ===== */
 #define LEVEL_NUMBER_LAKE       0
 #define LEVEL_NUMBER_FOREST     1
@@ -95,7 +104,7 @@ void debug_log_close(void);
  * 
  * Formula: score = byte[0] + (byte[1] * 100) + (byte[2] * 10000)
  */
-#define score_get_value() ((uint32_t)score_bytes[0] + ((uint32_t)score_bytes[1] * 100UL) + ((uint32_t)score_bytes[2] * 10000UL))
+#define score_get_value() ((uint32_t)GAME->score_bytes[0] + ((uint32_t)GAME->score_bytes[1] * 100UL) + ((uint32_t)GAME->score_bytes[2] * 10000UL))
 
 /* score_set_value - Store a 32-bit value into three base-100 bytes
  * 
@@ -109,11 +118,13 @@ void debug_log_close(void);
  */
 #define score_set_value(v) do { \
     uint32_t _val = (v); \
-    score_bytes[0] = _val % 100; \
-    score_bytes[1] = (_val / 100UL) % 100; \
-    score_bytes[2] = (_val / 10000UL) % 100; \
+    GAME->score_bytes[0] = _val % 100; \
+    GAME->score_bytes[1] = (_val / 100UL) % 100; \
+    GAME->score_bytes[2] = (_val / 10000UL) % 100; \
 } while(0)
 
+/* The score macros use GAME->score_bytes and need game_state.h */
+
 /* ===== Player State (will be needed when porting game logic to C) ===== */
 /* Note: Currently these are in assembly if used there */
 /* extern uint8_t comic_x; */
@@ -133,12 +144,7 @@ void debug_log_close(void);
 /* extern uint8_t key_state_jump; */
 
 /* ===== Graphics and Map Data ===== */
-/* extern uint8_t tileset_graphics[]; */
 /* extern uint8_t *current_tiles_ptr; */
 
-/* Set when a stage-edge transition occurs so game_loop can restart immediately
- * like the original assembly tail-jump flow. */
-extern uint8_t stage_transitioned_this_tick;
-
 #endif /* GLOBALS_H */
 
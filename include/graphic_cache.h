@@ -0,0 +1,36 @@
+/*
+ * graphic_cache.h - Cache of decoded fullscreen .EGA graphics
+ *
+ * Keeps the four decoded planes of recently shown fullscreen graphics
+ * (SYS000.EGA-SYS005.EGA) so that showing one again is a plane copy into
+ * video memory instead of a file read and RLE decode. Backed by EMS when an
+ * expanded memory manager is present, otherwise by a small pool of
+ * conventional memory.
+ */
+
+#ifndef GRAPHIC_CACHE_H
+#define GRAPHIC_CACHE_H
+
+#include <stdint.h>
+
+/* One decoded fullscreen graphic: 4 planes of 8000 bytes */
+#define GRAPHIC_CACHE_PLANE_SIZE    8000
+#define GRAPHIC_CACHE_ENTRY_SIZE    (4 * GRAPHIC_CACHE_PLANE_SIZE)
+
+/* Graphics kept in EMS (two 16 KB EMS pages each); covers all six SYS files */
+#define GRAPHIC_CACHE_EMS_ENTRIES           6
+
+/* Graphics kept in conventional memory when EMS is not available */
+#define GRAPHIC_CACHE_CONVENTIONAL_ENTRIES  2
+
+/* Copy a cached graphic into video memory at dst_offset.
+ * Returns 1 if the graphic was cached and drawn, 0 otherwise. */
+uint8_t graphic_cache_restore(const char *filename, uint16_t dst_offset);
+
+/* Save the graphic just decoded at src_offset in video memory */
+void graphic_cache_store(const char *filename, uint16_t src_offset);
+
+/* Release EMS pages and conventional buffers; call before exiting to DOS */
+void graphic_cache_shutdown(void);
+
+#endif /* GRAPHIC_CACHE_H */
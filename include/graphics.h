@@ -29,6 +29,14 @@
 #define EGA_PLANE_RED        2
 #define EGA_PLANE_INTENSITY  3
 
+/* EGA Graphics Controller write modes (GC Register 5, bits 0-1) */
+#define EGA_WRITE_MODE_0     0  /* CPU data written through Map Mask */
+#define EGA_WRITE_MODE_1     1  /* Latch contents written (video-to-video copy) */
+
+/* Masked sprite blit engines (set_masked_blit_engine) */
+#define MASKED_BLIT_ENGINE_CPU      0  /* CPU read-modify-write per plane */
+#define MASKED_BLIT_ENGINE_BITMASK  1  /* GC Bit Mask register merges with the latches */
+
 /* Graphics file loaders */
 int load_fullscreen_graphic(const char *filename, uint16_t dst_offset);
 
@@ -36,6 +44,8 @@ int load_fullscreen_graphic(const char *filename, uint16_t dst_offset);
 void enable_ega_plane_write(uint8_t plane);
 void enable_ega_plane_read(uint8_t plane);
 void enable_ega_plane_read_write(uint8_t plane);
+void enable_ega_plane_write_all(void);
+void set_ega_write_mode(uint8_t mode);
 
 /* RLE decoding */
 uint16_t rle_decode(uint8_t *src_ptr, uint16_t src_size, uint16_t dst_offset, uint16_t plane_size);
@@ -47,6 +57,11 @@ void copy_ega_plane(uint16_t src_offset, uint16_t dst_offset, uint16_t num_bytes
 /* Copy a small number of bytes within a single EGA plane (helper for rendering)
  * Offsets are relative to segment 0xa000. */
 void copy_plane_bytes(uint16_t src_offset, uint16_t dst_offset, uint16_t num_bytes);
+/* Copy a rectangle of all four planes at once using write mode 1 latches.
+ * Offsets are relative to segment 0xa000. */
+void copy_ega_latched(uint16_t src_offset, uint16_t src_stride,
+                      uint16_t dst_offset, uint16_t dst_stride,
+                      uint16_t width_bytes, uint16_t rows);
 
 /* Palette manipulation for title sequence fade effects */
 void init_ega_graphics(void);
@@ -55,6 +70,7 @@ void palette_fade_in(void);
 void init_default_palette(void);
 
 /* Sprite blitting operations */
+/* Gameplay sprites are drawn into the offscreen buffer only */
 void blit_sprite_16x16_masked(uint16_t pixel_x, uint16_t pixel_y, const uint8_t *sprite_data);
 void blit_sprite_16x16_unmasked(uint16_t pixel_x, uint16_t pixel_y, const uint8_t *sprite_data);
 void blit_sprite_16x32_masked(uint16_t pixel_x, uint16_t pixel_y, const uint8_t *sprite_data);
@@ -63,12 +79,24 @@ void blit_sprite_16x32_masked_rows(uint16_t pixel_x, uint16_t pixel_y, const uin
 void blit_sprite_16x8_masked(uint16_t pixel_x, uint16_t pixel_y, const uint8_t *sprite_data);
 void blit_wxh(uint16_t dest_offset, const uint8_t __far *graphic, uint16_t width_bytes, uint16_t height);
 void blit_8x16_sprite(uint16_t pixel_x, uint16_t pixel_y, const uint8_t __far *sprite_data);
+/* Life icons are drawn into both buffers so they persist across page flips;
+ * the rest of the status panel is change-tracked per page (see ui.h) */
+void blit_sprite_16x16_masked_both_pages(uint16_t pixel_x, uint16_t pixel_y, const uint8_t *sprite_data);
+/* Draw or queue a compiled sprite (see compiled_sprites.h) at a page-relative offset */
+void submit_compiled_sprite(uint8_t sprite_id, uint16_t base_offset, uint8_t rows);
 
-/* Inventory item rendering */
-void render_inventory_display(void);
+/* Per-frame sprite batching: while a batch is open, sprite blits are queued
+ * and drawn plane by plane on flush, programming the plane registers once
+ * per plane per frame. swap_video_buffers() ends the batch. */
+void sprite_queue_begin(void);
+void sprite_queue_flush(void);
+void sprite_queue_end(void);
+/* Drop the batch's offscreen-only sprites: the frame will not be shown */
+void sprite_queue_skip_frame(void);
 
-/* Score display rendering */
-void render_score_display(void);
+/* Select how masked 16-pixel sprites are combined with the background */
+void set_masked_blit_engine(uint8_t engine);
+uint8_t get_masked_blit_engine(void);
 
 /* Load 16-byte palette array (values 0-63) into EGA palette registers 0..15 */
 void load_ega_palette_from_file(const uint8_t *palette16);
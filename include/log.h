@@ -0,0 +1,71 @@
+/*
+ * log.h - Buffered diagnostics log, flushed to DEBUG.LOG between ticks
+ * 
+ * LOG_ERROR(), LOG_WARN(), LOG_INFO() and LOG_DEBUG() append a binary
+ * record -- the timer interrupt count, a message ID from log_messages.h
+ * and three 16-bit arguments -- to an in-memory ring. Nothing is formatted
+ * or written to disk while a tick runs: log_flush() formats the records
+ * through their messages' printf formats and appends them to DEBUG.LOG,
+ * and the game calls it only where it stalls anyway: stage loads, the
+ * pause screen and terminate_program(). If the ring fills up between
+ * flushes, the oldest records are overwritten and the flush says how many.
+ * 
+ * The level filter is at compile time: calls above LOG_LEVEL (make
+ * LOG_LEVEL=n, default LOG_LEVEL_INFO) expand to nothing, arguments and
+ * all. debug_log() is still there for reports written at exit.
+ */
+
+#ifndef LOG_H
+#define LOG_H
+
+#include <stdint.h>
+
+#define LOG_LEVEL_OFF       0
+#define LOG_LEVEL_ERROR     1
+#define LOG_LEVEL_WARN      2
+#define LOG_LEVEL_INFO      3
+#define LOG_LEVEL_DEBUG     4
+
+#ifndef LOG_LEVEL
+#define LOG_LEVEL           LOG_LEVEL_INFO
+#endif
+
+/* Message IDs, in log_messages.h order */
+enum {
+#define LOG_MESSAGE(id, format) LOG_MSG_##id,
+#include "log_messages.h"
+#undef LOG_MESSAGE
+    LOG_NUM_MESSAGES
+};
+
+/* Record a message; pass 0 for arguments the format does not use */
+void log_event(uint8_t message, uint16_t a, uint16_t b, uint16_t c);
+
+/* Format the records since the last flush into DEBUG.LOG and empty the ring */
+void log_flush(void);
+
+#if LOG_LEVEL >= LOG_LEVEL_ERROR
+#define LOG_ERROR(message, a, b, c) log_event(LOG_MSG_##message, (uint16_t)(a), (uint16_t)(b), (uint16_t)(c))
+#else
+#define LOG_ERROR(message, a, b, c) ((void)0)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_WARN
+#define LOG_WARN(message, a, b, c)  log_event(LOG_MSG_##message, (uint16_t)(a), (uint16_t)(b), (uint16_t)(c))
+#else
+#define LOG_WARN(message, a, b, c)  ((void)0)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_INFO
+#define LOG_INFO(message, a, b, c)  log_event(LOG_MSG_##message, (uint16_t)(a), (uint16_t)(b), (uint16_t)(c))
+#else
+#define LOG_INFO(message, a, b, c)  ((void)0)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_DEBUG
+#define LOG_DEBUG(message, a, b, c) log_event(LOG_MSG_##message, (uint16_t)(a), (uint16_t)(b), (uint16_t)(c))
+#else
+#define LOG_DEBUG(message, a, b, c) ((void)0)
+#endif
+
+#endif /* LOG_H */
@@ -0,0 +1,17 @@
+/*
+ * log_messages.h - Messages the ring logger can record
+ * 
+ * X-macro list shared by log.h (the LOG_MSG_<id> enumerators) and log.c
+ * (the format table). Define LOG_MESSAGE(id, format) before including
+ * this file.
+ * 
+ *   id     - Suffix for the LOG_MSG_<id> enumerator
+ *   format - printf format for the record's three 16-bit arguments, used
+ *            only when the ring is flushed; print them with %u or %x
+ * 
+ * log.h and log.c each expand this list, so it has no include guard.
+ */
+
+LOG_MESSAGE(LEAP_FELL_OFF_BOTTOM,   "LEAP moving_down: fell off bottom -> despawn (y=%u)")
+LOG_MESSAGE(STAGE_LOAD,             "Stage load: level %u stage %u")
+LOG_MESSAGE(LAG_FRAMES,             "Lag: %u frames after a tick in level %u stage %u")
@@ -20,8 +20,7 @@
 
 /* Game dimensions are defined in globals.h to avoid duplication */
 
-/* Tile access functions */
-uint16_t address_of_tile_at_coordinates(uint8_t x, uint8_t y);
+/* Tile and solidity probes are in tile_query.h */
 
 /* Movement functions */
 void handle_fall_or_jump(void);
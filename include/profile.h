@@ -0,0 +1,117 @@
+/*
+ * profile.h - Per-phase timing of game ticks
+ *
+ * With /PROFILE, run_game_tick() marks the end of each phase of the tick
+ * (waiting for the timer, input, physics, the map and Comic blits, the
+ * actors, the UI and the page swap) with PROFILE_MARK(). A mark reads the
+ * time and charges everything since the previous mark to its phase. Time
+ * outside the marked phases -- stage loads, doors, pausing, death -- is
+ * charged to PROFILE_OTHER when the next tick starts.
+ *
+ * The clock is PIT channel 0 (1193182 Hz, 0.838 us per count), latched
+ * through port 0x43 and read from port 0x40. profile_start() switches the
+ * channel from mode 3 to mode 2 at the same 18.2 Hz rate, so the count
+ * runs down by one per clock through the whole 65536; int8_handler()
+ * counts the wraps in profile_irq0_count. The host build reads the host's
+ * monotonic clock in the same units.
+ *
+ * Sampling is per tick: a phase's time in a tick is the sum of its marks
+ * in that tick, and the min/avg/max is over the ticks that marked it.
+ * profile_report() prints the table; terminate_program() writes it to
+ * DEBUG.LOG. With /PROFILE:BARS each tick's phases are also drawn as a
+ * stacked bar in the bottom rows of the right-hand UI panel.
+ *
+ * Lag frames are counted with or without /PROFILE. A game tick is due
+ * every second timer interrupt; run_game_tick() raises profile_tick_active
+ * once its wait is over, and int8_handler() counts each game tick that
+ * comes due while it is still raised in profile_lag_pending. Such a tick
+ * starts late: a lag frame. The next PROFILE_MARK() charges the pending
+ * lag to its phase. Deliberate waits (wait_n_ticks(): doors, death,
+ * pausing) and replays and turbo mode, which are not paced by the timer,
+ * are not counted. profile_lag_report() totals them per level and stage
+ * and per phase, with the worst bursts; terminate_program() writes it to
+ * DEBUG.LOG, and so does the next pause or stage load after F8.
+ */
+
+#ifndef PROFILE_H
+#define PROFILE_H
+
+#include <stdint.h>
+#include "trace.h"
+
+/* Phases, in the order run_game_tick() marks them */
+#define PROFILE_WAIT        0   /* Busy-wait for the next timer tick */
+#define PROFILE_REWIND      1   /* Recording the tick for rewind, or stepping back */
+#define PROFILE_INPUT       2   /* Keyboard or replay input, cheats, jump start */
+#define PROFILE_PHYSICS     3   /* Teleport, falling and jumping, walking, firing */
+#define PROFILE_MAP         4   /* Map blit into the offscreen page */
+#define PROFILE_COMIC       5
+#define PROFILE_ENEMIES     6
+#define PROFILE_FIREBALLS   7
+#define PROFILE_ITEMS       8
+#define PROFILE_UI          9   /* Status panel changes (see ui.h), queued for the swap */
+#define PROFILE_SWAP        10  /* Queued sprites drawn plane by plane, page flip */
+#define PROFILE_OTHER       11  /* Anything between the marks */
+#define PROFILE_NUM_PHASES  12
+
+#define PROFILE_BARS_OFF    0
+#define PROFILE_BARS_ON     1
+
+/* Nonzero once profile_start() has run */
+extern uint8_t profile_enabled;
+
+/* Timer interrupts since profile_start(), counted by int8_handler() */
+extern volatile uint16_t profile_irq0_count;
+
+/* Set while a timer-paced tick runs, by profile_tick_started() */
+extern volatile uint8_t profile_tick_active;
+
+/* Game ticks that came due during a running tick, not yet charged */
+extern volatile uint8_t profile_lag_pending;
+
+/* Charge the time since the previous mark, and any lag frames, to a phase;
+ * with /TRACE, also record the phase's end (see trace.h) */
+#define PROFILE_MARK(phase) \
+    do { \
+        if (profile_lag_pending) profile_charge_lag(phase); \
+        if (profile_enabled) profile_mark(phase); \
+        TRACE_INSTANT(PHASE, phase); \
+    } while (0)
+
+/* Switch PIT channel 0 to mode 2 for profile_read_timer() (also used by /TRACE) */
+void profile_clock_start(void);
+
+/* Current time in PIT counts (leaves interrupts enabled) */
+uint32_t profile_read_timer(void);
+
+/* The same with interrupts already disabled; leaves them disabled */
+uint32_t profile_read_timer_locked(void);
+
+/* Start timing; bars = PROFILE_BARS_ON to draw the live overlay */
+void profile_start(uint8_t bars);
+
+/* Put PIT channel 0 back in mode 3 (call before restoring INT 8) */
+void profile_stop(void);
+
+void profile_mark(uint8_t phase);
+
+void profile_charge_lag(uint8_t phase);
+
+/* A timer-paced tick's work begins in a level and stage (after its wait):
+ * count lag until the next profile_tick() or wait_n_ticks() */
+void profile_tick_started(uint8_t level, uint8_t stage);
+
+/* End the previous tick's sample and start the next (top of run_game_tick) */
+void profile_tick(void);
+
+/* Drop the time since the last mark and any pending lag (between games,
+ * so the title sequence and menus are not charged to the first tick) */
+void profile_resync(void);
+
+/* Print the per-phase table through print (debug_log or printf) */
+void profile_report(void (*print)(const char *format, ...));
+
+/* Print the lag frame totals through print (nothing before the first tick) */
+void profile_lag_report(void (*print)(const char *format, ...));
+
+#endif /* PROFILE_H */
@@ -0,0 +1,83 @@
+/*
+ * replay.h - Input recording and replay (.RPL files)
+ *
+ * A recording holds the state the game started from and, for every game
+ * tick, the scancodes update_keyboard_input() took from the scancode queue
+ * on that tick. Gameplay is a pure function of that input, so feeding the
+ * same scancodes back on the same ticks reproduces the session exactly.
+ * Playback does not wait for the timer tick, so a long session replays in
+ * a fraction of its real-time length.
+ *
+ * File layout (all single bytes):
+ *   0   "CRPL"
+ *   4   REPLAY_VERSION
+ *   5   level number
+ *   6   stage number
+ *   7   enemy_respawn_counter_cycle
+ *   8   item_animation_counter
+ *   9   keymap (6 scancodes: jump, fire, left, right, open, teleport)
+ *   15  tick stream:
+ *         0x01-0x0f  a tick that consumed that many scancodes, which follow
+ *         0x80-0xff  (byte - 0x7f) consecutive ticks without scancodes
+ *         0x00       end of recording
+ */
+
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include <stdint.h>
+
+#define REPLAY_OFF          0
+#define REPLAY_RECORD       1
+#define REPLAY_PLAYBACK     2
+
+#define REPLAY_VERSION      1
+
+/* Most scancodes one tick can consume (one less than the queue size) */
+#define REPLAY_MAX_TICK_SCANCODES   15
+
+/* Game state a recording starts from */
+typedef struct {
+    uint8_t level_number;
+    uint8_t stage_number;
+    uint8_t enemy_respawn_counter_cycle;
+    uint8_t item_animation_counter;
+    uint8_t keymap[6];
+} replay_start_t;
+
+#define REPLAY_BUFFER_SIZE  256
+
+/* A game's recording or playback, kept in its game_state_t as replay */
+typedef struct {
+    uint8_t mode;                   /* REPLAY_OFF, REPLAY_RECORD or REPLAY_PLAYBACK */
+    uint32_t ticks;                 /* Ticks recorded or played back so far */
+    replay_start_t start;           /* Start state of the recording being played back */
+    int handle;                     /* -1 = no file */
+    uint8_t buffer[REPLAY_BUFFER_SIZE];
+    uint16_t buffer_pos;            /* Next byte to write or read */
+    uint16_t buffer_len;            /* Valid bytes (playback only) */
+    uint8_t idle_run;               /* Idle ticks not yet written, or left to play */
+} replay_context_t;
+
+/* Create a recording; the start state is written by replay_write_start().
+ * Returns 0 on success, -1 if the file cannot be created. */
+int replay_open_record(const char *filename);
+
+/* Write the start state; call once, right before the first recorded tick */
+int replay_write_start(const replay_start_t *start);
+
+/* Append one tick's consumed scancodes (count may be 0) */
+void replay_record_tick(const uint8_t *scancodes, uint8_t count);
+
+/* Open a recording for playback and read its start state into replay.start.
+ * Returns 0 on success, -1 if the file is missing or not a recording. */
+int replay_open_playback(const char *filename);
+
+/* Read the next tick's scancodes into scancodes[REPLAY_MAX_TICK_SCANCODES].
+ * Returns the number of scancodes, or -1 at the end of the recording. */
+int8_t replay_next_tick(uint8_t *scancodes);
+
+/* Finish the file (flushing a recording) and leave replay mode */
+void replay_close(void);
+
+#endif /* REPLAY_H */
@@ -0,0 +1,69 @@
+/*
+ * rewind.h - Step back through the last few hundred game ticks
+ *
+ * run_game_tick() hands the state at the start of every tick to
+ * rewind_record_tick(), which keeps it as a snapshot (see snapshot.h) in a
+ * ring buffer. Consecutive ticks differ in a few bytes, so most ticks are
+ * stored as a delta: the XOR of the snapshot with the previous tick's,
+ * run-length encoded. Every REWIND_KEYFRAME_INTERVAL ticks a keyframe (the
+ * snapshot itself, run-length encoded) starts a new group. When the ring
+ * is full the oldest group is dropped, so the oldest tick held is always a
+ * keyframe.
+ *
+ * Record layout (in a REWIND_BUFFER_SIZE-byte ring, so it may wrap), runs of:
+ *   header  high nibble: bytes unchanged (delta) or zero (keyframe), 0-14
+ *           low nibble: literal bytes that follow, 0-14
+ *   [skip]  only if the high nibble is 15: the unchanged byte count, 0-255
+ *   [count] only if the low nibble is 15: the literal byte count, 0-255
+ *   bytes   XORed into (delta) or stored in (keyframe) the snapshot
+ * until the runs cover SNAPSHOT_SIZE bytes.
+ *
+ * Stepping back restores the newest tick held and drops it. Crossing a
+ * delta is one XOR pass; crossing a keyframe decodes the previous group.
+ * At about 9 ticks a second the ring holds the last 20 seconds or so.
+ */
+
+#ifndef REWIND_H
+#define REWIND_H
+
+#include <stdint.h>
+
+#define REWIND_BUFFER_SIZE          6144  /* Encoded ticks, allocated on first use */
+#define REWIND_MAX_TICKS            256
+#define REWIND_KEYFRAME_INTERVAL    32
+
+typedef struct {
+    uint16_t start;       /* Offset of the record in ring */
+    uint16_t length;
+    uint8_t keyframe;     /* 1 = snapshot, 0 = XOR with the previous tick */
+} rewind_record_t;
+
+/* A game's rewind history, kept in its game_state_t as rewind */
+typedef struct {
+    uint8_t __far *ring;            /* REWIND_BUFFER_SIZE bytes, then newest_state */
+    uint8_t *newest_state;          /* Decoded state of the newest record */
+    uint8_t ring_failed;
+    uint16_t ring_head;             /* Where the next record is written */
+    uint16_t ring_used;
+    rewind_record_t records[REWIND_MAX_TICKS];
+    uint16_t first_record;
+    uint16_t num_records;
+    uint8_t deltas_since_keyframe;
+} rewind_context_t;
+
+/* Append the current game state as the newest tick. Does nothing if the
+ * ring buffer cannot be allocated. */
+void rewind_record_tick(void);
+
+/* Make the newest tick held the current game state and drop it from the ring.
+ * Returns 0 on success, -1 if no tick is held or its level cannot be loaded. */
+int rewind_step_back(void);
+
+/* Forget every tick held (the next tick recorded is a keyframe) */
+void rewind_reset(void);
+
+/* Ticks held, and the bytes of the ring buffer they use */
+uint16_t rewind_ticks_held(void);
+uint16_t rewind_bytes_used(void);
+
+#endif /* REWIND_H */
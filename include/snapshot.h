@@ -0,0 +1,38 @@
+/*
+ * snapshot.h - In-memory save states
+ *
+ * A snapshot is the plain-data part of game_state_t (everything after the
+ * loaded level data, see game_state.h) copied into a flat buffer of
+ * SNAPSHOT_SIZE bytes: Comic's physics, camera, level and stage, input,
+ * items, score, lives, meters, enemies, fireballs and the respawn cycles.
+ * The level descriptor, stage maps and tileset are not saved; restoring
+ * reloads them from the level's files only when the level differs, and
+ * re-renders the map only when the stage differs.
+ *
+ * Saving and restoring the state is a single memory copy. Snapshots are
+ * only valid within the program that made them (they contain the
+ * structure layout, not a file format).
+ */
+
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "game_state.h"
+
+/* First field of game_state_t that a snapshot holds */
+#define SNAPSHOT_FIRST_OFFSET   offsetof(game_state_t, current_level_number)
+
+/* Bytes in a snapshot */
+#define SNAPSHOT_SIZE           ((uint16_t)(sizeof(game_state_t) - SNAPSHOT_FIRST_OFFSET))
+
+/* Copy the current game's state into buffer[SNAPSHOT_SIZE] */
+void snapshot_save(uint8_t *buffer);
+
+/* Make buffer[SNAPSHOT_SIZE] the current game's state and bring the loaded
+ * level, map and screen in line with it.
+ * Returns 0 on success, -1 if the snapshot's level could not be loaded. */
+int snapshot_restore(const uint8_t *buffer);
+
+#endif /* SNAPSHOT_H */
@@ -0,0 +1,69 @@
+/*
+ * tile_query.h - Tile and solidity probes on the current stage's map
+ *
+ * Every read of the current stage's map goes through here: tile_id_at()
+ * for the tile IDs the renderer draws, and the solid_* probes for
+ * collision. The probes are macros, so each one compiles to a bounds
+ * compare and a bit test on game_state_t with no call and no far pointer
+ * to the map. Arguments are evaluated more than once; pass plain values.
+ * Coordinates are converted to uint8_t first, as the parameters of the
+ * functions they replaced were, so -1 wraps to 255 (off the map) rather
+ * than indexing before the bitmap. The macros read GAME, so their users
+ * include game_state.h as well.
+ *
+ * A tile is solid when its ID is greater than the tileset's last passable
+ * tile. tile_query_build() works that out once per stage for all 128 x 10
+ * tiles and stores one bit per tile in game_state_t, in two views:
+ *   solid_rows[y]     bit x of the row, 8 tiles a byte, plus one zero
+ *                     byte past the right edge
+ *   solid_columns[x]  bit y of the column, one 16-bit word per column
+ *
+ * Probes take game units (2 per tile). Something 2 units wide at an odd x
+ * straddles two tiles, and the span probes test both with one mask: the
+ * row view reads the two bytes holding tiles x and x + 1 as one 16-bit
+ * value, so a span across a byte boundary (or into the padding byte) is
+ * still a single test. Tiles outside the map are never solid.
+ */
+
+#ifndef TILE_QUERY_H
+#define TILE_QUERY_H
+
+#include <stdint.h>
+#include "globals.h"
+
+#define TILE_QUERY_ROW_BYTES    (MAP_WIDTH_TILES / 8 + 1)
+
+/* Rebuild the solidity bitmap from the current stage's tile map (all
+ * passable if no stage is loaded); call whenever current_tiles_ptr changes */
+void tile_query_build(void);
+
+/* Tile ID at tile coordinates; current_tiles_ptr must be set */
+#define tile_id_at(tile_x, tile_y) \
+    (GAME->current_tiles_ptr[(uint16_t)(tile_y) * MAP_WIDTH_TILES + (tile_x)])
+
+/* 16 bits of the row view starting at the byte that holds tile_x */
+#define TILE_QUERY_ROW_BITS(tile_x, tile_y) \
+    ((uint16_t)GAME->solid_rows[tile_y][(tile_x) >> 3] | \
+     ((uint16_t)GAME->solid_rows[tile_y][((tile_x) >> 3) + 1] << 8))
+
+/* Whether the tile containing (x, y) is solid */
+#define solid_at(x, y) \
+    ((uint8_t)((uint8_t)(y) < MAP_HEIGHT && \
+               (GAME->solid_rows[(uint8_t)(y) >> 1][(uint8_t)(x) >> 4] & \
+                (1 << (((uint8_t)(x) >> 1) & 7))) != 0))
+
+/* Whether anything 2 units wide at (x, y) is on a solid tile: the tile at
+ * (x, y) and, for odd x, the one to its right */
+#define solid_span_x(x, y) \
+    ((uint8_t)((uint8_t)(y) < MAP_HEIGHT && \
+               (TILE_QUERY_ROW_BITS((uint8_t)(x) >> 1, (uint8_t)(y) >> 1) & \
+                ((((x) & 1) ? 3u : 1u) << (((uint8_t)(x) >> 1) & 7))) != 0))
+
+/* Whether anything 2 units tall at (x, y) is on a solid tile: the tile at
+ * (x, y) and, for odd y, the one below it */
+#define solid_span_y(x, y) \
+    ((uint8_t)((uint8_t)(y) < MAP_HEIGHT && \
+               (GAME->solid_columns[(uint8_t)(x) >> 1] & \
+                ((((y) & 1) ? 3u : 1u) << ((uint8_t)(y) >> 1))) != 0))
+
+#endif /* TILE_QUERY_H */
@@ -0,0 +1,76 @@
+/*
+ * trace.h - Binary event trace of game ticks, dumped to TRACE.BIN
+ *
+ * With /TRACE, the game records timestamped events into a far buffer
+ * allocated at startup. It records:
+ *   - the start of each tick
+ *   - the end of each of its phases (the PROFILE_MARK() points, see profile.h)
+ *   - spans for level and stage loads, map renders, fullscreen graphic
+ *     loads, sprite batch flushes and unqueued sprite blits
+ *   - the door animations and each teleport frame
+ *   - an instant for every note the sound driver starts
+ * The buffer is a ring: once it is full the oldest events are overwritten,
+ * so the TRACE.BIN that terminate_program() writes holds the last
+ * TRACE_MAX_RECORDS events.
+ *
+ * Times are PIT channel 0 counts from the profiler's clock (1193182 Hz, see
+ * profile.h). Recording an event costs one timer read, so the trace adds a
+ * few microseconds per event. utils/trace2json.c (make trace2json) turns
+ * TRACE.BIN into Chrome trace JSON for chrome://tracing or ui.perfetto.dev.
+ *
+ * TRACE.BIN, little-endian:
+ *   header  "CCTR", uint16 version, uint16 record size, uint32 clock Hz,
+ *           uint32 records, uint32 records overwritten
+ *   records oldest first: uint32 time, uint8 type, uint8 event, uint16 arg
+ */
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdint.h>
+
+#define TRACE_FILE_MAGIC        "CCTR"
+#define TRACE_FILE_VERSION      1
+#define TRACE_HEADER_SIZE       20
+#define TRACE_RECORD_SIZE       8
+#define TRACE_MAX_RECORDS       8000    /* 64000 bytes */
+
+/* Record types */
+#define TRACE_TYPE_BEGIN        0
+#define TRACE_TYPE_END          1
+#define TRACE_TYPE_INSTANT      2
+
+/* Event IDs, in trace_events.h order */
+enum {
+#define TRACE_EVENT_DEF(id, name) TRACE_EVENT_##id,
+#include "trace_events.h"
+#undef TRACE_EVENT_DEF
+    TRACE_NUM_EVENTS
+};
+
+/* Nonzero once trace_start() has allocated the buffer */
+extern uint8_t trace_enabled;
+
+#define TRACE_BEGIN(event, arg) \
+    do { if (trace_enabled) trace_event(TRACE_TYPE_BEGIN, TRACE_EVENT_##event, (uint16_t)(arg)); } while (0)
+#define TRACE_END(event) \
+    do { if (trace_enabled) trace_event(TRACE_TYPE_END, TRACE_EVENT_##event, 0); } while (0)
+#define TRACE_INSTANT(event, arg) \
+    do { if (trace_enabled) trace_event(TRACE_TYPE_INSTANT, TRACE_EVENT_##event, (uint16_t)(arg)); } while (0)
+
+/*
+ * Allocate the buffer and start the clock
+ * Returns: 0 on success, -1 if the buffer cannot be allocated
+ */
+int trace_start(void);
+
+/* Record an event now (also from int8_handler()) */
+void trace_event(uint8_t type, uint8_t event, uint16_t arg);
+
+/*
+ * Write the buffered events to TRACE.BIN (nothing unless tracing)
+ * Returns: 0 on success, -1 on a file error
+ */
+int trace_dump(void);
+
+#endif /* TRACE_H */
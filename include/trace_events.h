@@ -0,0 +1,28 @@
+/*
+ * trace_events.h - Events the tick trace can record
+ * 
+ * X-macro list shared by trace.h (the TRACE_EVENT_<id> enumerators) and
+ * the TRACE.BIN converter (utils/trace2json.c). Define
+ * TRACE_EVENT_DEF(id, name) before including this file.
+ * 
+ *   id   - Suffix for the TRACE_EVENT_<id> enumerator
+ *   name - Name shown on the timeline
+ * 
+ * TRACE.BIN records store an event's position in this list: add at the end.
+ */
+
+TRACE_EVENT_DEF(TICK,                    "tick")                     /* Instant: a tick starts */
+TRACE_EVENT_DEF(PHASE,                   "phase")                    /* Instant: a PROFILE_* phase ends (arg) */
+TRACE_EVENT_DEF(LOAD_NEW_LEVEL,          "load_new_level")           /* arg: level */
+TRACE_EVENT_DEF(LOAD_NEW_STAGE,          "load_new_stage")           /* arg: stage */
+TRACE_EVENT_DEF(RENDER_MAP,              "render_map")               /* arg: camera_x */
+TRACE_EVENT_DEF(LOAD_FULLSCREEN_GRAPHIC, "load_fullscreen_graphic")  /* arg: destination offset */
+TRACE_EVENT_DEF(SPRITE_FLUSH,            "sprite_flush")             /* arg: queued sprites */
+TRACE_EVENT_DEF(SPRITE_BLIT,             "sprite_blit")              /* Unqueued; arg: SPRITE_KIND_* */
+TRACE_EVENT_DEF(ENTER_DOOR,              "enter_door")
+TRACE_EVENT_DEF(EXIT_DOOR,               "exit_door")
+TRACE_EVENT_DEF(TELEPORT_FRAME,          "teleport_frame")           /* arg: animation frame */
+TRACE_EVENT_DEF(SOUND_NOTE,              "sound_note")               /* Instant; arg: PIT divisor, 0 = off */
+TRACE_EVENT_DEF(VRAM_READS,              "vram bytes read")          /* Instant, make VRAM_STATS=1: per frame */
+TRACE_EVENT_DEF(VRAM_WRITES,             "vram bytes written")
+TRACE_EVENT_DEF(PORT_WRITES,             "ega port writes")
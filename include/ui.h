@@ -0,0 +1,37 @@
+/*
+ * ui.h - Change-tracked status panel: score, inventory and meters
+ *
+ * The score, the inventory items, the fireball meter and the HP meter are
+ * drawn by ui_update(), which run_game_tick() calls once per drawn frame
+ * just before the swap. For each gameplay page it remembers what that page
+ * shows, and draws only what differs from the current game state into the
+ * offscreen page: a score digit pair that changed, an item just collected,
+ * the meter cells whose fill changed. The page shown now is brought up to
+ * date the next time it is the offscreen page, so each change is drawn
+ * twice, once per page, and an unchanged panel costs nothing.
+ *
+ * ui_reset() says the UI background (SYS003.EGA) has just been loaded into
+ * both pages: no items, and a score and meters to draw in full. Calling it
+ * without a reload is also safe, as long as the pages show nothing the
+ * game state lacks: items are masked over themselves and the rest is
+ * unmasked. Items and the Blastola Cola can only be erased by reloading
+ * the background, so restore_stage_view() asks ui_shows_more() whether a
+ * rewound game needs one.
+ */
+
+#ifndef UI_H
+#define UI_H
+
+#include <stdint.h>
+
+/* Both pages show the bare UI background */
+void ui_reset(void);
+
+/* Draw what changed since the offscreen page was last updated */
+void ui_update(void);
+
+/* Whether either page shows an item, or a Blastola Cola firepower, that
+ * the current game state does not have */
+uint8_t ui_shows_more(void);
+
+#endif /* UI_H */
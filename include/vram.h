@@ -0,0 +1,102 @@
+/*
+ * vram.h - CPU access to EGA video memory and registers
+ *
+ * All reads and writes through far pointers into segment 0xa000 go through
+ * these macros, and so do writes to the EGA's Sequencer, Graphics
+ * Controller and CRTC ports (VRAM_OUTP). On DOS they are plain far-pointer
+ * accesses and outp() calls and compile to exactly the code they replace.
+ * In the host build (make host) they call the software EGA in host/ega.c,
+ * which applies the Map Mask, write mode, Bit Mask and latches the way the
+ * card would.
+ *
+ * Pointers passed here must point into video memory; buffers in
+ * conventional memory are still accessed directly.
+ *
+ * make VRAM_STATS=1 builds the instrumented game: every macro also counts
+ * the bytes it reads or writes, or the register write, against its call
+ * site (file and line) and the current frame. swap_video_buffers() ends a
+ * frame with VRAM_STATS_FRAME(), which records the frame's totals in the
+ * trace (see trace.h) and in per-frame statistics; terminate_program()
+ * writes those and the busiest call sites to DEBUG.LOG. The counting
+ * costs a table lookup per access, so frame times in this build are not
+ * representative, but the byte and register counts are exact.
+ */
+
+#ifndef VRAM_H
+#define VRAM_H
+
+#include <stdint.h>
+#include <conio.h>
+
+#ifdef HOST_BUILD
+
+#include "host_ega.h"
+
+#define VRAM_READ_RAW(p)            host_ega_read(HOST_EGA_OFFSET(p))
+#define VRAM_WRITE_RAW(p, v)        host_ega_write(HOST_EGA_OFFSET(p), (uint8_t)(v))
+#define VRAM_WRITE16_RAW(p, v)      host_ega_write16(HOST_EGA_OFFSET(p), (uint16_t)(v))
+#define VRAM_FILL_RAW(p, v, n)      host_ega_fill(HOST_EGA_OFFSET(p), (uint8_t)(v), (uint16_t)(n))
+#define VRAM_COPY_TO_RAW(p, src, n) host_ega_copy_to(HOST_EGA_OFFSET(p), (src), (uint16_t)(n))
+#define VRAM_COPY_FROM_RAW(dst, p, n) host_ega_copy_from((dst), HOST_EGA_OFFSET(p), (uint16_t)(n))
+
+#else
+
+#include <string.h>
+
+#define VRAM_READ_RAW(p)            (*(p))
+#define VRAM_WRITE_RAW(p, v)        (*(p) = (v))
+#define VRAM_WRITE16_RAW(p, v)      (*(uint16_t __far *)(p) = (v))
+#define VRAM_FILL_RAW(p, v, n)      _fmemset((p), (v), (n))
+#define VRAM_COPY_TO_RAW(p, src, n) _fmemcpy((p), (src), (n))
+#define VRAM_COPY_FROM_RAW(dst, p, n) _fmemcpy((dst), (p), (n))
+
+#endif /* HOST_BUILD */
+
+#ifdef VRAM_STATS
+
+/* What a counted access is */
+#define VRAM_STATS_READ         0   /* Bytes read from video memory */
+#define VRAM_STATS_WRITE        1   /* Bytes written to video memory */
+#define VRAM_STATS_PORT         2   /* EGA register writes */
+#define VRAM_STATS_KINDS        3
+
+void vram_stats_count(const char *file, uint16_t line, uint8_t kind, uint16_t amount);
+void vram_stats_frame(void);
+void vram_stats_report(void (*print)(const char *format, ...));
+
+/* A file can define this as a constant before including vram.h, to count
+ * all of its accesses as one call site (the generated compiled sprites) */
+#ifndef VRAM_STATS_LINE
+#define VRAM_STATS_LINE         __LINE__
+#endif
+
+#define VRAM_COUNT(kind, n)     vram_stats_count(__FILE__, (uint16_t)VRAM_STATS_LINE, (kind), (uint16_t)(n))
+
+#define VRAM_READ(p)            (VRAM_COUNT(VRAM_STATS_READ, 1), VRAM_READ_RAW(p))
+#define VRAM_WRITE(p, v)        (VRAM_COUNT(VRAM_STATS_WRITE, 1), VRAM_WRITE_RAW(p, v))
+#define VRAM_WRITE16(p, v)      (VRAM_COUNT(VRAM_STATS_WRITE, 2), VRAM_WRITE16_RAW(p, v))
+#define VRAM_FILL(p, v, n)      (VRAM_COUNT(VRAM_STATS_WRITE, n), VRAM_FILL_RAW(p, v, n))
+#define VRAM_COPY_TO(p, src, n) (VRAM_COUNT(VRAM_STATS_WRITE, n), VRAM_COPY_TO_RAW(p, src, n))
+#define VRAM_COPY_FROM(dst, p, n) (VRAM_COUNT(VRAM_STATS_READ, n), VRAM_COPY_FROM_RAW(dst, p, n))
+#define VRAM_OUTP(port, v)      (VRAM_COUNT(VRAM_STATS_PORT, 1), outp((port), (v)))
+
+/* End of a displayed frame; write the statistics through print */
+#define VRAM_STATS_FRAME()      vram_stats_frame()
+#define VRAM_STATS_REPORT(print) vram_stats_report(print)
+
+#else
+
+#define VRAM_READ(p)            VRAM_READ_RAW(p)
+#define VRAM_WRITE(p, v)        VRAM_WRITE_RAW(p, v)
+#define VRAM_WRITE16(p, v)      VRAM_WRITE16_RAW(p, v)
+#define VRAM_FILL(p, v, n)      VRAM_FILL_RAW(p, v, n)
+#define VRAM_COPY_TO(p, src, n) VRAM_COPY_TO_RAW(p, src, n)
+#define VRAM_COPY_FROM(dst, p, n) VRAM_COPY_FROM_RAW(dst, p, n)
+#define VRAM_OUTP(port, v)      outp((port), (v))
+
+#define VRAM_STATS_FRAME()      ((void)0)
+#define VRAM_STATS_REPORT(print) ((void)0)
+
+#endif /* VRAM_STATS */
+
+#endif /* VRAM_H */
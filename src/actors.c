@@ -18,77 +18,33 @@
 #include "player.h"
 #include "file_loaders.h"
 #include "sprite_data.h"
+#include "compiled_sprites.h"
+#include "game_state.h"
+#include "tile_query.h"
 #include "sound.h"
 #include "sound_data.h"
+#include "log.h"
 
 /* ===== External Game State Variables ===== */
 /*
- * These variables are defined in game_main.c and accessed here.
- * They represent the current game state during gameplay.
+ * Simulation state (Comic, camera, level, items, score and the enemy and
+ * fireball arrays) is reached through GAME (see game_state.h).
  */
 
-/* Player state */
-extern uint8_t comic_x;                    /* Comic X position (game units) */
-extern uint8_t comic_y;                    /* Comic Y position (game units) */
-extern uint8_t comic_facing;               /* COMIC_FACING_RIGHT or COMIC_FACING_LEFT */
-extern uint8_t comic_firepower;            /* Number of active fireball slots (0-5) */
-extern uint8_t comic_has_corkscrew;        /* 1 if Corkscrew item collected, 0 otherwise */
-extern uint8_t comic_hp;                   /* Current hit points (0-10) */
-extern uint8_t comic_has_door_key;         /* 1 if door key collected, 0 otherwise */
-extern uint8_t comic_has_teleport_wand;    /* 1 if teleport wand collected, 0 otherwise */
-extern uint8_t comic_has_lantern;          /* 1 if Lantern item collected, 0 otherwise */
-extern uint8_t comic_jump_power;           /* Jump power level (4 default, 5 with Boots) */
-extern uint8_t comic_hp_pending_increase;  /* Units of HP to award at 1 per tick */
-extern uint8_t comic_num_lives;            /* Current number of lives */
-
-/* Camera state */
-extern uint16_t camera_x;                  /* Camera X position (game units) */
-
 /* Rendering state */
 extern uint16_t offscreen_video_buffer_ptr; /* Current offscreen buffer offset */
 
-/* Game state */
-extern uint8_t score_bytes[3];             /* Current score (3-byte little-endian value) */
-/* Score macros (score_get_value and score_set_value) are defined in globals.h */
-extern const level_t *current_level_ptr; /* Pointer to current level data */
-extern uint8_t current_stage_number;       /* Current stage (0-based) */
-extern uint8_t current_level_number;       /* Current level (0-based, 0=LAKE, 1=FOREST, etc.) */
-extern uint8_t *current_tiles_ptr;         /* Pointer to current stage's tile map */
-extern uint8_t tileset_last_passable;      /* Last passable tile ID (tiles > this are solid) */
-/* Item tracking */
-extern uint8_t items_collected[8][16];     /* Bitmap: items_collected[level][stage] */
-extern uint8_t item_animation_counter;     /* 0 or 1, toggles for item animation */
-extern uint8_t comic_num_treasures;        /* Number of treasures collected (0-3) */
-extern uint8_t comic_has_gems;             /* 1 if Gems collected, 0 otherwise */
-extern uint8_t comic_has_crown;            /* 1 if Crown collected, 0 otherwise */
-extern uint8_t comic_has_gold;             /* 1 if Gold collected, 0 otherwise */
-extern uint8_t win_counter;                /* Win countdown counter; set to TREASURE_WIN_COUNTDOWN when treasures == 3 */
-
-/* Respawn timing */
-extern uint8_t enemy_respawn_counter_cycle; /* Cycles: 20→40→60→80→100→20 */
-
 /* Forward declarations for external functions */
 extern void comic_dies(void);               /* Game over sequence from physics.c */
 extern void comic_death_animation(void);    /* Death animation from game_main.c */
 extern void award_points(uint16_t points);  /* Award points from game_main.c */
 extern void award_extra_life(void);         /* Award extra life from game_main.c */
 
-/* Death animation state */
-extern uint8_t inhibit_death_by_enemy_collision; /* Set during death animation to prevent re-entry */
-extern uint8_t comic_death_animation_finished;   /* Set after animation finishes to skip partial sprite in comic_dies */
-
-/* ===== Actor Arrays ===== */
-enemy_t enemies[MAX_NUM_ENEMIES];
-fireball_t fireballs[MAX_NUM_FIREBALLS];
-uint8_t enemy_shp_index[MAX_NUM_ENEMIES];
-
 /* ===== Constants ===== */
 #define TREASURE_WIN_COUNTDOWN 20  /* Ticks to wait after collecting all 3 treasures before victory sequence */
 
 /* ===== Forward Declarations ===== */
 static void comic_takes_damage(void);
-static uint8_t is_tile_solid(uint8_t tile_id);
-static uint8_t get_tile_at(uint8_t x, uint8_t y);
 static const uint8_t *get_enemy_frame(uint8_t shp_index, uint8_t anim_index, uint8_t facing, uint16_t *out_frame_size);
 static void render_enemy_sprite(const enemy_t *enemy, uint8_t shp_index, int16_t rel_x_enemy, int16_t pixel_y);
 
@@ -107,18 +63,18 @@ static void comic_takes_damage(void)
      * Without this, if HP is being gradually filled (at game start, after respawn,
      * or after picking up a shield), the damage would be immediately negated by
      * the pending HP increment that happens in the same or next game tick. */
-    comic_hp_pending_increase = 0;
+    GAME->comic_hp_pending_increase = 0;
     
-    if (comic_hp == 0) {
+    if (GAME->comic_hp == 0) {
         /* HP is already 0 - Comic dies from this hit.
          * Only play SOUND_DEATH via comic_death_animation, NOT SOUND_DAMAGE.
          * This matches assembly behavior: no decrement_comic_hp() call here. */
-        if (inhibit_death_by_enemy_collision == 0) {
-            inhibit_death_by_enemy_collision = 1;
+        if (GAME->inhibit_death_by_enemy_collision == 0) {
+            GAME->inhibit_death_by_enemy_collision = 1;
             comic_death_animation();
-            comic_death_animation_finished = 1;
+            GAME->comic_death_animation_finished = 1;
             comic_dies();
-            inhibit_death_by_enemy_collision = 0;
+            GAME->inhibit_death_by_enemy_collision = 0;
         }
     } else {
         /* HP > 0: decrement HP (which plays SOUND_DAMAGE).
@@ -127,166 +83,6 @@ static void comic_takes_damage(void)
     }
 }
 
-/*
- * is_tile_solid - Check if a tile ID represents a solid tile
- * 
- * Parameters:
- *   tile_id - Tile ID to check
- * 
- * Returns:
- *   1 if solid, 0 if passable
- */
-static uint8_t is_tile_solid(uint8_t tile_id)
-{
-    /* Match physics behavior: tiles greater than tileset_last_passable are solid */
-    return (tile_id > tileset_last_passable) ? 1 : 0;
-}
-
-/*
- * get_tile_at - Get tile ID at coordinates
- * 
- * Parameters:
- *   x - X position in game units (0-255)
- *   y - Y position in game units (0-19)
- * 
- * Returns:
- *   Tile ID, or 0 if out of bounds
- */
-static uint8_t get_tile_at(uint8_t x, uint8_t y)
-{
-    uint16_t tile_x, tile_y, offset;
-    
-    /* Get current tiles pointer (set by load_new_stage) */
-    if (current_tiles_ptr == NULL) {
-        return 0;
-    }
-    
-    /* Convert game units to tile coordinates (2 game units = 1 tile) */
-    tile_x = x / 2;
-    tile_y = y / 2;
-    
-    /* Bounds check */
-    if (tile_x >= MAP_WIDTH_TILES || tile_y >= MAP_HEIGHT_TILES) {
-        return 0;
-    }
-    
-    /* Calculate offset: y * MAP_WIDTH_TILES + x */
-    offset = tile_y * MAP_WIDTH_TILES + tile_x;
-    
-    /* Read tile from map data */
-    return current_tiles_ptr[offset];
-}
-
-/*
- * check_vertical_enemy_map_collision - Check for solid tiles when moving vertically
- * 
- * Enemies are 2 units wide, so when the X coordinate is odd (in the middle of a tile),
- * the enemy spans two horizontal tiles. This function checks both tiles when needed.
- * 
- * Parameters:
- *   x - X position in game units (0-255)
- *   y - Y position in game units (0-19)
- * 
- * Returns:
- *   true (1) if collision detected with solid tile, false (0) otherwise
- */
-static uint8_t check_vertical_enemy_map_collision(uint8_t x, uint8_t y)
-{
-    uint8_t tile_x, tile_y;
-    uint16_t tile_offset;
-    uint8_t tile_id;
-    
-    if (current_tiles_ptr == NULL) {
-        return 0;
-    }
-    
-    /* Convert game units to tile coordinates (divide by 2) */
-    tile_x = x >> 1;
-    tile_y = y >> 1;
-    
-    /* Bounds check */
-    if (tile_x >= MAP_WIDTH_TILES || tile_y >= MAP_HEIGHT_TILES) {
-        return 0;
-    }
-    
-    /* Calculate tile offset: y/2 * MAP_WIDTH_TILES + x/2 */
-    tile_offset = tile_y * MAP_WIDTH_TILES + tile_x;
-    
-    /* Check primary tile at (x, y) */
-    tile_id = current_tiles_ptr[tile_offset];
-    if (tile_id > tileset_last_passable) {
-        return 1;  /* Solid collision */
-    }
-    
-    /* If X coordinate is odd, enemy spans two tiles horizontally */
-    if (x & 1) {
-        /* Check tile to the right: (x+1, y) */
-        if (tile_x + 1 < MAP_WIDTH_TILES) {
-            tile_id = current_tiles_ptr[tile_offset + 1];
-            if (tile_id > tileset_last_passable) {
-                return 1;  /* Solid collision */
-            }
-        }
-    }
-    
-    return 0;  /* No collision */
-}
-
-/*
- * check_horizontal_enemy_map_collision - Check for solid tiles when moving horizontally
- * 
- * Enemies are 2 units tall, so when the Y coordinate is odd (in the middle of a tile),
- * the enemy spans two vertical tiles. This function checks both tiles when needed.
- * 
- * Parameters:
- *   x - X position in game units (0-255)
- *   y - Y position in game units (0-19)
- * 
- * Returns:
- *   true (1) if collision detected with solid tile, false (0) otherwise
- */
-static uint8_t check_horizontal_enemy_map_collision(uint8_t x, uint8_t y)
-{
-    uint8_t tile_x, tile_y;
-    uint16_t tile_offset;
-    uint8_t tile_id;
-    
-    if (current_tiles_ptr == NULL) {
-        return 0;
-    }
-    
-    /* Convert game units to tile coordinates (divide by 2) */
-    tile_x = x >> 1;
-    tile_y = y >> 1;
-    
-    /* Bounds check */
-    if (tile_x >= MAP_WIDTH_TILES || tile_y >= MAP_HEIGHT_TILES) {
-        return 0;
-    }
-    
-    /* Calculate tile offset: y/2 * MAP_WIDTH_TILES + x/2 */
-    tile_offset = tile_y * MAP_WIDTH_TILES + tile_x;
-    
-    /* Check primary tile at (x, y) */
-    tile_id = current_tiles_ptr[tile_offset];
-    if (tile_id > tileset_last_passable) {
-        return 1;  /* Solid collision */
-    }
-    
-    /* If Y coordinate is odd, enemy spans two tiles vertically */
-    if (y & 1) {
-        /* Check tile below: (x, y+1) */
-        if (tile_y + 1 < MAP_HEIGHT_TILES) {
-            tile_id = current_tiles_ptr[tile_offset + MAP_WIDTH_TILES];
-            if (tile_id > tileset_last_passable) {
-                return 1;  /* Solid collision */
-            }
-        }
-    }
-    
-    return 0;  /* No collision */
-}
-
 /*
  * get_enemy_frame - Resolve enemy sprite frame pointer
  * 
@@ -373,27 +169,27 @@ void try_to_fire(void)
     int i;
     
     /* Check if Comic has firepower */
-    if (comic_firepower == 0) {
+    if (GAME->comic_firepower == 0) {
         return;
     }
     
     /* Find an open fireball slot */
-    for (i = 0; i < comic_firepower && i < MAX_NUM_FIREBALLS; i++) {
-        if (fireballs[i].x == FIREBALL_DEAD && fireballs[i].y == FIREBALL_DEAD) {
+    for (i = 0; i < GAME->comic_firepower && i < MAX_NUM_FIREBALLS; i++) {
+        if (GAME->fireballs[i].x == FIREBALL_DEAD && GAME->fireballs[i].y == FIREBALL_DEAD) {
             /* Found empty slot - spawn fireball */
-            fireballs[i].y = comic_y + 1;
-            fireballs[i].x = comic_x;
+            GAME->fireballs[i].y = GAME->comic_y + 1;
+            GAME->fireballs[i].x = GAME->comic_x;
             
             /* Set velocity based on Comic's facing direction */
-            if (comic_facing == COMIC_FACING_RIGHT) {
-                fireballs[i].vel = FIREBALL_VELOCITY;  /* +2 */
+            if (GAME->comic_facing == COMIC_FACING_RIGHT) {
+                GAME->fireballs[i].vel = FIREBALL_VELOCITY;  /* +2 */
             } else {
-                fireballs[i].vel = -FIREBALL_VELOCITY; /* -2 */
+                GAME->fireballs[i].vel = -FIREBALL_VELOCITY; /* -2 */
             }
             
-            fireballs[i].corkscrew_phase = 2;
-            fireballs[i].animation = 0;
-            fireballs[i].num_animation_frames = 2;
+            GAME->fireballs[i].corkscrew_phase = 2;
+            GAME->fireballs[i].animation = 0;
+            GAME->fireballs[i].num_animation_frames = 2;
             
             play_sound(SOUND_FIRE, 0);
             
@@ -411,75 +207,75 @@ void handle_fireballs(void)
     int16_t rel_x;
     
     /* Skip if Comic has no firepower */
-    if (comic_firepower == 0) {
+    if (GAME->comic_firepower == 0) {
         return;
     }
     
     /* Pass 1: movement + animation + render over the first comic_firepower slots */
-    for (i = 0; i < comic_firepower && i < MAX_NUM_FIREBALLS; i++) {
+    for (i = 0; i < GAME->comic_firepower && i < MAX_NUM_FIREBALLS; i++) {
         /* Skip inactive fireballs */
-        if (fireballs[i].x == FIREBALL_DEAD && fireballs[i].y == FIREBALL_DEAD) {
+        if (GAME->fireballs[i].x == FIREBALL_DEAD && GAME->fireballs[i].y == FIREBALL_DEAD) {
             continue;
         }
         
         /* Apply horizontal velocity */
-        fireballs[i].x += fireballs[i].vel;
+        GAME->fireballs[i].x += GAME->fireballs[i].vel;
         
         /* Check despawn conditions (off-screen) before corkscrew/animation */
-        if (fireballs[i].x < camera_x) {
+        if (GAME->fireballs[i].x < GAME->camera_x) {
             /* Off left edge */
-            fireballs[i].x = FIREBALL_DEAD;
-            fireballs[i].y = FIREBALL_DEAD;
+            GAME->fireballs[i].x = FIREBALL_DEAD;
+            GAME->fireballs[i].y = FIREBALL_DEAD;
             continue;
         }
 
-        rel_x = (int16_t)((int)fireballs[i].x - (int)camera_x);
+        rel_x = (int16_t)((int)GAME->fireballs[i].x - (int)GAME->camera_x);
         if (rel_x > (PLAYFIELD_WIDTH - 2)) {
             /* Off right edge */
-            fireballs[i].x = FIREBALL_DEAD;
-            fireballs[i].y = FIREBALL_DEAD;
+            GAME->fireballs[i].x = FIREBALL_DEAD;
+            GAME->fireballs[i].y = FIREBALL_DEAD;
             continue;
         }
 
         /* Apply corkscrew motion if Comic has Corkscrew item */
-        if (comic_has_corkscrew) {
-            if (fireballs[i].corkscrew_phase == 2) {
+        if (GAME->comic_has_corkscrew) {
+            if (GAME->fireballs[i].corkscrew_phase == 2) {
                 /* Phase 2→1: move down */
-                fireballs[i].y++;
-                fireballs[i].corkscrew_phase = 1;
-            } else if (fireballs[i].corkscrew_phase == 1) {
+                GAME->fireballs[i].y++;
+                GAME->fireballs[i].corkscrew_phase = 1;
+            } else if (GAME->fireballs[i].corkscrew_phase == 1) {
                 /* Phase 1→0→2: move up */
-                fireballs[i].y--;
-                fireballs[i].corkscrew_phase = 2;
+                GAME->fireballs[i].y--;
+                GAME->fireballs[i].corkscrew_phase = 2;
             }
         }
         
         /* Advance animation frame */
-        fireballs[i].animation++;
-        if (fireballs[i].animation >= fireballs[i].num_animation_frames) {
-            fireballs[i].animation = 0;
+        GAME->fireballs[i].animation++;
+        if (GAME->fireballs[i].animation >= GAME->fireballs[i].num_animation_frames) {
+            GAME->fireballs[i].animation = 0;
         }
 
         /* Render fireball sprite in playfield */
         {
             int16_t pixel_x, pixel_y;
-            const uint8_t *sprite_ptr;
+            uint8_t sprite_id;
 
             pixel_x = (rel_x * 8) + 8;
-            pixel_y = (fireballs[i].y * 8) + 8;
+            pixel_y = (GAME->fireballs[i].y * 8) + 8;
 
-            sprite_ptr = (fireballs[i].animation == 0)
-                ? sprite_fireball_0_16x8m
-                : sprite_fireball_1_16x8m;
+            sprite_id = (GAME->fireballs[i].animation == 0)
+                ? COMPILED_SPRITE_FIREBALL_0
+                : COMPILED_SPRITE_FIREBALL_1;
 
-            blit_sprite_16x8_masked((uint16_t)pixel_x, (uint16_t)pixel_y, sprite_ptr);
+            blit_compiled_sprite(sprite_id, (uint16_t)pixel_x, (uint16_t)pixel_y);
         }
     }
 
     /* Pass 2: collision scan over all fireball slots (assembly behavior) */
     for (i = 0; i < MAX_NUM_FIREBALLS; i++) {
         /* Skip inactive fireballs */
-        if (fireballs[i].x == FIREBALL_DEAD && fireballs[i].y == FIREBALL_DEAD) {
+        if (GAME->fireballs[i].x == FIREBALL_DEAD && GAME->fireballs[i].y == FIREBALL_DEAD) {
             continue;
         }
 
@@ -488,26 +284,26 @@ void handle_fireballs(void)
             int8_t y_diff, x_diff;
             
             /* Skip despawned or dying enemies */
-            if (enemies[j].state != ENEMY_STATE_SPAWNED) {
+            if (GAME->enemies[j].state != ENEMY_STATE_SPAWNED) {
                 continue;
             }
             
             /* Check vertical overlap: 0 <= (fireball.y - enemy.y) <= 1 */
-            y_diff = (int8_t)(fireballs[i].y - enemies[j].y);
+            y_diff = (int8_t)(GAME->fireballs[i].y - GAME->enemies[j].y);
             if (y_diff < 0 || y_diff > 1) {
                 continue;
             }
             
             /* Check horizontal overlap: abs(fireball.x - enemy.x) <= 1 */
-            x_diff = (int8_t)(fireballs[i].x - enemies[j].x);
+            x_diff = (int8_t)(GAME->fireballs[i].x - GAME->enemies[j].x);
             if (x_diff < -1 || x_diff > 1) {
                 continue;
             }
             
             /* Collision detected! */
-            enemies[j].state = ENEMY_STATE_WHITE_SPARK; /* Start death animation */
-            fireballs[i].x = FIREBALL_DEAD;
-            fireballs[i].y = FIREBALL_DEAD;
+            GAME->enemies[j].state = ENEMY_STATE_WHITE_SPARK; /* Start death animation */
+            GAME->fireballs[i].x = FIREBALL_DEAD;
+            GAME->fireballs[i].y = FIREBALL_DEAD;
             award_points(3);  /* 3 * 100 = 300 points */
             play_sound(SOUND_HIT_ENEMY, 1);
             
@@ -531,10 +327,10 @@ static void collect_treasure(uint8_t *has_treasure_flag)
 {
     if (!*has_treasure_flag) {
         *has_treasure_flag = 1;
-        if (comic_num_treasures < 3) {
-            comic_num_treasures++;
-            if (comic_num_treasures == 3) {
-                win_counter = TREASURE_WIN_COUNTDOWN;
+        if (GAME->comic_num_treasures < 3) {
+            GAME->comic_num_treasures++;
+            if (GAME->comic_num_treasures == 3) {
+                GAME->win_counter = TREASURE_WIN_COUNTDOWN;
             }
         }
     }
@@ -550,17 +346,17 @@ void handle_item(void)
     int16_t rel_x, x_diff, y_diff;
     uint8_t level_index, stage_index;
     
-    if (current_level_ptr == NULL) {
+    if (GAME->current_level_ptr == NULL) {
         return;
     }
     
     /* Validate stage number is within bounds (0-2) */
-    if (current_stage_number >= 3) {
+    if (GAME->current_stage_number >= 3) {
         return;
     }
     
     /* Get current stage data */
-    stage = &current_level_ptr->stages[current_stage_number];
+    stage = &GAME->current_level_ptr->stages[GAME->current_stage_number];
     
     /* Check if stage has an item */
     item_type = stage->item_type;
@@ -569,10 +365,10 @@ void handle_item(void)
     }
     
     /* Check if already collected */
-    level_index = current_level_number;
-    stage_index = current_stage_number;
+    level_index = GAME->current_level_number;
+    stage_index = GAME->current_stage_number;
     
-    if (items_collected[level_index][stage_index]) {
+    if (GAME->items_collected[level_index][stage_index]) {
         return; /* Already collected */
     }
     
@@ -581,69 +377,69 @@ void handle_item(void)
     item_y = stage->item_y;
     
     /* Check if item is visible in playfield */
-    rel_x = (int16_t)((int)item_x - (int)camera_x);
+    rel_x = (int16_t)((int)item_x - (int)GAME->camera_x);
     if (rel_x < 0 || rel_x > 22) {
         return; /* Off-screen */
     }
     
     /* Check collision with Comic */
-    x_diff = (int16_t)((int)item_x - (int)comic_x);
-    y_diff = (int16_t)((int)item_y - (int)comic_y);
+    x_diff = (int16_t)((int)item_x - (int)GAME->comic_x);
+    y_diff = (int16_t)((int)item_y - (int)GAME->comic_y);
     
     /* Horizontal: abs(item.x - comic_x) < 2 */
     if (x_diff >= -1 && x_diff <= 1) {
         /* Vertical: 0 <= (item.y - comic_y) < 4 */
         if (y_diff >= 0 && y_diff < 4) {
             /* Collision detected - collect item! */
-            items_collected[level_index][stage_index] = 1;
+            GAME->items_collected[level_index][stage_index] = 1;
             award_points(20);  /* 20 * 100 = 2000 points */
             play_sound(SOUND_COLLECT_ITEM, 3);
             
             /* Update game state based on item type */
             switch (item_type) {
                 case ITEM_CORKSCREW:
-                    comic_has_corkscrew = 1;
+                    GAME->comic_has_corkscrew = 1;
                     break;
                 case ITEM_BLASTOLA_COLA:
-                    if (comic_firepower < MAX_NUM_FIREBALLS) {
-                        comic_firepower++;
+                    if (GAME->comic_firepower < MAX_NUM_FIREBALLS) {
+                        GAME->comic_firepower++;
                     }
                     break;
                 case ITEM_BOOTS:
                     /* Grant increased jump power */
-                    comic_jump_power = 5;
+                    GAME->comic_jump_power = 5;
                     break;
                 case ITEM_LANTERN:
                     /* Grant light in dark areas (Castle level) */
-                    comic_has_lantern = 1;
+                    GAME->comic_has_lantern = 1;
                     break;
                 case ITEM_SHIELD:
                     /* Shield instantly refills HP (matches original assembly behavior).
                      * Schedule HP increase to fill from current to MAX_HP only. */
-                    if (comic_hp >= MAX_HP) {
+                    if (GAME->comic_hp >= MAX_HP) {
                         /* Full HP: award an extra life */
                         award_extra_life();
                     } else {
                         /* Not full: schedule only the missing HP increments */
-                        comic_hp_pending_increase = MAX_HP - comic_hp;
+                        GAME->comic_hp_pending_increase = MAX_HP - GAME->comic_hp;
                     }
                     break;
                 case ITEM_TELEPORT_WAND:
                     /* Grant teleport ability */
-                    comic_has_teleport_wand = 1;
+                    GAME->comic_has_teleport_wand = 1;
                     break;
                 case ITEM_DOOR_KEY:
                     /* Grant door opening ability */
-                    comic_has_door_key = 1;
+                    GAME->comic_has_door_key = 1;
                     break;
                 case ITEM_CROWN:
-                    collect_treasure(&comic_has_crown);
+                    collect_treasure(&GAME->comic_has_crown);
                     break;
                 case ITEM_GOLD:
-                    collect_treasure(&comic_has_gold);
+                    collect_treasure(&GAME->comic_has_gold);
                     break;
                 case ITEM_GEMS:
-                    collect_treasure(&comic_has_gems);
+                    collect_treasure(&GAME->comic_has_gems);
                     break;
                 /* TODO: Implement other item types */
                 default:
@@ -657,10 +453,10 @@ void handle_item(void)
     /* Render item sprite */
     {
         int16_t pixel_x, pixel_y;
-        const uint8_t *sprite_ptr = NULL;
+        uint8_t sprite_id = COMPILED_SPRITE_NONE;
         
         /* Calculate screen position relative to camera */
-        rel_x = (int8_t)(item_x - camera_x);
+        rel_x = (int8_t)(item_x - GAME->camera_x);
         
         /* Convert to pixel coordinates (8 pixels per game unit) + playfield offset */
         pixel_x = (rel_x * 8) + 8;
@@ -669,65 +465,65 @@ void handle_item(void)
         switch (item_type) {
             case ITEM_BLASTOLA_COLA:
                 /* Always use base sprites for items in levels (not firepower-level variants) */
-                sprite_ptr = (item_animation_counter == 0)
-                    ? sprite_blastola_cola_even_16x16m
-                    : sprite_blastola_cola_odd_16x16m;
+                sprite_id = (GAME->item_animation_counter == 0)
+                    ? COMPILED_SPRITE_BLASTOLA_COLA_EVEN
+                    : COMPILED_SPRITE_BLASTOLA_COLA_ODD;
                 break;
             case ITEM_CORKSCREW:
-                sprite_ptr = (item_animation_counter == 0)
-                    ? sprite_corkscrew_even_16x16m
-                    : sprite_corkscrew_odd_16x16m;
+                sprite_id = (GAME->item_animation_counter == 0)
+                    ? COMPILED_SPRITE_CORKSCREW_EVEN
+                    : COMPILED_SPRITE_CORKSCREW_ODD;
                 break;
             case ITEM_DOOR_KEY:
-                sprite_ptr = (item_animation_counter == 0)
-                    ? sprite_door_key_even_16x16m
-                    : sprite_door_key_odd_16x16m;
+                sprite_id = (GAME->item_animation_counter == 0)
+                    ? COMPILED_SPRITE_DOOR_KEY_EVEN
+                    : COMPILED_SPRITE_DOOR_KEY_ODD;
                 break;
             case ITEM_BOOTS:
-                sprite_ptr = (item_animation_counter == 0)
-                    ? sprite_boots_even_16x16m
-                    : sprite_boots_odd_16x16m;
+                sprite_id = (GAME->item_animation_counter == 0)
+                    ? COMPILED_SPRITE_BOOTS_EVEN
+                    : COMPILED_SPRITE_BOOTS_ODD;
                 break;
             case ITEM_LANTERN:
-                sprite_ptr = (item_animation_counter == 0)
-                    ? sprite_lantern_even_16x16m
-                    : sprite_lantern_odd_16x16m;
+                sprite_id = (GAME->item_animation_counter == 0)
+                    ? COMPILED_SPRITE_LANTERN_EVEN
+                    : COMPILED_SPRITE_LANTERN_ODD;
                 break;
             case ITEM_TELEPORT_WAND:
-                sprite_ptr = (item_animation_counter == 0)
-                    ? sprite_teleport_wand_even_16x16m
-                    : sprite_teleport_wand_odd_16x16m;
+                sprite_id = (GAME->item_animation_counter == 0)
+                    ? COMPILED_SPRITE_TELEPORT_WAND_EVEN
+                    : COMPILED_SPRITE_TELEPORT_WAND_ODD;
                 break;
             case ITEM_GEMS:
-                sprite_ptr = (item_animation_counter == 0)
-                    ? sprite_gems_even_16x16m
-                    : sprite_gems_odd_16x16m;
+                sprite_id = (GAME->item_animation_counter == 0)
+                    ? COMPILED_SPRITE_GEMS_EVEN
+                    : COMPILED_SPRITE_GEMS_ODD;
                 break;
             case ITEM_CROWN:
-                sprite_ptr = (item_animation_counter == 0)
-                    ? sprite_crown_even_16x16m
-                    : sprite_crown_odd_16x16m;
+                sprite_id = (GAME->item_animation_counter == 0)
+                    ? COMPILED_SPRITE_CROWN_EVEN
+                    : COMPILED_SPRITE_CROWN_ODD;
                 break;
             case ITEM_GOLD:
-                sprite_ptr = (item_animation_counter == 0)
-                    ? sprite_gold_even_16x16m
-                    : sprite_gold_odd_16x16m;
+                sprite_id = (GAME->item_animation_counter == 0)
+                    ? COMPILED_SPRITE_GOLD_EVEN
+                    : COMPILED_SPRITE_GOLD_ODD;
                 break;
             case ITEM_SHIELD:
-                sprite_ptr = (item_animation_counter == 0)
-                    ? sprite_shield_even_16x16m
-                    : sprite_shield_odd_16x16m;
+                sprite_id = (GAME->item_animation_counter == 0)
+                    ? COMPILED_SPRITE_SHIELD_EVEN
+                    : COMPILED_SPRITE_SHIELD_ODD;
                 break;
             default:
                 break;
         }
 
-        if (sprite_ptr != NULL) {
-            blit_sprite_16x16_masked((uint16_t)pixel_x, (uint16_t)pixel_y, sprite_ptr);
+        if (sprite_id != COMPILED_SPRITE_NONE) {
+            blit_compiled_sprite(sprite_id, (uint16_t)pixel_x, (uint16_t)pixel_y);
             /* Advance animation counter (0->1->0) after render, matching assembly */
-            item_animation_counter++;
-            if (item_animation_counter >= 2) {
-                item_animation_counter = 0;
+            GAME->item_animation_counter++;
+            if (GAME->item_animation_counter >= 2) {
+                GAME->item_animation_counter = 0;
             }
         }
     }
@@ -736,7 +532,6 @@ void handle_item(void)
 /* ===== Enemy System ===== */
 
 /* Global flag to ensure no more than one enemy spawns per tick */
-static int spawned_this_tick = 0;
 
 /*
  * maybe_spawn_enemy - Attempt to spawn one enemy
@@ -750,42 +545,41 @@ int maybe_spawn_enemy(int enemy_index)
     enemy_t *enemy;
     uint8_t spawn_x, spawn_y;
     int8_t y_search;
-    static uint8_t spawn_offset_cycle = PLAYFIELD_WIDTH; /* Cycles: 24, 26, 28, 30 */
     
     /* Reset timer to 0 (matches ASM behavior) */
-    enemies[enemy_index].spawn_timer_and_animation = 0;
+    GAME->enemies[enemy_index].spawn_timer_and_animation = 0;
     
     /* Check if another enemy already spawned this tick */
-    if (spawned_this_tick) {
+    if (GAME->spawned_this_tick) {
         return 0;
     }
     
-    if (current_level_ptr == NULL) {
+    if (GAME->current_level_ptr == NULL) {
         return 0;
     }
     
     /* Validate stage number is within bounds (0-2) */
-    if (current_stage_number >= 3) {
+    if (GAME->current_stage_number >= 3) {
         return 0;
     }
     
-    stage = &current_level_ptr->stages[current_stage_number];
-    enemy = &enemies[enemy_index];
+    stage = &GAME->current_level_ptr->stages[GAME->current_stage_number];
+    enemy = &GAME->enemies[enemy_index];
     
     /* Calculate spawn X position based on Comic's facing direction
      * Advance spawn_offset_cycle: cycles through PLAYFIELD_WIDTH, +2, +4, +6
      * This determines how far outside the playfield the enemy spawns: 0, 2, 4, or 6 units */
-    spawn_offset_cycle += 2;
-    if (spawn_offset_cycle >= PLAYFIELD_WIDTH + 7) {
-        spawn_offset_cycle = PLAYFIELD_WIDTH;
+    GAME->spawn_offset_cycle += 2;
+    if (GAME->spawn_offset_cycle >= PLAYFIELD_WIDTH + 7) {
+        GAME->spawn_offset_cycle = PLAYFIELD_WIDTH;
     }
     
-    if (comic_facing == COMIC_FACING_RIGHT) {
+    if (GAME->comic_facing == COMIC_FACING_RIGHT) {
         /* Spawn to the right: camera_x + spawn_offset_cycle */
-        spawn_x = (uint8_t)(camera_x + spawn_offset_cycle);
+        spawn_x = (uint8_t)(GAME->camera_x + GAME->spawn_offset_cycle);
     } else {
         /* Spawn to the left: camera_x - (spawn_offset_cycle - PLAYFIELD_WIDTH + 2) */
-        spawn_x = (uint8_t)(camera_x - (spawn_offset_cycle - PLAYFIELD_WIDTH + 2));
+        spawn_x = (uint8_t)(GAME->camera_x - (GAME->spawn_offset_cycle - PLAYFIELD_WIDTH + 2));
     }
     
     /* spawn_x is uint8_t (0-255), MAP_WIDTH is 256, so no bounds check needed */
@@ -793,20 +587,16 @@ int maybe_spawn_enemy(int enemy_index)
     /* Find valid vertical spawn position: search UPWARD from Comic's feet
      * to find a non-solid tile above a solid tile (like the ASM does).
      * Start at Comic's feet (comic_y + 4), clamped to even boundary */
-    spawn_y = (comic_y & 0xFE) + 4;  /* Clamp to even tile boundary, then add 4 (Comic's feet) */
+    spawn_y = (GAME->comic_y & 0xFE) + 4;  /* Clamp to even tile boundary, then add 4 (Comic's feet) */
     
     /* First, search upward to find a solid tile */
     for (y_search = 0; y_search < 20; y_search++) {
-        uint8_t tile_at_y;
-        
         if (spawn_y == 0) {
             /* Reached top of map without finding solid tile */
             return 0;
         }
         
-        tile_at_y = get_tile_at(spawn_x, spawn_y);
-        
-        if (is_tile_solid(tile_at_y)) {
+        if (solid_at(spawn_x, spawn_y)) {
             /* Found a solid tile, now search upward for a non-solid tile above it */
             goto find_nonsolid;
         }
@@ -821,16 +611,12 @@ int maybe_spawn_enemy(int enemy_index)
 find_nonsolid:
     /* Now search upward to find a non-solid tile above the solid tile */
     for (y_search = 0; y_search < 20; y_search++) {
-        uint8_t tile_at_y;
-        
         if (spawn_y == 0) {
             /* Reached top of map without finding non-solid tile */
             return 0;
         }
         
-        tile_at_y = get_tile_at(spawn_x, spawn_y);
-        
-        if (!is_tile_solid(tile_at_y)) {
+        if (!solid_at(spawn_x, spawn_y)) {
             /* Found a non-solid tile above solid ground - this is the spawn position */
             goto spawn_enemy;
         }
@@ -846,14 +632,14 @@ spawn_enemy:
     /* Check if this is an unused enemy slot */
     if ((enemy->behavior & ~ENEMY_BEHAVIOR_FAST) == ENEMY_BEHAVIOR_UNUSED) {
         /* Undo the spawn - clear the flag and stay despawned */
-        spawned_this_tick = 0;
+        GAME->spawned_this_tick = 0;
         enemy->state = ENEMY_STATE_DESPAWNED;
         enemy->spawn_timer_and_animation = 100; /* Try again in 100 ticks */
         return 0;
     }
     
     /* Mark that we spawned an enemy this tick */
-    spawned_this_tick = 1;
+    GAME->spawned_this_tick = 1;
     
     /* Initialize enemy state */
     enemy->x = spawn_x;
@@ -893,16 +679,16 @@ void handle_enemies(void)
     int i;
     int16_t rel_x_enemy; /* used when rendering sparks */
     int16_t pixel_x, pixel_y; /* used when rendering sparks */
-    const uint8_t *spark_ptr; /* used when rendering sparks */
+    uint8_t spark_id; /* used when rendering sparks */
     uint8_t spark_frame; /* used when rendering sparks */
     uint8_t normalized_spark_state; /* white/red spark frame normalized to white spark range */
     
     /* Reset spawn flag for this tick */
-    spawned_this_tick = 0;
+    GAME->spawned_this_tick = 0;
     
     /* Update each enemy slot */
     for (i = 0; i < MAX_NUM_ENEMIES; i++) {
-        enemy_t *enemy = &enemies[i];
+        enemy_t *enemy = &GAME->enemies[i];
         int16_t x_diff, y_diff;
         
         /* Match assembly dispatch flow: spawned, despawned, then dying. */
@@ -936,15 +722,15 @@ void handle_enemies(void)
             }
             
             /* Check despawn distance (30 game units from Comic) */
-            x_diff = (int16_t)((int)enemy->x - (int)comic_x);
+            x_diff = (int16_t)((int)enemy->x - (int)GAME->comic_x);
             if (x_diff < -ENEMY_DESPAWN_RADIUS || x_diff > ENEMY_DESPAWN_RADIUS) {
                 enemy->state = ENEMY_STATE_DESPAWNED;
-                enemy->spawn_timer_and_animation = enemy_respawn_counter_cycle;
+                enemy->spawn_timer_and_animation = GAME->enemy_respawn_counter_cycle;
                 continue;
             }
             
             /* Check collision with Comic */
-            y_diff = (int16_t)((int)enemy->y - (int)comic_y);
+            y_diff = (int16_t)((int)enemy->y - (int)GAME->comic_y);
             
             /* Horizontal: abs(enemy.x - comic_x) < 2 */
             if (x_diff >= -1 && x_diff <= 1) {
@@ -963,10 +749,10 @@ void handle_enemies(void)
             {
                 int16_t rel_x_enemy;
                 int16_t pixel_y;
-                uint8_t shp_index = enemy_shp_index[i];
+                uint8_t shp_index = GAME->enemy_shp_index[i];
                 
                 /* Calculate screen position relative to camera */
-                rel_x_enemy = (int16_t)((int)enemy->x - (int)camera_x);
+                rel_x_enemy = (int16_t)((int)enemy->x - (int)GAME->camera_x);
                 
                 /* Convert to pixel coordinates (8 pixels per game unit) + playfield offset */
                 pixel_y = (enemy->y * 8) + 8;
@@ -994,17 +780,17 @@ void handle_enemies(void)
              * immediately despawn without rendering the final frame to match original assembly behavior. */
             if (enemy->state == ENEMY_STATE_WHITE_SPARK + 5 || enemy->state == ENEMY_STATE_RED_SPARK + 5) {
                 enemy->state = ENEMY_STATE_DESPAWNED;
-                enemy->spawn_timer_and_animation = enemy_respawn_counter_cycle;
+                enemy->spawn_timer_and_animation = GAME->enemy_respawn_counter_cycle;
                 /* Cycle respawn counter: 20→40→60→80→100→20 */
-                enemy_respawn_counter_cycle += 20;
-                if (enemy_respawn_counter_cycle > 100) {
-                    enemy_respawn_counter_cycle = 20;
+                GAME->enemy_respawn_counter_cycle += 20;
+                if (GAME->enemy_respawn_counter_cycle > 100) {
+                    GAME->enemy_respawn_counter_cycle = 20;
                 }
                 continue;
             }
 
             /* Declarations for rendering (C89: must appear before statements) */
-            rel_x_enemy = (int16_t)((int)enemy->x - (int)camera_x);
+            rel_x_enemy = (int16_t)((int)enemy->x - (int)GAME->camera_x);
             normalized_spark_state = enemy->state;
             if (normalized_spark_state >= ENEMY_STATE_RED_SPARK) {
                 normalized_spark_state = (uint8_t)(normalized_spark_state - (ENEMY_STATE_RED_SPARK - ENEMY_STATE_WHITE_SPARK));
@@ -1017,27 +803,27 @@ void handle_enemies(void)
                 pixel_y = (enemy->y * 8) + 8;
 
                 if (normalized_spark_state <= ENEMY_STATE_WHITE_SPARK + 2) {
-                    render_enemy_sprite(enemy, enemy_shp_index[i], rel_x_enemy, pixel_y);
+                    render_enemy_sprite(enemy, GAME->enemy_shp_index[i], rel_x_enemy, pixel_y);
                 }
 
                 if (enemy->state >= ENEMY_STATE_RED_SPARK) {
                     spark_frame = (uint8_t)((enemy->state - ENEMY_STATE_RED_SPARK) % 3);
                     switch (spark_frame) {
-                        case 0: spark_ptr = sprite_red_spark_0_16x16m; break;
-                        case 1: spark_ptr = sprite_red_spark_1_16x16m; break;
-                        default: spark_ptr = sprite_red_spark_2_16x16m; break;
+                        case 0: spark_id = COMPILED_SPRITE_RED_SPARK_0; break;
+                        case 1: spark_id = COMPILED_SPRITE_RED_SPARK_1; break;
+                        default: spark_id = COMPILED_SPRITE_RED_SPARK_2; break;
                     }
                 } else {
                     spark_frame = (uint8_t)((enemy->state - ENEMY_STATE_WHITE_SPARK) % 3);
                     switch (spark_frame) {
-                        case 0: spark_ptr = sprite_white_spark_0_16x16m; break;
-                        case 1: spark_ptr = sprite_white_spark_1_16x16m; break;
-                        default: spark_ptr = sprite_white_spark_2_16x16m; break;
+                        case 0: spark_id = COMPILED_SPRITE_WHITE_SPARK_0; break;
+                        case 1: spark_id = COMPILED_SPRITE_WHITE_SPARK_1; break;
+                        default: spark_id = COMPILED_SPRITE_WHITE_SPARK_2; break;
                     }
                 }
 
-                if (spark_ptr != NULL) {
-                    blit_sprite_16x16_masked((uint16_t)pixel_x, (uint16_t)pixel_y, spark_ptr);
+                if (spark_id != COMPILED_SPRITE_NONE) {
+                    blit_compiled_sprite(spark_id, (uint16_t)pixel_x, (uint16_t)pixel_y);
                 }
             }
 
@@ -1048,18 +834,52 @@ void handle_enemies(void)
             if (enemy->state == 7 || enemy->state == 13) {
                 /* Death animation complete, despawn */
                 enemy->state = ENEMY_STATE_DESPAWNED;
-                enemy->spawn_timer_and_animation = enemy_respawn_counter_cycle;
+                enemy->spawn_timer_and_animation = GAME->enemy_respawn_counter_cycle;
 
                 /* Cycle respawn counter: 20→40→60→80→100→20 */
-                enemy_respawn_counter_cycle += 20;
-                if (enemy_respawn_counter_cycle > 100) {
-                    enemy_respawn_counter_cycle = 20;
+                GAME->enemy_respawn_counter_cycle += 20;
+                if (GAME->enemy_respawn_counter_cycle > 100) {
+                    GAME->enemy_respawn_counter_cycle = 20;
                 }
             }
         }
     }
 }
 
+/*
+ * render_actors - Draw the live enemies and fireballs without moving them
+ */
+void render_actors(void)
+{
+    int i;
+    int16_t rel_x;
+    uint8_t sprite_id;
+
+    for (i = 0; i < MAX_NUM_ENEMIES; i++) {
+        const enemy_t *enemy = &GAME->enemies[i];
+
+        if (enemy->state == ENEMY_STATE_SPAWNED) {
+            rel_x = (int16_t)((int)enemy->x - (int)GAME->camera_x);
+            render_enemy_sprite(enemy, GAME->enemy_shp_index[i], rel_x, (int16_t)((enemy->y * 8) + 8));
+        }
+    }
+
+    for (i = 0; i < GAME->comic_firepower && i < MAX_NUM_FIREBALLS; i++) {
+        if (GAME->fireballs[i].x == FIREBALL_DEAD && GAME->fireballs[i].y == FIREBALL_DEAD) {
+            continue;
+        }
+        rel_x = (int16_t)((int)GAME->fireballs[i].x - (int)GAME->camera_x);
+        if (rel_x < 0 || rel_x > PLAYFIELD_WIDTH - 2) {
+            continue;
+        }
+        sprite_id = (GAME->fireballs[i].animation == 0)
+            ? COMPILED_SPRITE_FIREBALL_0
+            : COMPILED_SPRITE_FIREBALL_1;
+        blit_compiled_sprite(sprite_id, (uint16_t)((rel_x * 8) + 8),
+                             (uint16_t)((GAME->fireballs[i].y * 8) + 8));
+    }
+}
+
 /* ===== Enemy AI Behaviors ===== */
 
 /*
@@ -1085,11 +905,11 @@ void enemy_behavior_bounce(enemy_t *enemy)
         /* Moving right */
         enemy->facing = COMIC_FACING_RIGHT;
         next_x = (uint8_t)(enemy->x + 2);
-        if (check_horizontal_enemy_map_collision(next_x, enemy->y)) {
+        if (solid_span_y(next_x, enemy->y)) {
             enemy->x_vel = -1;
         } else {
             enemy->x = (uint8_t)(enemy->x + 1);
-            camera_rel_x = (int16_t)enemy->x - (int16_t)camera_x;
+            camera_rel_x = (int16_t)enemy->x - (int16_t)GAME->camera_x;
             if (camera_rel_x >= PLAYFIELD_WIDTH - 2) {
                 enemy->x_vel = -1;
             }
@@ -1101,11 +921,11 @@ void enemy_behavior_bounce(enemy_t *enemy)
             enemy->x_vel = 1;
         } else {
             next_x = (uint8_t)(enemy->x - 1);
-            if (check_horizontal_enemy_map_collision(next_x, enemy->y)) {
+            if (solid_span_y(next_x, enemy->y)) {
                 enemy->x_vel = 1;
             } else {
                 enemy->x = next_x;
-                camera_rel_x = (int16_t)enemy->x - (int16_t)camera_x;
+                camera_rel_x = (int16_t)enemy->x - (int16_t)GAME->camera_x;
                 if (camera_rel_x <= 0) {
                     enemy->x_vel = 1;
                 }
@@ -1120,7 +940,7 @@ void enemy_behavior_bounce(enemy_t *enemy)
             enemy->y_vel = -1;
         } else {
             next_y = (uint8_t)(enemy->y + 2);
-            if (check_vertical_enemy_map_collision(enemy->x, next_y)) {
+            if (solid_span_x(enemy->x, next_y)) {
                 enemy->y_vel = -1;
             } else {
                 enemy->y = (uint8_t)(enemy->y + 1);
@@ -1135,7 +955,7 @@ void enemy_behavior_bounce(enemy_t *enemy)
             enemy->y_vel = 1;
         } else {
             next_y = (uint8_t)(enemy->y - 1);
-            if (check_vertical_enemy_map_collision(enemy->x, next_y)) {
+            if (solid_span_x(enemy->x, next_y)) {
                 enemy->y_vel = 1;
             } else {
                 enemy->y = next_y;
@@ -1175,7 +995,7 @@ void enemy_behavior_leap(enemy_t *enemy)
             proposed_y = 0;
         } else {
             /* Check collision */
-            collision = check_vertical_enemy_map_collision(enemy->x, proposed_y);
+            collision = solid_span_x(enemy->x, proposed_y);
             if (collision) {
                 /* Hit ceiling - undo the position change but preserve y_vel; gravity will reduce upward speed */
             } else {
@@ -1191,7 +1011,7 @@ void enemy_behavior_leap(enemy_t *enemy)
         
         /* Check bottom edge */
         if (proposed_y >= PLAYFIELD_HEIGHT - 2) {
-            debug_log("LEAP moving_down: fell off bottom -> despawn (y=%u)\n", (unsigned)proposed_y);
+            LOG_INFO(LEAP_FELL_OFF_BOTTOM, proposed_y, 0, 0);
             /* Fell off bottom - despawn */
             enemy->state = ENEMY_STATE_WHITE_SPARK + 5;
             enemy->y = PLAYFIELD_HEIGHT - 2;
@@ -1199,7 +1019,7 @@ void enemy_behavior_leap(enemy_t *enemy)
         }
         
         /* Check collision with ground below */
-        collision = check_vertical_enemy_map_collision(enemy->x, (uint8_t)(proposed_y + 1));
+        collision = solid_span_x(enemy->x, (uint8_t)(proposed_y + 1));
         if (collision) {
             /* Collision detected when moving down: undo position change (keep current y)
              * and allow gravity to act on subsequent ticks. */
@@ -1209,7 +1029,7 @@ void enemy_behavior_leap(enemy_t *enemy)
         }
     } else {
         /* y_vel == 0 - check if on ground */
-        collision = check_vertical_enemy_map_collision(enemy->x, (uint8_t)(enemy->y + 2));
+        collision = solid_span_x(enemy->x, (uint8_t)(enemy->y + 2));
         if (collision) {
             /* On ground - initiate jump
          * NOTE: increase initial upward impulse so the peak reaches ~6 game units
@@ -1219,7 +1039,7 @@ void enemy_behavior_leap(enemy_t *enemy)
             just_jumped = 1; /* assembly does not apply gravity on the same tick */
 
             /* Set horizontal velocity toward Comic */
-            if (enemy->x < comic_x) {
+            if (enemy->x < GAME->comic_x) {
                 enemy->x_vel = 1;
             } else {
                 enemy->x_vel = -1;
@@ -1258,7 +1078,7 @@ void enemy_behavior_leap(enemy_t *enemy)
     if (enemy->x_vel > 0) {
         /* Moving right */
         next_x = (uint8_t)(enemy->x + 2);
-        collision = check_horizontal_enemy_map_collision(next_x, proposed_y);
+        collision = solid_span_y(next_x, proposed_y);
         if (collision) {
             /* Hit wall - bounce left */
             enemy->x_vel = -1;
@@ -1266,7 +1086,7 @@ void enemy_behavior_leap(enemy_t *enemy)
             enemy->x = (uint8_t)(enemy->x + 1);
             
             /* Check playfield right edge */
-            camera_rel_x = (int16_t)enemy->x - (int16_t)camera_x;
+            camera_rel_x = (int16_t)enemy->x - (int16_t)GAME->camera_x;
             if (camera_rel_x >= PLAYFIELD_WIDTH - 2) {
                 enemy->x_vel = -1;
             } else {
@@ -1279,14 +1099,14 @@ void enemy_behavior_leap(enemy_t *enemy)
             enemy->x_vel = 1;
         } else {
             next_x = (uint8_t)(enemy->x - 1);
-            collision = check_horizontal_enemy_map_collision(next_x, proposed_y);
+            collision = solid_span_y(next_x, proposed_y);
             if (collision) {
                 enemy->x_vel = 1;
             } else {
                 enemy->x = next_x;
 
                 /* Check playfield left edge */
-                camera_rel_x = (int16_t)enemy->x - (int16_t)camera_x;
+                camera_rel_x = (int16_t)enemy->x - (int16_t)GAME->camera_x;
                 if (camera_rel_x <= 0) {
                     enemy->x_vel = 1;
                 } else {
@@ -1298,7 +1118,7 @@ void enemy_behavior_leap(enemy_t *enemy)
 
     /* Check for ground after movement */
     if (enemy->y_vel > 0) {
-        collision = check_vertical_enemy_map_collision(enemy->x, (uint8_t)(proposed_y + 3));
+        collision = solid_span_x(enemy->x, (uint8_t)(proposed_y + 3));
         if (collision) {
             /* Landed on ground.
              * Align the committed Y so that (enemy->y + 2) points at the same
@@ -1342,9 +1162,9 @@ void enemy_behavior_roll(enemy_t *enemy)
     }
     
     /* Rolling - set direction toward Comic */
-    if (enemy->x < comic_x) {
+    if (enemy->x < GAME->comic_x) {
         enemy->x_vel = 1;
-    } else if (enemy->x > comic_x) {
+    } else if (enemy->x > GAME->comic_x) {
         enemy->x_vel = -1;
     } else {
         enemy->x_vel = 0;
@@ -1371,19 +1191,19 @@ horizontal_movement:
     if (enemy->x_vel > 0) {
         /* Moving right */
         next_x = (uint8_t)(enemy->x + 2);
-        if (!check_horizontal_enemy_map_collision(next_x, enemy->y)) {
+        if (!solid_span_y(next_x, enemy->y)) {
             enemy->x = (uint8_t)(enemy->x + 1);
         }
     } else {
         /* Moving left */
         next_x = (uint8_t)(enemy->x - 1);
-        if (!check_horizontal_enemy_map_collision(next_x, enemy->y)) {
+        if (!solid_span_y(next_x, enemy->y)) {
             enemy->x = next_x;
         }
     }
     
     /* Check for ground below */
-    if (!check_vertical_enemy_map_collision(enemy->x, (uint8_t)(enemy->y + 3))) {
+    if (!solid_span_x(enemy->x, (uint8_t)(enemy->y + 3))) {
         /* No ground - start falling */
         enemy->y_vel = 1;
         return;
@@ -1422,16 +1242,16 @@ void enemy_behavior_seek(enemy_t *enemy)
     }
 
     /* --- Horizontal movement toward Comic (preferred) --- */
-    if (enemy->x != comic_x) {
-        if (enemy->x < comic_x) {
+    if (enemy->x != GAME->comic_x) {
+        if (enemy->x < GAME->comic_x) {
             /* Attempt step right (check ahead at x+2 like other handlers) */
             next_x = (uint8_t)(enemy->x + 1);
-            hcollision = check_horizontal_enemy_map_collision((uint8_t)(next_x + 1), enemy->y);
+            hcollision = solid_span_y((uint8_t)(next_x + 1), enemy->y);
 
             if (!hcollision) {
                 enemy->x = next_x;
                 enemy->x_vel = 1;
-                camera_rel_x = (int16_t)enemy->x - (int16_t)camera_x;
+                camera_rel_x = (int16_t)enemy->x - (int16_t)GAME->camera_x;
                 if (camera_rel_x >= PLAYFIELD_WIDTH - 2) {
                     /* Hit right playfield edge — reverse like other AIs */
                     enemy->x_vel = -1;
@@ -1445,12 +1265,12 @@ void enemy_behavior_seek(enemy_t *enemy)
         } else {
             /* Attempt step left */
             next_x = (uint8_t)(enemy->x - 1);
-            hcollision = check_horizontal_enemy_map_collision((uint8_t)(next_x - 1), enemy->y);
+            hcollision = solid_span_y((uint8_t)(next_x - 1), enemy->y);
 
             if (!hcollision) {
                 enemy->x = next_x;
                 enemy->x_vel = -1;
-                camera_rel_x = (int16_t)next_x - (int16_t)camera_x;
+                camera_rel_x = (int16_t)next_x - (int16_t)GAME->camera_x;
                 if (camera_rel_x <= 0) {
                     /* Hit left playfield edge — reverse */
                     enemy->x_vel = 1;
@@ -1467,8 +1287,8 @@ void enemy_behavior_seek(enemy_t *enemy)
     }
 
     /* --- Vertical fallback when horizontal movement is blocked or aligned --- */
-    if (enemy->y != comic_y) {
-        if (enemy->y < comic_y) {
+    if (enemy->y != GAME->comic_y) {
+        if (enemy->y < GAME->comic_y) {
             /* Move down */
             next_y = (uint8_t)(enemy->y + 1);
 
@@ -1479,7 +1299,7 @@ void enemy_behavior_seek(enemy_t *enemy)
                 return;
             }
 
-            vcollision = check_vertical_enemy_map_collision(enemy->x, (uint8_t)(next_y + 1));
+            vcollision = solid_span_x(enemy->x, (uint8_t)(next_y + 1));
 
             if (!vcollision) {
                 enemy->y = next_y;
@@ -1493,7 +1313,7 @@ void enemy_behavior_seek(enemy_t *enemy)
                 /* Bounce off top like other AIs */
                 /* leave y as-is */
             } else {
-                vcollision = check_vertical_enemy_map_collision(enemy->x, next_y);
+                vcollision = solid_span_x(enemy->x, next_y);
                 if (!vcollision) {
                     enemy->y = next_y;
                 }
@@ -1535,9 +1355,9 @@ void enemy_behavior_shy(enemy_t *enemy)
     }
     
     /* Determine if Comic is facing this enemy */
-    if (comic_facing == COMIC_FACING_RIGHT && enemy->x > comic_x) {
+    if (GAME->comic_facing == COMIC_FACING_RIGHT && enemy->x > GAME->comic_x) {
         comic_facing_enemy = 1; /* Comic facing enemy on right */
-    } else if (comic_facing == COMIC_FACING_LEFT && enemy->x < comic_x) {
+    } else if (GAME->comic_facing == COMIC_FACING_LEFT && enemy->x < GAME->comic_x) {
         comic_facing_enemy = 1; /* Comic facing enemy on left */
     } else {
         comic_facing_enemy = 0; /* Comic facing away */
@@ -1549,9 +1369,9 @@ void enemy_behavior_shy(enemy_t *enemy)
         enemy->y_vel = -1;
     } else {
         /* Move toward Comic's Y position */
-        if (enemy->y < comic_y) {
+        if (enemy->y < GAME->comic_y) {
             enemy->y_vel = 1;
-        } else if (enemy->y > comic_y) {
+        } else if (enemy->y > GAME->comic_y) {
             enemy->y_vel = -1;
         } else {
             enemy->y_vel = 0;
@@ -1569,7 +1389,7 @@ void enemy_behavior_shy(enemy_t *enemy)
         /* Check vertical tiles (consider enemy width when x is odd) */
         vcollision = 0;
         if (enemy->y_vel > 0) {
-            vcollision = check_vertical_enemy_map_collision(enemy->x, (uint8_t)(next_y + 1));
+            vcollision = solid_span_x(enemy->x, (uint8_t)(next_y + 1));
             if (!vcollision) {
                 enemy->y = next_y;
             } else {
@@ -1577,7 +1397,7 @@ void enemy_behavior_shy(enemy_t *enemy)
                 enemy->y_vel = -1;
             }
         } else if (enemy->y_vel < 0) {
-            vcollision = check_vertical_enemy_map_collision(enemy->x, next_y);
+            vcollision = solid_span_x(enemy->x, next_y);
             if (!vcollision) {
                 enemy->y = next_y;
             } else {
@@ -1591,12 +1411,12 @@ void enemy_behavior_shy(enemy_t *enemy)
     if (enemy->x_vel > 0) {
         /* Moving right */
         next_x = (uint8_t)(enemy->x + 1);
-        hcollision = check_horizontal_enemy_map_collision((uint8_t)(next_x + 1), enemy->y);
+        hcollision = solid_span_y((uint8_t)(next_x + 1), enemy->y);
         if (hcollision) {
             enemy->x_vel = -1;
         } else {
             /* Check playfield right edge relative to camera */
-            camera_rel_x = (int16_t)next_x - (int16_t)camera_x;
+            camera_rel_x = (int16_t)next_x - (int16_t)GAME->camera_x;
             if (camera_rel_x >= PLAYFIELD_WIDTH - 2) {
                 enemy->x_vel = -1;
             } else {
@@ -1609,11 +1429,11 @@ void enemy_behavior_shy(enemy_t *enemy)
             enemy->x_vel = 1;
         } else {
             next_x = (uint8_t)(enemy->x - 1);
-            hcollision = check_horizontal_enemy_map_collision(next_x - 1, enemy->y);
+            hcollision = solid_span_y((uint8_t)(next_x - 1), enemy->y);
             if (hcollision) {
                 enemy->x_vel = 1;
             } else {
-                camera_rel_x = (int16_t)next_x - (int16_t)camera_x;
+                camera_rel_x = (int16_t)next_x - (int16_t)GAME->camera_x;
                 if (camera_rel_x <= 0) {
                     enemy->x_vel = 1;
                 } else {
@@ -0,0 +1,233 @@
+/*
+ * dirty_rects.c - Per-page dirty rectangle tracking for the playfield
+ *
+ * Every tick the game loop restores the playfield of the offscreen page from
+ * RENDERED_MAP_BUFFER before drawing Comic, enemies, fireballs and items on
+ * top. When the camera has not scrolled since that page was last refreshed,
+ * only the regions that sprites were drawn over can differ from the map, so
+ * only those are copied back.
+ *
+ * Gameplay sprites are drawn into the offscreen page only and are recorded
+ * against that page; UI blits drawn into both pages lie outside the
+ * playfield and are clipped away. A page's list is cleared when that page is refreshed. Any
+ * change to the rendered map or a fullscreen load into a page invalidates
+ * tracking, and the next refresh of each page falls back to a full copy.
+ */
+
+#include <stdint.h>
+#include "globals.h"
+#include "graphics.h"
+#include "dirty_rects.h"
+
+/* Playfield bounds within a page, in bytes (x) and pixel rows (y) */
+#define PLAYFIELD_LEFT_BYTE   1
+#define PLAYFIELD_TOP_ROW     8
+#define PLAYFIELD_RIGHT_BYTE  (PLAYFIELD_LEFT_BYTE + PLAYFIELD_WIDTH)     /* exclusive */
+#define PLAYFIELD_BOTTOM_ROW  (PLAYFIELD_TOP_ROW + PLAYFIELD_HEIGHT * 8)  /* exclusive */
+
+#define SCREEN_BYTES_PER_ROW  (SCREEN_WIDTH / 8)
+#define RENDERED_MAP_STRIDE   256
+#define GAMEPLAY_PAGE_SIZE    0x2000
+
+/* Marks the page as having no valid full refresh */
+#define CAMERA_X_INVALID      0xffff
+
+typedef struct {
+    uint8_t x;      /* Left edge, bytes from start of row */
+    uint8_t y;      /* Top edge, pixel row */
+    uint8_t width;  /* Bytes */
+    uint8_t rows;   /* Pixel rows */
+} dirty_rect_t;
+
+typedef struct {
+    uint16_t camera_x;     /* camera_x at last full refresh, or CAMERA_X_INVALID */
+    uint8_t num_rects;
+    uint8_t overflowed;    /* 1 if more rects were marked than fit */
+    dirty_rect_t rects[DIRTY_RECTS_MAX_PER_PAGE];
+} dirty_page_t;
+
+static dirty_page_t dirty_pages[2] = {
+    { CAMERA_X_INVALID, 0, 0, { { 0, 0, 0, 0 } } },
+    { CAMERA_X_INVALID, 0, 0, { { 0, 0, 0, 0 } } }
+};
+
+/*
+ * page_index_for_offset - Map a video offset to gameplay page 0 (A) or 1 (B)
+ *
+ * Returns:
+ *   0 or 1, or -1 if the offset is not inside a gameplay page
+ */
+static int8_t page_index_for_offset(uint16_t video_offset)
+{
+    if (video_offset < GRAPHICS_BUFFER_GAMEPLAY_A + GAMEPLAY_PAGE_SIZE) {
+        return 0;
+    }
+    if (video_offset >= GRAPHICS_BUFFER_GAMEPLAY_B &&
+        video_offset < GRAPHICS_BUFFER_GAMEPLAY_B + GAMEPLAY_PAGE_SIZE) {
+        return 1;
+    }
+    return -1;
+}
+
+/*
+ * mark_page - Clip a rectangle to the playfield and add it to a page's list
+ *
+ * Parameters:
+ *   page        - Page index (0 or 1)
+ *   page_offset - Top-left offset relative to the page start
+ *   width_bytes - Width in bytes
+ *   rows        - Height in pixel rows
+ */
+static void mark_page(uint8_t page, uint16_t page_offset, uint8_t width_bytes, uint8_t rows)
+{
+    dirty_page_t *dp = &dirty_pages[page];
+    uint16_t left = page_offset % SCREEN_BYTES_PER_ROW;
+    uint16_t top = page_offset / SCREEN_BYTES_PER_ROW;
+    uint16_t right = left + width_bytes;
+    uint16_t bottom = top + rows;
+    dirty_rect_t *r;
+
+    /* Nothing to restore if the page has no valid base image anyway */
+    if (dp->camera_x == CAMERA_X_INVALID || dp->overflowed) {
+        return;
+    }
+
+    /* Clip to the playfield; UI and border blits are never restored */
+    if (left < PLAYFIELD_LEFT_BYTE) {
+        left = PLAYFIELD_LEFT_BYTE;
+    }
+    if (top < PLAYFIELD_TOP_ROW) {
+        top = PLAYFIELD_TOP_ROW;
+    }
+    if (right > PLAYFIELD_RIGHT_BYTE) {
+        right = PLAYFIELD_RIGHT_BYTE;
+    }
+    if (bottom > PLAYFIELD_BOTTOM_ROW) {
+        bottom = PLAYFIELD_BOTTOM_ROW;
+    }
+    if (left >= right || top >= bottom) {
+        return;
+    }
+
+    if (dp->num_rects >= DIRTY_RECTS_MAX_PER_PAGE) {
+        dp->overflowed = 1;
+        return;
+    }
+
+    r = &dp->rects[dp->num_rects++];
+    r->x = (uint8_t)left;
+    r->y = (uint8_t)top;
+    r->width = (uint8_t)(right - left);
+    r->rows = (uint8_t)(bottom - top);
+}
+
+/*
+ * dirty_rects_mark_offset - Record a rectangle drawn into one gameplay page
+ *
+ * Parameters:
+ *   video_offset - Absolute top-left offset in segment 0xa000
+ *   width_bytes  - Width in bytes
+ *   rows         - Height in pixel rows
+ */
+void dirty_rects_mark_offset(uint16_t video_offset, uint8_t width_bytes, uint8_t rows)
+{
+    int8_t page = page_index_for_offset(video_offset);
+
+    if (page < 0) {
+        return;
+    }
+    mark_page((uint8_t)page, video_offset & (GAMEPLAY_PAGE_SIZE - 1), width_bytes, rows);
+}
+
+/*
+ * dirty_rects_mark_both_pages - Record a rectangle drawn into both pages
+ *
+ * Parameters:
+ *   page_offset - Top-left offset relative to the page start
+ *   width_bytes - Width in bytes
+ *   rows        - Height in pixel rows
+ */
+void dirty_rects_mark_both_pages(uint16_t page_offset, uint8_t width_bytes, uint8_t rows)
+{
+    mark_page(0, page_offset, width_bytes, rows);
+    mark_page(1, page_offset, width_bytes, rows);
+}
+
+/*
+ * dirty_rects_invalidate - Force the next refresh of both pages to be full
+ *
+ * Called whenever RENDERED_MAP_BUFFER is re-rendered or a page is
+ * overwritten by something other than the tracked blitters.
+ */
+void dirty_rects_invalidate(void)
+{
+    uint8_t page;
+
+    for (page = 0; page < 2; page++) {
+        dirty_pages[page].camera_x = CAMERA_X_INVALID;
+        dirty_pages[page].num_rects = 0;
+        dirty_pages[page].overflowed = 0;
+    }
+}
+
+/*
+ * dirty_rects_restore_playfield - Restore only the dirty parts of a page
+ *
+ * Copies each recorded rectangle back from RENDERED_MAP_BUFFER using the
+ * latched copy, then clears the page's list.
+ *
+ * Parameters:
+ *   page     - Page offset (GRAPHICS_BUFFER_GAMEPLAY_A or _B)
+ *   camera_x - Current camera position in game units
+ *
+ * Returns:
+ *   1 if the page is now up to date, 0 if the caller must do a full copy
+ *   (camera scrolled, tracking invalidated, or the list overflowed)
+ */
+uint8_t dirty_rects_restore_playfield(uint16_t page, uint16_t camera_x)
+{
+    int8_t index = page_index_for_offset(page);
+    dirty_page_t *dp;
+    uint8_t i;
+
+    if (index < 0) {
+        return 0;
+    }
+    dp = &dirty_pages[index];
+
+    if (dp->camera_x != camera_x || dp->overflowed) {
+        return 0;
+    }
+
+    for (i = 0; i < dp->num_rects; i++) {
+        const dirty_rect_t *r = &dp->rects[i];
+        uint16_t src = RENDERED_MAP_BUFFER + camera_x +
+                       (uint16_t)(r->y - PLAYFIELD_TOP_ROW) * RENDERED_MAP_STRIDE +
+                       (r->x - PLAYFIELD_LEFT_BYTE);
+        uint16_t dst = page + (uint16_t)r->y * SCREEN_BYTES_PER_ROW + r->x;
+
+        copy_ega_latched(src, RENDERED_MAP_STRIDE, dst, SCREEN_BYTES_PER_ROW,
+                         r->width, r->rows);
+    }
+    dp->num_rects = 0;
+    return 1;
+}
+
+/*
+ * dirty_rects_playfield_refreshed - Record a full refresh of a page
+ *
+ * Parameters:
+ *   page     - Page offset (GRAPHICS_BUFFER_GAMEPLAY_A or _B)
+ *   camera_x - Camera position the page was refreshed at
+ */
+void dirty_rects_playfield_refreshed(uint16_t page, uint16_t camera_x)
+{
+    int8_t index = page_index_for_offset(page);
+
+    if (index < 0) {
+        return;
+    }
+    dirty_pages[index].camera_x = camera_x;
+    dirty_pages[index].num_rects = 0;
+    dirty_pages[index].overflowed = 0;
+}
@@ -13,23 +13,16 @@
 #include "level_data.h"
 #include "sound.h"
 #include "sound_data.h"
+#include "dirty_rects.h"
+#include "vram.h"
+#include "game_state.h"
+#include "trace.h"
 
 /* Video memory segment (SCREEN_WIDTH is defined in globals.h) */
 #define VIDEO_MEMORY_BASE 0xa000
 #define PLAYFIELD_OFFSET_X 8
 #define PLAYFIELD_OFFSET_Y 8
 
-/* External game state variables from game_main.c */
-extern uint8_t comic_x;
-extern uint8_t comic_y;
-extern uint8_t comic_has_door_key;
-extern uint8_t key_state_open;
-extern uint8_t current_level_number;
-extern uint8_t current_stage_number;
-extern const level_t *current_level_ptr;
-extern int8_t source_door_level_number;
-extern int8_t source_door_stage_number;
-
 /* Forward declarations for functions in game_main.c */
 int load_new_level(void);
 void load_new_stage(void);
@@ -37,10 +30,7 @@ extern void wait_n_ticks(uint16_t ticks);
 extern void swap_video_buffers(void);
 extern void blit_map_playfield_offscreen(void);
 extern void blit_comic_playfield_offscreen(void);
-extern uint16_t camera_x;
 extern uint16_t offscreen_video_buffer_ptr;
-extern level_t current_level;
-extern uint8_t tileset_graphics[];
 
 /**
  * Helper functions for door rendering
@@ -60,21 +50,24 @@ static void blank_door_offscreen(void)
     uint16_t row;
     uint8_t plane;
     
+    /* Restore the door area from the map on this page's next refresh */
+    dirty_rects_mark_offset(offscreen_video_buffer_ptr + door_blit_offset, 4, 32);
+    
     /* For each EGA plane */
     for (plane = 1; plane <= 8; plane <<= 1) {
         /* Set up EGA plane mask */
-        outp(0x3C4, 0x02);  /* SC Index: Map Mask */
-        outp(0x3C5, plane); /* SC Data: plane mask */
+        VRAM_OUTP(0x3C4, 0x02);  /* SC Index: Map Mask */
+        VRAM_OUTP(0x3C5, plane); /* SC Data: plane mask */
         
         /* Point to door location in offscreen buffer */
         video_mem = MK_FP(VIDEO_MEMORY_BASE, door_blit_offset + offscreen_video_buffer_ptr);
         
         /* Fill 32 rows × 4 bytes (32 pixels wide) with zeros */
         for (row = 0; row < 32; row++) {
-            video_mem[0] = 0;
-            video_mem[1] = 0;
-            video_mem[2] = 0;
-            video_mem[3] = 0;
+            VRAM_WRITE(video_mem, 0);
+            VRAM_WRITE(video_mem + 1, 0);
+            VRAM_WRITE(video_mem + 2, 0);
+            VRAM_WRITE(video_mem + 3, 0);
             video_mem += SCREEN_WIDTH / 8;  /* Next row */
         }
     }
@@ -89,55 +82,55 @@ static void blank_door_offscreen(void)
  */
 static void blit_door_halfopen_offscreen(void)
 {
-    uint8_t door_tile_ul = current_level.door_tile_ul;
-    uint8_t door_tile_ur = current_level.door_tile_ur;
-    uint8_t door_tile_ll = current_level.door_tile_ll;
-    uint8_t door_tile_lr = current_level.door_tile_lr;
+    uint8_t door_tile_ul = GAME->current_level.door_tile_ul;
+    uint8_t door_tile_ur = GAME->current_level.door_tile_ur;
+    uint8_t door_tile_ll = GAME->current_level.door_tile_ll;
+    uint8_t door_tile_lr = GAME->current_level.door_tile_lr;
     const uint8_t *tile_graphic;
     uint8_t __far *video_mem;
     uint16_t row;
     uint8_t plane;
-    uint16_t tile_offset;
+    uint8_t plane_index;
+    
+    /* Each tile plane is 16 rows of 2 bytes; see TILESET_ROW_OFFSET */
     
-    /* Each tile is 128 bytes (16×16 pixels = 2 bytes/row × 16 rows × 4 planes) */
+    dirty_rects_mark_offset(offscreen_video_buffer_ptr + door_blit_offset, 4, 32);
     
     /* For each EGA plane */
-    for (plane = 1; plane <= 8; plane <<= 1) {
+    for (plane = 1, plane_index = 0; plane <= 8; plane <<= 1, plane_index++) {
         /* Set up EGA plane mask */
-        outp(0x3C4, 0x02);  /* SC Index: Map Mask */
-        outp(0x3C5, plane); /* SC Data: plane mask */
+        VRAM_OUTP(0x3C4, 0x02);  /* SC Index: Map Mask */
+        VRAM_OUTP(0x3C5, plane); /* SC Data: plane mask */
         
         /* Upper-left tile: draw right half only */
-        tile_graphic = &tileset_graphics[door_tile_ul * 128];
+        tile_graphic = &GAME->tileset_graphics[TILESET_ROW_OFFSET(door_tile_ul, plane_index, 0)];
         video_mem = MK_FP(VIDEO_MEMORY_BASE, door_blit_offset + offscreen_video_buffer_ptr);
-        /* Skip to the plane data for this plane (32 bytes per plane) */
-        tile_offset = ((plane == 1) ? 0 : (plane == 2) ? 32 : (plane == 4) ? 64 : 96);
         for (row = 0; row < 16; row++) {
-            video_mem[0] = tile_graphic[tile_offset + row * 2 + 1];  /* Right byte */
+            VRAM_WRITE(video_mem, tile_graphic[row * 2 + 1]);  /* Right byte */
             video_mem += SCREEN_WIDTH / 8;
         }
         
         /* Upper-right tile: draw left half only */
-        tile_graphic = &tileset_graphics[door_tile_ur * 128];
+        tile_graphic = &GAME->tileset_graphics[TILESET_ROW_OFFSET(door_tile_ur, plane_index, 0)];
         video_mem = MK_FP(VIDEO_MEMORY_BASE, door_blit_offset + offscreen_video_buffer_ptr + 3);
         for (row = 0; row < 16; row++) {
-            video_mem[0] = tile_graphic[tile_offset + row * 2];  /* Left byte */
+            VRAM_WRITE(video_mem, tile_graphic[row * 2]);  /* Left byte */
             video_mem += SCREEN_WIDTH / 8;
         }
         
         /* Lower-left tile: draw right half only */
-        tile_graphic = &tileset_graphics[door_tile_ll * 128];
+        tile_graphic = &GAME->tileset_graphics[TILESET_ROW_OFFSET(door_tile_ll, plane_index, 0)];
         video_mem = MK_FP(VIDEO_MEMORY_BASE, door_blit_offset + offscreen_video_buffer_ptr + 16 * (SCREEN_WIDTH / 8));
         for (row = 0; row < 16; row++) {
-            video_mem[0] = tile_graphic[tile_offset + row * 2 + 1];  /* Right byte */
+            VRAM_WRITE(video_mem, tile_graphic[row * 2 + 1]);  /* Right byte */
             video_mem += SCREEN_WIDTH / 8;
         }
         
         /* Lower-right tile: draw left half only */
-        tile_graphic = &tileset_graphics[door_tile_lr * 128];
+        tile_graphic = &GAME->tileset_graphics[TILESET_ROW_OFFSET(door_tile_lr, plane_index, 0)];
         video_mem = MK_FP(VIDEO_MEMORY_BASE, door_blit_offset + offscreen_video_buffer_ptr + 16 * (SCREEN_WIDTH / 8) + 3);
         for (row = 0; row < 16; row++) {
-            video_mem[0] = tile_graphic[tile_offset + row * 2];  /* Left byte */
+            VRAM_WRITE(video_mem, tile_graphic[row * 2]);  /* Left byte */
             video_mem += SCREEN_WIDTH / 8;
         }
     }
@@ -167,7 +160,7 @@ static void enter_door(uint8_t door_x, uint8_t door_y)
     uint16_t pixel_offset;
     
     /* Calculate camera-relative position and pixel offset for door */
-    camera_relative_x = door_x - camera_x;
+    camera_relative_x = door_x - GAME->camera_x;
     
     /* Convert game coordinates to pixel offset in video memory
      * door_y and camera_relative_x are in game units (8 pixels each)
@@ -177,6 +170,8 @@ static void enter_door(uint8_t door_x, uint8_t door_y)
                    (PLAYFIELD_OFFSET_X / 8) + camera_relative_x;
     door_blit_offset = pixel_offset;
     
+    TRACE_BEGIN(ENTER_DOOR, door_x);
+
     /* Play door sound */
     play_sound(SOUND_DOOR, 4);
     
@@ -203,6 +198,7 @@ static void enter_door(uint8_t door_x, uint8_t door_y)
     /* Frame 4: Door fully closed */
     blit_map_playfield_offscreen();
     wait_1_tick_and_swap();
+    TRACE_END(ENTER_DOOR);
 }
 
 /**
@@ -225,14 +221,16 @@ void exit_door_animation(void)
     /* Calculate camera-relative position and pixel offset for door
      * Comic is at door position (having just arrived through it)
      * door.x = comic_x - 1 (both in game units) */
-    camera_relative_x = comic_x - 1 - camera_x;
+    camera_relative_x = GAME->comic_x - 1 - GAME->camera_x;
     
     /* Convert game coordinates to pixel offset in video memory
      * comic_x and comic_y are in game units (8 pixels each) */
-    pixel_offset = (PLAYFIELD_OFFSET_Y + comic_y * 8) * (SCREEN_WIDTH / 8) + 
+    pixel_offset = (PLAYFIELD_OFFSET_Y + GAME->comic_y * 8) * (SCREEN_WIDTH / 8) + 
                    (PLAYFIELD_OFFSET_X / 8) + camera_relative_x;
     door_blit_offset = pixel_offset;
     
+    TRACE_BEGIN(EXIT_DOOR, GAME->comic_x - 1);
+
     /* Assembly waits 3 ticks before starting door SFX/animation. */
     wait_n_ticks(3);
 
@@ -269,6 +267,7 @@ void exit_door_animation(void)
     blit_map_playfield_offscreen();
     blit_comic_playfield_offscreen();
     wait_1_tick_and_swap();
+    TRACE_END(EXIT_DOOR);
 }
 
 /**
@@ -307,18 +306,18 @@ uint8_t check_door_activation(void)
     /* Note: Caller ensures key_state_open == 1 before calling this function */
     
     /* Get current stage data */
-    if (current_level_ptr == NULL) {
+    if (GAME->current_level_ptr == NULL) {
         return 0;  /* No level loaded */
     }
     
     /* Validate stage number is within bounds (0-2) */
-    if (current_stage_number >= 3) {
+    if (GAME->current_stage_number >= 3) {
         return 0;  /* Invalid stage number */
     }
     
     /* Check all doors in the current stage */
     for (i = 0; i < 3; i++) {  /* MAX_NUM_DOORS */
-        door = &current_level_ptr->stages[current_stage_number].doors[i];
+        door = &GAME->current_level_ptr->stages[GAME->current_stage_number].doors[i];
         
         /* Door is unused if x or y is 0xff */
         if (door->x == DOOR_UNUSED || door->y == DOOR_UNUSED) {
@@ -327,20 +326,20 @@ uint8_t check_door_activation(void)
         
         /* Check Y coordinate: must be exact match
          * Both comic_y and door.y are in game units (same coordinate system) */
-        if (comic_y != door->y) {
+        if (GAME->comic_y != door->y) {
             continue;
         }
         
         /* Check X coordinate: must be within 3 units
          * Both comic_x and door.x are in game units (same coordinate system)
          * We allow comic_x - door.x to be 0, 1, or 2 */
-        x_offset = comic_x - door->x;
+        x_offset = GAME->comic_x - door->x;
         if (x_offset < 0 || x_offset > 2) {
             continue;
         }
         
         /* Check if player has the Door Key */
-        if (comic_has_door_key != 1) {
+        if (GAME->comic_has_door_key != 1) {
             continue;  /* Door is locked, skip to next door */
         }
         
@@ -397,16 +396,16 @@ void activate_door(const door_t *door)
     
     /* Save the source level and stage so the destination can find the
      * reciprocal door (for proper positioning when exiting) */
-    source_door_level_number = current_level_number;
-    source_door_stage_number = current_stage_number;
+    GAME->source_door_level_number = GAME->current_level_number;
+    GAME->source_door_stage_number = GAME->current_stage_number;
     
     /* Set the current level and stage to the door's target */
-    current_stage_number = door->target_stage;
-    current_level_number = door->target_level;
+    GAME->current_stage_number = door->target_stage;
+    GAME->current_level_number = door->target_level;
     
     /* If the target is in a different level, load the entire level
      * (including tileset, enemy graphics, etc.) */
-    if (door->target_level != source_door_level_number) {
+    if (door->target_level != GAME->source_door_level_number) {
         if (load_new_level() == -1) {
             /* Failed to load level - critical error, cannot proceed */
             return;
@@ -7,6 +7,7 @@
 #include "file_loaders.h"
 #include "globals.h"
 #include "level_data.h"
+#include "game_state.h"
 #include <fcntl.h>
 #include <io.h>
 #include <stdio.h>
@@ -144,9 +145,6 @@ int load_shp_file(const char* filename, void* buffer)
     return 0;
 }
 
-/* Runtime cache for up to 4 SHP files referenced by a level */
-static shp_runtime_t loaded_shps[4] = {0};
-
 /* Open a file with a simple case-insensitive fallback (uppercasing). */
 static int open_file_case_insensitive(const char *filename)
 {
@@ -185,14 +183,14 @@ void free_loaded_shp_files(void)
 {
     int i;
     for (i = 0; i < 4; i++) {
-        if (loaded_shps[i].frames) {
-            free(loaded_shps[i].frames);
-            loaded_shps[i].frames = NULL;
-            loaded_shps[i].num_frames = 0;
-            loaded_shps[i].frame_size = 0;
-            loaded_shps[i].horizontal = 0;
-            loaded_shps[i].animation = 0;
-            loaded_shps[i].num_distinct = 0;
+        if (GAME->loaded_shps[i].frames) {
+            free(GAME->loaded_shps[i].frames);
+            GAME->loaded_shps[i].frames = NULL;
+            GAME->loaded_shps[i].num_frames = 0;
+            GAME->loaded_shps[i].frame_size = 0;
+            GAME->loaded_shps[i].horizontal = 0;
+            GAME->loaded_shps[i].animation = 0;
+            GAME->loaded_shps[i].num_distinct = 0;
         }
     }
 }
@@ -200,34 +198,34 @@ void free_loaded_shp_files(void)
 const uint8_t* shp_get_frame(uint8_t shp_index, uint8_t frame_index)
 {
     if (shp_index >= 4) return NULL;
-    if (loaded_shps[shp_index].frames == NULL) return NULL;
-    if (frame_index >= loaded_shps[shp_index].num_frames) return NULL;
+    if (GAME->loaded_shps[shp_index].frames == NULL) return NULL;
+    if (frame_index >= GAME->loaded_shps[shp_index].num_frames) return NULL;
     /* Cast to unsigned long to avoid overflow: frame_index (0-255) * frame_size (80-320) = 0-81,600 */
-    return (const uint8_t*)(loaded_shps[shp_index].frames + ((unsigned long)frame_index * loaded_shps[shp_index].frame_size));
+    return (const uint8_t*)(GAME->loaded_shps[shp_index].frames + ((unsigned long)frame_index * GAME->loaded_shps[shp_index].frame_size));
 }
 
 uint16_t shp_get_frame_size(uint8_t shp_index)
 {
     if (shp_index >= 4) return 0;
-    return loaded_shps[shp_index].frame_size;
+    return GAME->loaded_shps[shp_index].frame_size;
 }
 
 uint8_t shp_get_horizontal(uint8_t shp_index)
 {
     if (shp_index >= 4) return 0;
-    return loaded_shps[shp_index].horizontal;
+    return GAME->loaded_shps[shp_index].horizontal;
 }
 
 uint8_t shp_get_animation(uint8_t shp_index)
 {
     if (shp_index >= 4) return 0;
-    return loaded_shps[shp_index].animation;
+    return GAME->loaded_shps[shp_index].animation;
 }
 
 uint8_t shp_get_num_distinct_frames(uint8_t shp_index)
 {
     if (shp_index >= 4) return 0;
-    return loaded_shps[shp_index].num_distinct;
+    return GAME->loaded_shps[shp_index].num_distinct;
 }
 
 uint8_t shp_get_animation_length(uint8_t shp_index)
@@ -336,12 +334,12 @@ int load_level_shp_files(const level_t* level)
         }
 
         /* Store into runtime cache */
-        loaded_shps[i].num_frames = frames_in_file;
-        loaded_shps[i].frame_size = frame_size;
-        loaded_shps[i].frames = buf;
-        loaded_shps[i].horizontal = s->horizontal;
-        loaded_shps[i].animation = s->animation;
-        loaded_shps[i].num_distinct = s->num_distinct_frames;
+        GAME->loaded_shps[i].num_frames = frames_in_file;
+        GAME->loaded_shps[i].frame_size = frame_size;
+        GAME->loaded_shps[i].frames = buf;
+        GAME->loaded_shps[i].horizontal = s->horizontal;
+        GAME->loaded_shps[i].animation = s->animation;
+        GAME->loaded_shps[i].num_distinct = s->num_distinct_frames;
         files_loaded++;
     }
 
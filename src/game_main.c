@@ -35,6 +35,18 @@
 #include "file_loaders.h"
 #include "actors.h"
 #include "doors.h"
+#include "dirty_rects.h"
+#include "graphic_cache.h"
+#include "compiled_sprites.h"
+#include "vram.h"
+#include "replay.h"
+#include "game_state.h"
+#include "rewind.h"
+#include "tile_query.h"
+#include "profile.h"
+#include "ui.h"
+#include "log.h"
+#include "trace.h"
 
 /* Runtime library symbol for large model code */
 int _big_code_ = 1;
@@ -148,151 +160,22 @@ void debug_log(const char *format, ...)
 #define SCANCODE_S      0x1F
 #define SCANCODE_C      0x2E
 #define SCANCODE_B      0x30
+#define SCANCODE_F8     0x42
+#define SCANCODE_F9     0x43
+#define SCANCODE_F10    0x44
 
 /* Global variables for initialization and game state */
 static uint8_t interrupt_handler_install_sentinel = 0;
-static volatile uint8_t game_tick_flag = 0;
 static uint16_t max_joystick_reads = 0;
 static uint16_t saved_video_mode = 0;
-uint8_t current_level_number = LEVEL_NUMBER_FOREST;
-uint8_t current_stage_number = 0;
-level_t current_level;
-
-/* Stage entry tracking (-2=first spawn, -1=boundary, >=0=door from level) */
-int8_t source_door_level_number = -2;
-int8_t source_door_stage_number = 0;
-
-/* Checkpoint position (for respawn and boundary crossing) */
-uint8_t comic_y_checkpoint = 12;
-uint8_t comic_x_checkpoint = 14;
-
-/* Game state variables */
-uint8_t win_counter = 0;
-uint8_t comic_x = 0;
-uint8_t comic_y = 0;
-uint8_t comic_animation = COMIC_STANDING;
-uint8_t comic_facing = COMIC_FACING_RIGHT;
-uint8_t comic_run_cycle = COMIC_RUNNING_1;
-uint8_t comic_is_falling_or_jumping = 0;
-uint8_t comic_is_teleporting = 0;
-int8_t comic_x_momentum = 0;
-int8_t comic_y_vel = 0;
-uint8_t comic_jump_counter = 0;  /* Current jump countdown (0 when standing) */
-uint8_t comic_jump_power = JUMP_POWER_DEFAULT;  /* Base jump power (4 default, 5 with Boots) */
-uint8_t ceiling_stick_flag = 0;  /* Whether Comic is jumping upward against a ceiling */
-uint8_t comic_fall_delay = 0;  /* Ticks to hover at jump apex */
-const level_t *current_level_ptr = NULL;  /* Pointer to current level data */
-uint8_t comic_hp = 0;  /* Start at 0, will fill to MAX_HP via pending_increase */
-uint8_t comic_hp_pending_increase = MAX_HP;  /* Fill HP at game start */
-uint16_t camera_x = 0;
-/* Landing sentinel: set by physics when hitting ground; clears each tick */
-uint8_t landed_this_tick = 0;
-/* Set by stage-edge movement code when a stage change occurs mid-tick. */
-uint8_t stage_transitioned_this_tick = 0;
-
-/* Death animation state - prevents re-entering death animation during enemy collisions */
-uint8_t inhibit_death_by_enemy_collision = 0;
-/* Flag set after death animation finishes to skip partial sprite rendering in comic_dies */
-uint8_t comic_death_animation_finished = 0;
-
-/* Teleport state */
-static uint8_t teleport_animation = 0;
-static uint8_t teleport_source_x = 0;
-static uint8_t teleport_source_y = 0;
-static uint8_t teleport_destination_x = 0;
-static uint8_t teleport_destination_y = 0;
-static uint8_t teleport_camera_counter = 0;
-static int8_t teleport_camera_vel = 0;
-
-/* Input state variables (set by keyboard interrupt handler) */
-uint8_t key_state_esc = 0;
-uint8_t key_state_jump = 0;
-uint8_t key_state_fire = 0;
-uint8_t key_state_left = 0;
-uint8_t key_state_right = 0;
-uint8_t key_state_open = 0;
-uint8_t key_state_teleport = 0;
-static uint8_t key_state_cheat_wand = 0;  /* W key for teleport wand cheat */
-static uint8_t key_state_cheat_key = 0;   /* K key for door key cheat */
-static uint8_t key_state_cheat_cola = 0;  /* B key for Blastola Cola cheat */
-static uint8_t key_state_cheat_corkscrew = 0; /* C key for Corkscrew cheat */
-static uint8_t key_state_cheat_boots = 0; /* O key for Boots cheat */
-static uint8_t key_state_cheat_lantern = 0; /* L key for Lantern cheat */
-static uint8_t key_state_cheat_shield = 0; /* S key for Shield cheat */
-static uint8_t key_state_cheat_level = 0;  /* P key for level warp cheat */
-static uint8_t key_state_cheat_stage = 0;  /* Q key for stage warp cheat */
-
-/* Previous frame input state (used for edge-triggered input like jump) */
-static uint8_t previous_key_state_jump = 0;
-static uint8_t previous_key_state_teleport = 0;
-static uint8_t previous_key_state_cheat_wand = 0;
-static uint8_t previous_key_state_cheat_key = 0;
-static uint8_t previous_key_state_cheat_cola = 0;
-static uint8_t previous_key_state_cheat_corkscrew = 0;
-static uint8_t previous_key_state_cheat_boots = 0;
-static uint8_t previous_key_state_cheat_lantern = 0;
-static uint8_t previous_key_state_cheat_shield = 0;
-static uint8_t previous_key_state_cheat_level = 0;
-static uint8_t previous_key_state_cheat_stage = 0;
-
-/* Flag set when teleport key edge is detected in update_keyboard_input() */
-static uint8_t teleport_key_pressed = 0;
-
-/* Minimum jump frames counter - ensures quick taps get at least 2 frames of acceleration */
-uint8_t minimum_jump_frames = 0;
-
-/* Fireball state */
-static uint8_t fireball_meter = 0;   /* Start with empty fireball meter */
-static uint8_t fireball_meter_counter = 2;
-
-/* Item collection state */
-uint8_t comic_has_door_key = 0;
-uint8_t comic_has_teleport_wand = 0;
-uint8_t comic_firepower = 0;           /* Number of active fireball slots (0-5) */
-uint8_t comic_has_corkscrew = 0;       /* 1 if Corkscrew item collected */
-uint8_t comic_has_lantern = 0;         /* 1 if Lantern item collected (only affects darkness in Castle level) */
-
-/* Score - 3 bytes (24-bit value) to store up to 999,999 points */
-uint8_t score_bytes[3] = {0, 0, 0};  /* Little-endian: byte 0 is LSB, byte 2 is MSB */
-/* Counts carry events from score_bytes[0] into score_bytes[1] (every 10,000 points). */
-static uint8_t score_10000_counter = 0;
-/* Score macros (score_get_value and score_set_value) are defined in globals.h */
-
-/* Item collection tracking (per level and stage) */
-uint8_t items_collected[8][16];        /* Bitmap: items_collected[level][stage] */
-uint8_t item_animation_counter = 0;    /* 0 or 1, toggles for item animation */
-
-/* Enemy respawn timer cycle */
-uint8_t enemy_respawn_counter_cycle = 20; /* Cycles: 20→40→60→80→100→20 */
-
-/* Tileset buffer - holds data from .TT2 file */
-uint8_t tileset_last_passable;
-uint8_t tileset_flags;
-uint8_t tileset_graphics[128 * 128];  /* Up to 128 16x16 tiles */
-
-/* Stage data - three .PT files per level */
-static pt_file_t pt0;
-static pt_file_t pt1;
-static pt_file_t pt2;
-uint8_t *current_tiles_ptr = NULL;  /* Points to current stage's tile map */
-static uint8_t comic_num_lives = 0;
-uint8_t comic_num_treasures = 0;  /* Number of treasures collected (CROWN, GOLD, GEMS - 0-3). When == 3, triggers victory sequence */
-uint8_t comic_has_gems = 0;        /* 1 if Gems collected (Space), 0 otherwise */
-uint8_t comic_has_crown = 0;       /* 1 if Crown collected (Castle), 0 otherwise */
-uint8_t comic_has_gold = 0;        /* 1 if Gold collected (Cave), 0 otherwise */
+
+/* Simulation state (positions, level, input, items, score), the loaded
+ * level assets, the keyboard and tick input and the turbo, rewind and
+ * replay state are in game_state.h */
 
 /* Offscreen buffer pointer (0x0000 or 0x2000) - start with A as offscreen when B is displayed */
 uint16_t offscreen_video_buffer_ptr = GRAPHICS_BUFFER_GAMEPLAY_A;
 
-/* Default keymap for keyboard configuration */
-static uint8_t keymap[6] = {
-    0x39,  /* SCANCODE_SPACE */
-    0x52,  /* SCANCODE_INS */
-    0x4B,  /* SCANCODE_LEFT */
-    0x4D,  /* SCANCODE_RIGHT */
-    0x38,  /* SCANCODE_ALT */
-    0x3A   /* SCANCODE_CAPSLOCK */
-};
 
 /* Level names for TT2 files */
 static const char* level_names[] = {
@@ -388,18 +271,22 @@ static const char TITLE_SEQUENCE_MESSAGE[] =
 /* Forward declarations */
 int load_new_level(void);
 void load_new_stage(void);
+uint8_t run_game_tick(void);
+int begin_game(void);
 void game_loop(void);
 void blit_map_playfield_offscreen(void);
 void blit_comic_playfield_offscreen(void);
 void blit_comic_partial_playfield_offscreen(uint16_t max_height);
 void swap_video_buffers(void);
-void render_inventory_display(void);
-void render_score_display(void);
 static void clear_bios_keyboard_buffer(void);
 static void clear_scancode_queue(void);
 static void update_keyboard_input(void);
+static void feed_replay_tick(void);
 static void handle_cheat_codes(void);
 static void dos_idle(void);
+static void ensure_map_window_rendered(void);
+static void render_map_idle(void);
+static uint8_t *stage_tiles(uint8_t stage_number);
 static void game_over(void);
 static void do_high_scores(void);
 static void game_end_sequence(void);
@@ -435,13 +322,21 @@ void disable_pc_speaker(void)
  */
 void wait_n_ticks(uint16_t ticks)
 {
+    /* A deliberate wait: the timer catching up with the tick is not lag */
+    profile_tick_active = 0;
+
+    /* Replays do not keep real time */
+    if (GAME->replay.mode == REPLAY_PLAYBACK) {
+        return;
+    }
+
     while (ticks > 0) {
-        while (game_tick_flag != 1) {
+        while (GAME->game_tick_flag != 1) {
             /* Match game-loop wait behavior while yielding CPU between IRQ0 updates. */
             dos_idle();
         }
 
-        game_tick_flag = 0;
+        GAME->game_tick_flag = 0;
         ticks--;
     }
 }
@@ -476,17 +371,23 @@ void calibrate_joystick(void)
     current_ticks = start_ticks;
     
     /* Initialize DX to a safe port for IN operations */
+#ifndef HOST_BUILD
     __asm {
         mov dx, 0x80    ; DX = safe delay port
     }
+#endif
     
     /* Perform IN instructions in a tight loop, checking the timer periodically */
     do {
         /* Inner loop: perform multiple IN instructions */
         for (inner_loop = 0; inner_loop < 28; inner_loop++) {
+#ifdef HOST_BUILD
+            (void)inp(0x80);
+#else
             __asm {
                 in al, dx       ; Dummy IN instruction from port 0x80
             }
+#endif
         }
         
         iteration_count++;
@@ -515,12 +416,6 @@ void calibrate_joystick(void)
 static void (__interrupt *saved_int8_handler)(void);   /* Timer tick handler */
 static void (__interrupt *saved_int9_handler)(void);   /* Keyboard handler */
 
-/* Keyboard scancode capture buffer (direct from INT 9) */
-#define MAX_SCANCODE_QUEUE 16
-static uint8_t scancode_queue[MAX_SCANCODE_QUEUE];
-static uint8_t scancode_queue_head = 0;
-static uint8_t scancode_queue_tail = 0;
-
 /*
  * int8_handler - Timer interrupt (INT 8) handler
  * 
@@ -532,13 +427,20 @@ static uint8_t irq0_parity = 0;
 
 static void __interrupt int8_handler(void)
 {
+    /* Timer wraps for the tick profiler's clock (see profile.h) */
+    profile_irq0_count++;
+
     /* Advance music on every interrupt cycle */
     sound_advance_tick();
     
     /* Toggle parity and set game tick flag only on odd interrupts */
     irq0_parity = (irq0_parity + 1) % 2;
     if (irq0_parity == 1) {
-        game_tick_flag = 1;
+        /* Due while the last game tick is still running: a lag frame */
+        if (profile_tick_active && profile_lag_pending != 0xff) {
+            profile_lag_pending++;
+        }
+        GAME->game_tick_flag = 1;
     }
     
     /* Call the original timer interrupt handler to maintain system timing */
@@ -561,10 +463,10 @@ static void __interrupt int9_handler(void)
     scancode = inp(0x60);
     
     /* Store scancode in queue if there's room */
-    next_head = (scancode_queue_head + 1) % MAX_SCANCODE_QUEUE;
-    if (next_head != scancode_queue_tail) {
-        scancode_queue[scancode_queue_head] = scancode;
-        scancode_queue_head = next_head;
+    next_head = (GAME->scancode_queue_head + 1) % MAX_SCANCODE_QUEUE;
+    if (next_head != GAME->scancode_queue_tail) {
+        GAME->scancode_queue[GAME->scancode_queue_head] = scancode;
+        GAME->scancode_queue_head = next_head;
     }
     
     /* Call the original keyboard interrupt handler */
@@ -690,8 +592,25 @@ void terminate_program(void)
     union REGS regs;
     uint8_t port_value;
 
+    /* Write the buffered log, the lag frames (which answer an F8 still
+     * pending too), the tick profile (/PROFILE), the VRAM traffic (make
+     * VRAM_STATS=1) and the trace (/TRACE), and give the PIT back its BIOS
+     * mode */
+    log_flush();
+    profile_lag_report(debug_log);
+    profile_report(debug_log);
+    VRAM_STATS_REPORT(debug_log);
+    trace_dump();
+    profile_stop();
+
     /* Close debug log if open */
     debug_log_close();
+
+    /* Finish a recording (or stop playback) */
+    replay_close();
+    
+    /* Free the fullscreen graphic cache (EMS pages outlive the program otherwise) */
+    graphic_cache_shutdown();
     
     /* Restore original interrupt handlers */
     restore_interrupt_handlers();
@@ -777,7 +696,7 @@ int load_keymap_file(void)
     regs.h.ah = 0x3F;  /* AH=0x3F: read from file */
     regs.x.bx = file_handle;
     regs.x.cx = 6;     /* Read 6 bytes */
-    regs.x.dx = DOS_OFFSET(keymap);
+    regs.x.dx = DOS_OFFSET(GAME->keymap);
     int86(0x21, &regs, &regs);
     
     /* Check for read errors (carry flag set) */
@@ -840,7 +759,7 @@ int check_interrupt_handler_install_sentinel(void)
 void clear_keyboard_buffer(void)
 {
     /* Access BIOS data area at segment 0x0000 */
-    uint8_t __far *bios_data = (uint8_t __far *)0x00000000L;
+    uint8_t __far *bios_data = (uint8_t __far *)MK_FP(0x0000, 0);
     uint8_t head;
     
     /* Disable interrupts while manipulating the buffer */
@@ -918,13 +837,13 @@ static uint8_t get_unmapped_scancode(uint8_t *temp_keymap, uint8_t num_mapped)
     
     do {
         /* Wait for a scancode to appear in the queue (populated by INT 9 handler) */
-        while (scancode_queue_head == scancode_queue_tail) {
+        while (GAME->scancode_queue_head == GAME->scancode_queue_tail) {
             /* Queue is empty, wait for interrupt handler to populate it */
         }
         
         /* Get scancode from queue */
-        scancode = scancode_queue[scancode_queue_tail];
-        scancode_queue_tail = (scancode_queue_tail + 1) % MAX_SCANCODE_QUEUE;
+        scancode = GAME->scancode_queue[GAME->scancode_queue_tail];
+        GAME->scancode_queue_tail = (GAME->scancode_queue_tail + 1) % MAX_SCANCODE_QUEUE;
         
         /* Separate break/make status from scancode value */
         is_break = (scancode & 0x80) != 0;
@@ -1248,12 +1167,12 @@ setup_confirm_loop:
      * Assembly order:     temp[0]=Left, temp[1]=Right, temp[2]=Jump, temp[3]=Fire, temp[4]=Open, temp[5]=Teleport
      * Keymap order (C):   keymap[0]=Jump, keymap[1]=Fire, keymap[2]=Left, keymap[3]=Right, keymap[4]=Open, keymap[5]=Teleport
      */
-    keymap[0] = temp_keymap[2];  /* Jump */
-    keymap[1] = temp_keymap[3];  /* Fire (Fireball) */
-    keymap[2] = temp_keymap[0];  /* Left */
-    keymap[3] = temp_keymap[1];  /* Right */
-    keymap[4] = temp_keymap[4];  /* Open */
-    keymap[5] = temp_keymap[5];  /* Teleport */
+    GAME->keymap[0] = temp_keymap[2];  /* Jump */
+    GAME->keymap[1] = temp_keymap[3];  /* Fire (Fireball) */
+    GAME->keymap[2] = temp_keymap[0];  /* Left */
+    GAME->keymap[3] = temp_keymap[1];  /* Right */
+    GAME->keymap[4] = temp_keymap[4];  /* Open */
+    GAME->keymap[5] = temp_keymap[5];  /* Teleport */
     
     /* Clear keyboard buffers before asking to save */
     clear_scancode_queue();
@@ -1272,7 +1191,7 @@ save_confirm_loop:
     
     /* Check response: only 'y'/'Y' saves, 'n'/'N' skips, others loop */
     if (response == 'y' || response == 'Y') {
-        if (!save_keymap_to_file(keymap)) {
+        if (!save_keymap_to_file(GAME->keymap)) {
             /* File save failed - display error message and wait for user acknowledgment */
             regs.h.ah = 0x09;
             regs.x.dx = DOS_OFFSET(KEYBOARD_CONFIG_SAVE_ERROR);
@@ -1331,10 +1250,10 @@ void award_extra_life(void)
     play_sound(SOUND_EXTRA_LIFE, 4);
     
     /* Check if already at max lives */
-    if (comic_num_lives >= MAX_NUM_LIVES) {
+    if (GAME->comic_num_lives >= MAX_NUM_LIVES) {
         /* Already at maximum lives: refill HP and award 22500 points (75 + 75 + 75 = 225 * 100)
          * Set HP refill unconditionally - if HP is already full, increment_comic_hp will award bonus points */
-        comic_hp_pending_increase = MAX_HP;
+        GAME->comic_hp_pending_increase = MAX_HP;
         award_points(75);
         award_points(75);
         award_points(75);
@@ -1342,16 +1261,16 @@ void award_extra_life(void)
     }
     
     /* Increment lives if below max */
-    comic_num_lives++;
+    GAME->comic_num_lives++;
     
     /* Display the bright life icon at the appropriate position
      * Icons start at x=24, then each life is at x = 24 + (life_count * 24) pixels
      * After incrementing, comic_num_lives contains the NEW count */
-    x_pixel = 24 + (comic_num_lives * 24);
+    x_pixel = 24 + (GAME->comic_num_lives * 24);
     y_pixel = 180;
     
     /* Blit the bright life icon to both gameplay buffers */
-    blit_sprite_16x16_masked(x_pixel, y_pixel, sprite_life_icon_bright);
+    blit_sprite_16x16_masked_both_pages(x_pixel, y_pixel, sprite_life_icon_bright);
 }
 
 /*
@@ -1366,12 +1285,12 @@ void lose_a_life(void)
     uint8_t old_lives;
     
     /* Subtract a life if any remain */
-    if (comic_num_lives > 0) {
+    if (GAME->comic_num_lives > 0) {
         /* Save the current life count before decrementing */
-        old_lives = comic_num_lives;
+        old_lives = GAME->comic_num_lives;
         
         /* Decrement the life count */
-        comic_num_lives--;
+        GAME->comic_num_lives--;
         
         /* Display the dark (unavailable) life icon at the position of the life we just lost
          * Use the OLD value (before decrement) to calculate position
@@ -1380,7 +1299,7 @@ void lose_a_life(void)
         y_pixel = 180;
         
         /* Blit the dark life icon to both gameplay buffers */
-        blit_sprite_16x16_masked(x_pixel, y_pixel, sprite_life_icon_dark);
+        blit_sprite_16x16_masked_both_pages(x_pixel, y_pixel, sprite_life_icon_dark);
     }
 }
 
@@ -1434,7 +1353,7 @@ void initialize_lives_sequence(void)
     lose_a_life();
     
     /* Sanity check: verify lives == MAX_NUM_LIVES - 1 */
-    if (comic_num_lives != MAX_NUM_LIVES - 1) {
+    if (GAME->comic_num_lives != MAX_NUM_LIVES - 1) {
         /* This is dead code from the original assembly that sets win_counter
          * to trigger an instant win. We'll omit it for now. */
         /* win_counter = 200; */
@@ -1523,20 +1442,58 @@ void title_sequence(void)
     /* Step 5: Switch to gameplay buffer B (with UI background) */
     switch_video_buffer(GRAPHICS_BUFFER_GAMEPLAY_B);
     
-    /* Initialize lives and start the game */
+    /* Initialize lives, load the level and run the main game loop */
+    if (begin_game() != 0) {
+        /* Failed to load level - cannot continue */
+        return;
+    }
+    game_loop();
+}
+
+/*
+ * begin_game - Start a new game at current_level_number
+ * 
+ * Awards the starting lives and loads the level and its first stage. When
+ * a replay is being played back, the recording's start state (level,
+ * stage, counters and keymap) replaces the current one; when recording,
+ * the start state is written to the replay file.
+ * 
+ * Returns:
+ *   0 on success, -1 if the level could not be loaded
+ */
+int begin_game(void)
+{
+    replay_start_t start;
+
     /* In the original assembly, this jumps to initialize_lives_sequence */
     initialize_lives_sequence();
-    
-    /* After lives are initialized, load the level and run game loop */
+
+    if (GAME->replay.mode == REPLAY_PLAYBACK) {
+        GAME->current_level_number = GAME->replay.start.level_number;
+        GAME->current_stage_number = GAME->replay.start.stage_number;
+    }
+
     if (load_new_level() != 0) {
-        /* Failed to load level - cannot continue */
-        return;
+        return -1;
     }
-    
     load_new_stage();
-    
-    /* Run main game loop */
-    game_loop();
+    rewind_reset();
+    profile_resync();
+    ui_reset();
+
+    if (GAME->replay.mode == REPLAY_PLAYBACK) {
+        GAME->enemy_respawn_counter_cycle = GAME->replay.start.enemy_respawn_counter_cycle;
+        GAME->item_animation_counter = GAME->replay.start.item_animation_counter;
+        memcpy(GAME->keymap, GAME->replay.start.keymap, sizeof(GAME->keymap));
+    } else if (GAME->replay.mode == REPLAY_RECORD) {
+        start.level_number = GAME->current_level_number;
+        start.stage_number = GAME->current_stage_number;
+        start.enemy_respawn_counter_cycle = GAME->enemy_respawn_counter_cycle;
+        start.item_animation_counter = GAME->item_animation_counter;
+        memcpy(start.keymap, GAME->keymap, sizeof(start.keymap));
+        replay_write_start(&start);
+    }
+    return 0;
 }
 
 /*
@@ -1629,7 +1586,47 @@ static void copy_string(char* dest, const char* src)
 }
 
 /*
- * load_new_level - Load a new level
+ * transpose_tileset - Reorder tileset_graphics from file order to plane-major
+ * 
+ * File order is tile, plane, row (tile_id * 128 + plane * 32 + row * 2).
+ * The result is plane, tile, row (TILESET_ROW_OFFSET). Treating each
+ * 32-byte tile plane as one block, this is a transpose of a 128x4 block
+ * matrix, done in place by following permutation cycles so no second
+ * 16 KB buffer is needed.
+ */
+static void transpose_tileset(void)
+{
+    uint8_t moved[TILESET_MAX_TILES * 4 / 8];  /* One bit per block */
+    uint8_t carry[32];
+    uint8_t swap[32];
+    uint16_t start;
+    uint16_t block;
+    uint16_t next;
+
+    memset(moved, 0, sizeof(moved));
+
+    for (start = 0; start < TILESET_MAX_TILES * 4; start++) {
+        if (moved[start >> 3] & (1 << (start & 7))) {
+            continue;
+        }
+
+        /* Carry each block to its destination, picking up the one displaced there */
+        memcpy(carry, &GAME->tileset_graphics[start * 32], 32);
+        block = start;
+        do {
+            /* Block (tile, plane) = (block / 4, block % 4) moves to plane * 128 + tile */
+            next = (block & 3) * TILESET_MAX_TILES + (block >> 2);
+            memcpy(swap, &GAME->tileset_graphics[next * 32], 32);
+            memcpy(&GAME->tileset_graphics[next * 32], carry, 32);
+            memcpy(carry, swap, 32);
+            moved[next >> 3] |= (uint8_t)(1 << (next & 7));
+            block = next;
+        } while (block != start);
+    }
+}
+
+/*
+ * read_new_level - Load a new level
  * 
  * Loads the level specified by current_level_number:
  * 1. Copies level data from static level_data_pointers array to current_level
@@ -1652,14 +1649,15 @@ static void copy_string(char* dest, const char* src)
  * 
  * Output:
  *   current_level = filled with level data
- *   tileset_graphics = array of tile images from .TT2 file (may be partial)
+ *   tileset_graphics = tile images from .TT2 file (may be partial), transposed
+ *                      to plane-major order by transpose_tileset()
  *   pt0, pt1, pt2 = stage maps from .PT files
  * 
  * Returns:
  *   0 on success (files opened and headers read successfully)
  *   -1 on critical error (invalid level number, file open failed, or header read failed)
  */
-int load_new_level(void)
+static int read_new_level(void)
 {
     int file_handle;
     unsigned bytes_read;
@@ -1675,27 +1673,27 @@ int load_new_level(void)
     } tt2_header;
     
     /* Validate level number */
-    if (current_level_number >= 8) {
+    if (GAME->current_level_number >= 8) {
         fprintf(stderr, "ERROR: load_new_level: Invalid level number %d (must be 0-7)\n", 
-                current_level_number);
+                GAME->current_level_number);
         return -1;
     }
     
     /* Copy level data from static data to current_level */
-    source_level = level_data_pointers[current_level_number];
+    source_level = level_data_pointers[GAME->current_level_number];
     if (source_level == NULL) {
         fprintf(stderr, "ERROR: load_new_level: Level %d data pointer is NULL\n", 
-                current_level_number);
+                GAME->current_level_number);
         return -1;
     }
-    memcpy(&current_level, source_level, sizeof(level_t));
+    memcpy(&GAME->current_level, source_level, sizeof(level_t));
     
     /* Load the .TT2 file (tileset graphics) - CRITICAL */
-    file_handle = _open(current_level.tt2_filename, O_RDONLY | O_BINARY);
+    file_handle = _open(GAME->current_level.tt2_filename, O_RDONLY | O_BINARY);
     if (file_handle == -1) {
         /* Tileset file not found - this is a critical failure */
         fprintf(stderr, "ERROR: load_new_level: Cannot open tileset file '%s' for level %d\n",
-                current_level.tt2_filename, current_level_number);
+                GAME->current_level.tt2_filename, GAME->current_level_number);
         return -1;
     }
     
@@ -1705,14 +1703,14 @@ int load_new_level(void)
         /* Failed to read header - this is a critical failure */
         fprintf(stderr, "ERROR: load_new_level: Failed to read TT2 header from '%s' "
                 "(expected %u bytes, got %u)\n",
-                current_level.tt2_filename, (unsigned)sizeof(tt2_header), bytes_read);
+                GAME->current_level.tt2_filename, (unsigned)sizeof(tt2_header), bytes_read);
         _close(file_handle);
         return -1;
     }
     
     /* Extract header fields */
-    tileset_last_passable = tt2_header.last_passable;
-    tileset_flags = tt2_header.flags;
+    GAME->tileset_last_passable = tt2_header.last_passable;
+    GAME->tileset_flags = tt2_header.flags;
 
     /* The TT2 file format is: 4-byte header + uncompressed tile data (variable size).
      * Each tile is 128 bytes (4 planes × 32 bytes per plane).
@@ -1720,8 +1718,8 @@ int load_new_level(void)
      * We read as much as available, then zero-fill the rest of the buffer.
      * NOTE: _read() may not return all requested bytes in one call, so we loop until EOF. */
     {
-        uint8_t *buf_ptr = tileset_graphics;
-        unsigned bytes_remaining = sizeof(tileset_graphics);
+        uint8_t *buf_ptr = GAME->tileset_graphics;
+        unsigned bytes_remaining = sizeof(GAME->tileset_graphics);
         unsigned total_bytes_read = 0;
         
         while (bytes_remaining > 0) {
@@ -1734,7 +1732,7 @@ int load_new_level(void)
                 /* Read error */
                 _close(file_handle);
                 fprintf(stderr, "ERROR: load_new_level: Read error while loading TT2 data from '%s'\n",
-                        current_level.tt2_filename);
+                        GAME->current_level.tt2_filename);
                 return -1;
             }
             total_bytes_read += bytes_read;
@@ -1755,50 +1753,71 @@ int load_new_level(void)
     /* Log how much tileset data we read (should be at least some amount > 0) */
     if (bytes_read == 0) {
         fprintf(stderr, "WARNING: load_new_level: No tileset data read from '%s'. Level may render incorrectly.\n",
-                current_level.tt2_filename);
+                GAME->current_level.tt2_filename);
     }
     
     /* Lantern check: If in castle without lantern, black out tiles */
-    if (current_level_number == LEVEL_NUMBER_CASTLE) {
-        if (comic_has_lantern != 1) {
-            memset(tileset_graphics, 0, sizeof(tileset_graphics));
+    if (GAME->current_level_number == LEVEL_NUMBER_CASTLE) {
+        if (GAME->comic_has_lantern != 1) {
+            memset(GAME->tileset_graphics, 0, sizeof(GAME->tileset_graphics));
         }
     }
+
+    /* Reorder tiles into the layout the map renderer and door blits use */
+    transpose_tileset();
     
     /* Load the three .PT files for this level - non-critical */
-    if (load_pt_file(current_level.pt0_filename, &pt0) != 0) {
+    if (load_pt_file(GAME->current_level.pt0_filename, &GAME->pt0) != 0) {
         fprintf(stderr, "WARNING: load_new_level: Failed to load primary map '%s'\n",
-                current_level.pt0_filename);
+                GAME->current_level.pt0_filename);
         /* Initialize with empty map if load fails */
-        memset(&pt0, 0, sizeof(pt0));
-        pt0.width = MAP_WIDTH_TILES;
-        pt0.height = MAP_HEIGHT_TILES;
+        memset(&GAME->pt0, 0, sizeof(GAME->pt0));
+        GAME->pt0.width = MAP_WIDTH_TILES;
+        GAME->pt0.height = MAP_HEIGHT_TILES;
     }
     
-    if (load_pt_file(current_level.pt1_filename, &pt1) != 0) {
+    if (load_pt_file(GAME->current_level.pt1_filename, &GAME->pt1) != 0) {
         fprintf(stderr, "WARNING: load_new_level: Failed to load secondary map '%s'\n",
-                current_level.pt1_filename);
+                GAME->current_level.pt1_filename);
         /* Initialize with empty map if load fails */
-        memset(&pt1, 0, sizeof(pt1));
-        pt1.width = MAP_WIDTH_TILES;
-        pt1.height = MAP_HEIGHT_TILES;
+        memset(&GAME->pt1, 0, sizeof(GAME->pt1));
+        GAME->pt1.width = MAP_WIDTH_TILES;
+        GAME->pt1.height = MAP_HEIGHT_TILES;
     }
     
-    if (load_pt_file(current_level.pt2_filename, &pt2) != 0) {
+    if (load_pt_file(GAME->current_level.pt2_filename, &GAME->pt2) != 0) {
         fprintf(stderr, "WARNING: load_new_level: Failed to load tertiary map '%s'\n",
-                current_level.pt2_filename);
+                GAME->current_level.pt2_filename);
         /* Initialize with empty map if load fails */
-        memset(&pt2, 0, sizeof(pt2));
-        pt2.width = MAP_WIDTH_TILES;
-        pt2.height = MAP_HEIGHT_TILES;
+        memset(&GAME->pt2, 0, sizeof(GAME->pt2));
+        GAME->pt2.width = MAP_WIDTH_TILES;
+        GAME->pt2.height = MAP_HEIGHT_TILES;
     }
     
     /* Load .SHP files referenced by this level into runtime cache */
-    load_level_shp_files(&current_level);
+    load_level_shp_files(&GAME->current_level);
 
     return 0;  /* Success - tileset loaded and at least one playable state achieved */
 }
 
+/*
+ * load_new_level - Load the level in current_level_number
+ * 
+ * read_new_level() as one span of the tick trace (see trace.h).
+ * 
+ * Returns:
+ *   0 on success, -1 on a critical error
+ */
+int load_new_level(void)
+{
+    int result;
+
+    TRACE_BEGIN(LOAD_NEW_LEVEL, GAME->current_level_number);
+    result = read_new_level();
+    TRACE_END(LOAD_NEW_LEVEL);
+    return result;
+}
+
 /*
  * Stub implementations for game loop helper functions
  * These will be implemented progressively as the refactor continues
@@ -1822,46 +1841,48 @@ static void handle_teleport(void)
     teleport_sprites[3] = sprite_teleport_1_16x32m;  /* Frame 1 repeated */
     teleport_sprites[4] = sprite_teleport_0_16x32m;  /* Frame 0 repeated */
     
+    TRACE_BEGIN(TELEPORT_FRAME, GAME->teleport_animation);
+
     /* Move camera if counter is non-zero */
-    if (teleport_camera_counter > 0) {
+    if (GAME->teleport_camera_counter > 0) {
         /* Use signed arithmetic to prevent underflow, then clamp to valid range */
-        int16_t new_camera_x = (int16_t)camera_x + teleport_camera_vel;
-        camera_x = (new_camera_x < 0) ? 0 : (uint8_t)new_camera_x;
-        teleport_camera_counter--;
+        int16_t new_camera_x = (int16_t)GAME->camera_x + GAME->teleport_camera_vel;
+        GAME->camera_x = (new_camera_x < 0) ? 0 : (uint8_t)new_camera_x;
+        GAME->teleport_camera_counter--;
     }
     
     /* Render map background */
     blit_map_playfield_offscreen();
     
     /* Update Comic's actual position at frame 3 */
-    if (teleport_animation == 3) {
-        comic_y = teleport_destination_y;
-        comic_x = teleport_destination_x;
+    if (GAME->teleport_animation == 3) {
+        GAME->comic_y = GAME->teleport_destination_y;
+        GAME->comic_x = GAME->teleport_destination_x;
     }
     
     /* Blit Comic sprite */
     blit_comic_playfield_offscreen();
     
     /* Blit teleport animation at source position (frames 0-4) */
-    anim_frame = teleport_animation;
+    anim_frame = GAME->teleport_animation;
     if (anim_frame < 5) {
-        rel_x = (int16_t)((int)teleport_source_x - (int)camera_x);
+        rel_x = (int16_t)((int)GAME->teleport_source_x - (int)GAME->camera_x);
         if (rel_x >= 0 && rel_x < PLAYFIELD_WIDTH) {
             pixel_x = 8 + (rel_x * 8);
-            pixel_y = 8 + (teleport_source_y * 8);
+            pixel_y = 8 + (GAME->teleport_source_y * 8);
             sprite_ptr = teleport_sprites[anim_frame];
             blit_sprite_16x32_masked(pixel_x, pixel_y, sprite_ptr);
         }
     }
     
     /* Blit teleport animation at destination (frames 1-5, delayed by 1) */
-    if (teleport_animation >= 1) {
-        anim_frame = teleport_animation - 1;  /* Delayed by 1 frame */
+    if (GAME->teleport_animation >= 1) {
+        anim_frame = GAME->teleport_animation - 1;  /* Delayed by 1 frame */
         if (anim_frame < 5) {
-            rel_x = (int16_t)((int)teleport_destination_x - (int)camera_x);
+            rel_x = (int16_t)((int)GAME->teleport_destination_x - (int)GAME->camera_x);
             if (rel_x >= 0 && rel_x < PLAYFIELD_WIDTH) {
                 pixel_x = 8 + (rel_x * 8);
-                pixel_y = 8 + (teleport_destination_y * 8);
+                pixel_y = 8 + (GAME->teleport_destination_y * 8);
                 sprite_ptr = teleport_sprites[anim_frame];
                 blit_sprite_16x32_masked(pixel_x, pixel_y, sprite_ptr);
             }
@@ -1869,12 +1890,13 @@ static void handle_teleport(void)
     }
     
     /* Advance animation frame */
-    teleport_animation++;
+    GAME->teleport_animation++;
     
     /* End teleport at frame 6 */
-    if (teleport_animation >= 6) {
-        comic_is_teleporting = 0;
+    if (GAME->teleport_animation >= 6) {
+        GAME->comic_is_teleporting = 0;
     }
+    TRACE_END(TELEPORT_FRAME);
 }
 
 /* Physics functions implemented in physics.c */
@@ -1894,18 +1916,18 @@ static void begin_teleport(void)
     uint8_t max_camera_x;
     
     /* Initialize destination to Comic's current position */
-    dest_x = comic_x;
-    dest_y = comic_y;
+    dest_x = GAME->comic_x;
+    dest_y = GAME->comic_y;
     
     /* Calculate camera-relative position of Comic */
-    camera_rel_x = (int16_t)((int)comic_x - (int)camera_x);
+    camera_rel_x = (int16_t)((int)GAME->comic_x - (int)GAME->camera_x);
     
     /* Initialize camera movement */
-    teleport_camera_counter = 0;
+    GAME->teleport_camera_counter = 0;
     
     /* Determine destination based on facing direction */
-    if (comic_facing == COMIC_FACING_LEFT) {
-        teleport_camera_vel = -1;  /* Move camera left */
+    if (GAME->comic_facing == COMIC_FACING_LEFT) {
+        GAME->teleport_camera_vel = -1;  /* Move camera left */
         
         /* Check if too close to left edge */
         if (camera_rel_x < TELEPORT_DISTANCE) {
@@ -1919,15 +1941,15 @@ static void begin_teleport(void)
         if (dest_camera_rel < (PLAYFIELD_WIDTH / 2 - 2)) {
             /* Destination is left of center, need to move camera */
             camera_movement = (PLAYFIELD_WIDTH / 2 - 2) - dest_camera_rel;
-            if (camera_x >= camera_movement) {
-                teleport_camera_counter = (uint8_t)camera_movement;
+            if (GAME->camera_x >= camera_movement) {
+                GAME->teleport_camera_counter = (uint8_t)camera_movement;
             } else {
-                teleport_camera_counter = camera_x;
+                GAME->teleport_camera_counter = GAME->camera_x;
             }
         }
     } else {
         /* Facing right */
-        teleport_camera_vel = 1;  /* Move camera right */
+        GAME->teleport_camera_vel = 1;  /* Move camera right */
         
         /* Check if too close to right edge */
         if (camera_rel_x >= (PLAYFIELD_WIDTH - TELEPORT_DISTANCE - 1)) {
@@ -1942,10 +1964,10 @@ static void begin_teleport(void)
             /* Destination is right of center, need to move camera */
             max_camera_x = MAP_WIDTH - PLAYFIELD_WIDTH;
             camera_movement = dest_camera_rel - (PLAYFIELD_WIDTH / 2);
-            if ((camera_x + camera_movement) <= max_camera_x) {
-                teleport_camera_counter = (uint8_t)camera_movement;
+            if ((GAME->camera_x + camera_movement) <= max_camera_x) {
+                GAME->teleport_camera_counter = (uint8_t)camera_movement;
             } else {
-                teleport_camera_counter = (uint8_t)(max_camera_x - camera_x);
+                GAME->teleport_camera_counter = (uint8_t)(max_camera_x - GAME->camera_x);
             }
         }
     }
@@ -1958,19 +1980,14 @@ static void begin_teleport(void)
     solid_found = 0;
     
     while (search_y > 0 && !solid_found) {
-        uint16_t tile_offset = address_of_tile_at_coordinates(dest_x / 2, search_y / 2);
-        uint8_t tile_id = current_tiles_ptr[tile_offset];
-        
-        if (tile_id > tileset_last_passable) {
+        if (solid_at(dest_x, search_y)) {
             /* Found solid tile, now check for 2 non-solid tiles above */
             uint8_t check_y = search_y;
             nonsolid_count = 0;
             
             while (check_y >= 2 && nonsolid_count < 2) {
                 check_y -= 2;
-                tile_offset = address_of_tile_at_coordinates(dest_x / 2, check_y / 2);
-                tile_id = current_tiles_ptr[tile_offset];
-                if (tile_id > tileset_last_passable) {
+                if (solid_at(dest_x, check_y)) {
                     /* Hit another solid tile, insufficient clearance */
                     break;
                 } else {
@@ -1997,18 +2014,18 @@ static void begin_teleport(void)
     
 remain_in_place:
     /* No safe destination found, teleport to current position */
-    dest_x = comic_x;
-    dest_y = comic_y;
-    teleport_camera_counter = 0;
+    dest_x = GAME->comic_x;
+    dest_y = GAME->comic_y;
+    GAME->teleport_camera_counter = 0;
     
 finish_teleport:
     /* Initialize teleport state */
-    teleport_animation = 0;
-    teleport_source_x = comic_x;
-    teleport_source_y = comic_y;
-    teleport_destination_x = dest_x;
-    teleport_destination_y = dest_y;
-    comic_is_teleporting = 1;
+    GAME->teleport_animation = 0;
+    GAME->teleport_source_x = GAME->comic_x;
+    GAME->teleport_source_y = GAME->comic_y;
+    GAME->teleport_destination_x = dest_x;
+    GAME->teleport_destination_y = dest_y;
+    GAME->comic_is_teleporting = 1;
     
     /* Play teleport sound */
     play_sound(SOUND_TELEPORT, 2);
@@ -2016,6 +2033,29 @@ finish_teleport:
 
 /* face_or_move_left and face_or_move_right are implemented in game_main.c */
 
+/*
+ * write_lag_status - Write the lag frames F8 asked for, if it did
+ *
+ * F8 only sets lag_status_key_pressed; the report (the lag frames so far,
+ * and the profile if one is running) is written here, after log_flush()
+ * at the pause screen and at stage loads. Closing the log puts it on
+ * disk. The disk access is not the game's lag, so the profiler and lag
+ * counter restart afterwards.
+ */
+static void write_lag_status(void)
+{
+    if (!GAME->lag_status_key_pressed) {
+        return;
+    }
+    GAME->lag_status_key_pressed = 0;
+    debug_log("Status at level %u stage %u:\n", GAME->current_level_number,
+              GAME->current_stage_number);
+    profile_lag_report(debug_log);
+    profile_report(debug_log);
+    debug_log_close();
+    profile_resync();
+}
+
 static void pause_game(void)
 {
     /* Display pause screen and wait for keypress
@@ -2028,8 +2068,17 @@ static void pause_game(void)
     uint8_t is_break;
     uint8_t code;
     
+    /* The game stops here anyway: write out the buffered log */
+    log_flush();
+    write_lag_status();
+
     /* Reset key_state_esc so the main loop doesn't get stuck waiting for release */
-    key_state_esc = 0;
+    GAME->key_state_esc = 0;
+
+    /* The key that ended a recorded pause was never recorded; carry straight on */
+    if (GAME->replay.mode == REPLAY_PLAYBACK) {
+        return;
+    }
     
     /* Clear both keyboard buffers before entering pause loop */
     clear_bios_keyboard_buffer();
@@ -2052,10 +2101,10 @@ static void pause_game(void)
         wait_n_ticks(1);
         
         /* Check if any scancode is available in the queue */
-        if (scancode_queue_head != scancode_queue_tail) {
+        if (GAME->scancode_queue_head != GAME->scancode_queue_tail) {
             /* Get next scancode from queue */
-            scancode = scancode_queue[scancode_queue_tail];
-            scancode_queue_tail = (scancode_queue_tail + 1) % MAX_SCANCODE_QUEUE;
+            scancode = GAME->scancode_queue[GAME->scancode_queue_tail];
+            GAME->scancode_queue_tail = (GAME->scancode_queue_tail + 1) % MAX_SCANCODE_QUEUE;
             
             /* Skip extended key prefix (0xE0) - just like update_keyboard_input() does */
             if (scancode == 0xE0) {
@@ -2123,10 +2172,10 @@ static void beam_in(void)
         handle_item();
         
         /* Blit materialize animation frame - this shows Comic fading in */
-        rel_x = (int16_t)((int)comic_x - (int)camera_x);
+        rel_x = (int16_t)((int)GAME->comic_x - (int)GAME->camera_x);
         if (rel_x >= 0 && rel_x < PLAYFIELD_WIDTH) {
             pixel_x = 8 + (rel_x * 8);
-            pixel_y = 8 + (comic_y * 8);
+            pixel_y = 8 + (GAME->comic_y * 8);
             sprite_ptr = materialize_sprites[frame];
             blit_sprite_16x32_masked(pixel_x, pixel_y, sprite_ptr);
         }
@@ -2193,10 +2242,10 @@ static void beam_out(void)
         }
         
         /* Blit materialize animation frame */
-        rel_x = (int16_t)((int)comic_x - (int)camera_x);
+        rel_x = (int16_t)((int)GAME->comic_x - (int)GAME->camera_x);
         if (rel_x >= 0 && rel_x < PLAYFIELD_WIDTH) {
             pixel_x = 8 + (rel_x * 8);
-            pixel_y = 8 + (comic_y * 8);
+            pixel_y = 8 + (GAME->comic_y * 8);
             sprite_ptr = materialize_sprites[frame];
             blit_sprite_16x32_masked(pixel_x, pixel_y, sprite_ptr);
         }
@@ -2214,97 +2263,34 @@ static void beam_out(void)
     wait_n_ticks(6);
 }
 
+/*
+ * decrement_fireball_meter - Use up one fireball meter unit (ui_update() redraws the meter)
+ */
 static void decrement_fireball_meter(void)
 {
-    uint8_t old_meter_val;
-    uint8_t cell_num;
-    uint16_t x_pos;
-    const uint8_t __far *sprite_to_render;
-    
-    if (fireball_meter == 0) {
-        return;
+    if (GAME->fireball_meter > 0) {
+        GAME->fireball_meter--;
     }
-    
-    /* Save old meter value before decrementing */
-    old_meter_val = fireball_meter;
-    
-    /* Decrement the meter */
-    fireball_meter--;
-    
-    /* Calculate cell position using (old_meter + 1) / 2
-     * This matches the assembly: mov ah, al; inc al; shr al, 1 */
-    cell_num = (old_meter_val + 1) >> 1;
-    
-    /* No need to cap - the offset naturally goes up to 6 for meter 12 */
-    
-    /* Determine sprite based on OLD meter value (before decrement):
-     * If OLD meter is odd: GRAPHIC_METER_EMPTY
-     * If OLD meter is even: GRAPHIC_METER_HALF */
-    if (old_meter_val & 1) {
-        /* Old meter was odd - draw empty cell */
-        sprite_to_render = sprite_meter_empty_8x16;
-    } else {
-        /* Old meter was even - draw half-full cell */
-        sprite_to_render = sprite_meter_half_8x16;
-    }
-    
-    /* Calculate X position: base at 240 (not 248), add cell_num * 8 pixels
-     * This matches the assembly: pixel_coords(240, 54) + ax */
-    x_pos = 240 + (cell_num << 3);
-    
-    /* Render the meter cell at Y=54 */
-    blit_8x16_sprite(x_pos, 54, sprite_to_render);
 }
 
+/*
+ * increment_fireball_meter - Recharge one fireball meter unit, up to MAX_FIREBALL_METER
+ */
 static void increment_fireball_meter(void)
 {
-    uint8_t meter_val;
-    uint8_t cell_num;
-    uint16_t x_pos;
-    const uint8_t __far *sprite_to_render;
-    
-    if (fireball_meter > MAX_FIREBALL_METER - 1) {
-        return;
+    if (GAME->fireball_meter < MAX_FIREBALL_METER) {
+        GAME->fireball_meter++;
     }
-    
-    fireball_meter++;
-    
-    /* After incrementing, use the NEW meter value for calculations */
-    meter_val = fireball_meter;
-    
-    /* Calculate which cell to display: cell_num = (meter - 1) / 2
-     * This maps: meter 1-2→cell 0, 3-4→cell 1, 5-6→cell 2, ..., 11-12→cell 5 */
-    cell_num = (meter_val - 1) >> 1;
-    
-    /* Cap cell at 5 to stay within the 6-cell display box */
-    if (cell_num > 5) {
-        cell_num = 5;
-    }
-    
-    /* Determine which sprite to render for the final cell:
-     * If meter is odd: GRAPHIC_METER_HALF
-     * If meter is even: GRAPHIC_METER_FULL */
-    if (meter_val & 1) {
-        /* Odd - draw half-full cell */
-        sprite_to_render = sprite_meter_half_8x16;
-    } else {
-        /* Even - draw full cell */
-        sprite_to_render = sprite_meter_full_8x16;
-    }
-    
-    /* Calculate X position: base at 248 (not 240), add 8 pixels per cell
-     * Since video buffer is in bytes (40 bytes = 320 pixels), each byte = 8 pixels */
-    x_pos = 248 + (cell_num << 3);
-    
-    /* Render the meter cell at Y=54 */
-    blit_8x16_sprite(x_pos, 54, sprite_to_render);
 }
 
 void blit_map_playfield_offscreen(void)
 {
     /* Blit the visible playfield region from the rendered map buffer
-     * into the offscreen video buffer, plane by plane.
-     * Uses EGA planar layout: all planes at same offsets, selected via plane registers.
+     * into the offscreen video buffer.
+     * Both regions live in video memory at the same planar offsets, so the
+     * copy goes through the EGA latches (write mode 1): each byte read loads
+     * all four planes and each byte written stores them, making this a single
+     * 24x160 = 3840-byte pass instead of four plane-by-plane passes.
      *  - camera_x is in game units (1 unit == 8 pixels == 1 byte horizontally)
      *  - Playfield top-left pixel is at (8,8)
      *  - Rendered map uses 256-byte stride; maximum valid camera_x = 256 - PLAYFIELD_WIDTH
@@ -2314,8 +2300,6 @@ void blit_map_playfield_offscreen(void)
     const uint16_t playfield_pixel_rows = PLAYFIELD_HEIGHT * 8; /* 20 * 8 = 160 */
     const uint16_t playfield_bytes_per_row = PLAYFIELD_WIDTH; /* 24 bytes */
     const uint16_t max_camera_x = rendered_bytes_per_row - playfield_bytes_per_row; /* 232 */
-    uint8_t plane;
-    uint16_t row;
     uint16_t src_start;
     uint16_t dst_start;
 
@@ -2323,83 +2307,85 @@ void blit_map_playfield_offscreen(void)
      * If camera_x exceeds max_camera_x, the max_src_bytes calculation would underflow.
      * This should never happen if load_new_stage correctly bounds camera_x, but we
      * validate here as a safety check. */
-    if (camera_x > max_camera_x) {
+    if (GAME->camera_x > max_camera_x) {
         /* Invalid camera position; cannot safely render */
         return;
     }
 
-    src_start = RENDERED_MAP_BUFFER + camera_x;
-    dst_start = offscreen_video_buffer_ptr + (8 * screen_bytes_per_row) + (8 / 8);
+    /* Sprites still queued from earlier drawing must land before the
+     * playfield is restored over them. */
+    sprite_queue_flush();
 
-    for (plane = 0; plane < 4; plane++) {
-        /* Enable reading and writing for this plane */
-        enable_ega_plane_read_write(plane);
+    /* The lazy map renderer may not have reached these columns yet */
+    ensure_map_window_rendered();
 
-        {
-            uint8_t __far *src_row = (uint8_t __far *)MK_FP(VIDEO_MEMORY_BASE, src_start);
-            uint8_t __far *dst_row = (uint8_t __far *)MK_FP(VIDEO_MEMORY_BASE, dst_start);
-
-            for (row = 0; row < playfield_pixel_rows; row++) {
-                uint8_t col;
-                for (col = 0; col < playfield_bytes_per_row; col++) {
-                    dst_row[col] = src_row[col];
-                }
-                src_row += rendered_bytes_per_row;
-                dst_row += screen_bytes_per_row;
-            }
-        }
+    /* If the camera has not scrolled since this page was last fully
+     * refreshed, only the regions sprites were drawn over need restoring. */
+    if (dirty_rects_restore_playfield(offscreen_video_buffer_ptr, GAME->camera_x)) {
+        return;
     }
+
+    src_start = RENDERED_MAP_BUFFER + GAME->camera_x;
+    dst_start = offscreen_video_buffer_ptr + (8 * screen_bytes_per_row) + (8 / 8);
+
+    /* Restores write mode 0 before returning, so the sprite blitters that
+     * follow see the usual per-plane Map Mask behavior. */
+    copy_ega_latched(src_start, rendered_bytes_per_row,
+                     dst_start, screen_bytes_per_row,
+                     playfield_bytes_per_row, playfield_pixel_rows);
+
+    dirty_rects_playfield_refreshed(offscreen_video_buffer_ptr, GAME->camera_x);
 }
 
 void blit_comic_playfield_offscreen(void)
 {
     /* Choose the correct 16x32 sprite based on animation and facing */
-    const uint8_t __far *sprite_ptr = NULL;
+    uint8_t sprite_id = COMPILED_SPRITE_NONE;
     int rel_x_units;              /* Signed: can be negative for left-of-camera sprites */
     int pixel_x_signed;           /* Signed calculation to avoid underflow */
     int pixel_y_signed;           /* Signed calculation */
 
     /* Skip rendering if animation is set to COMIC_ANIMATION_NONE (used during death sequences) */
-    if (comic_animation == COMIC_ANIMATION_NONE) {
+    if (GAME->comic_animation == COMIC_ANIMATION_NONE) {
         return;
     }
 
-    if (comic_animation == COMIC_STANDING) {
-        sprite_ptr = (comic_facing == COMIC_FACING_LEFT)
-            ? sprite_R4_comic_standing_left_16x32m
-            : sprite_R4_comic_standing_right_16x32m;
-    } else if (comic_animation == COMIC_JUMPING) {
-        sprite_ptr = (comic_facing == COMIC_FACING_LEFT)
-            ? sprite_R4_comic_jumping_left_16x32m
-            : sprite_R4_comic_jumping_right_16x32m;
+    if (GAME->comic_animation == COMIC_STANDING) {
+        sprite_id = (GAME->comic_facing == COMIC_FACING_LEFT)
+            ? COMPILED_SPRITE_COMIC_STANDING_LEFT
+            : COMPILED_SPRITE_COMIC_STANDING_RIGHT;
+    } else if (GAME->comic_animation == COMIC_JUMPING) {
+        sprite_id = (GAME->comic_facing == COMIC_FACING_LEFT)
+            ? COMPILED_SPRITE_COMIC_JUMPING_LEFT
+            : COMPILED_SPRITE_COMIC_JUMPING_RIGHT;
     } else {
         /* Running cycle 1..3 */
-        switch (comic_run_cycle) {
+        switch (GAME->comic_run_cycle) {
             case COMIC_RUNNING_1:
-                sprite_ptr = (comic_facing == COMIC_FACING_LEFT)
-                    ? sprite_R4_comic_running_1_left_16x32m
-                    : sprite_R4_comic_running_1_right_16x32m;
+                sprite_id = (GAME->comic_facing == COMIC_FACING_LEFT)
+                    ? COMPILED_SPRITE_COMIC_RUNNING_1_LEFT
+                    : COMPILED_SPRITE_COMIC_RUNNING_1_RIGHT;
                 break;
             case COMIC_RUNNING_2:
-                sprite_ptr = (comic_facing == COMIC_FACING_LEFT)
-                    ? sprite_R4_comic_running_2_left_16x32m
-                    : sprite_R4_comic_running_2_right_16x32m;
+                sprite_id = (GAME->comic_facing == COMIC_FACING_LEFT)
+                    ? COMPILED_SPRITE_COMIC_RUNNING_2_LEFT
+                    : COMPILED_SPRITE_COMIC_RUNNING_2_RIGHT;
                 break;
             case COMIC_RUNNING_3:
             default:
-                sprite_ptr = (comic_facing == COMIC_FACING_LEFT)
-                    ? sprite_R4_comic_running_3_left_16x32m
-                    : sprite_R4_comic_running_3_right_16x32m;
+                sprite_id = (GAME->comic_facing == COMIC_FACING_LEFT)
+                    ? COMPILED_SPRITE_COMIC_RUNNING_3_LEFT
+                    : COMPILED_SPRITE_COMIC_RUNNING_3_RIGHT;
                 break;
         }
     }
 
-    if (sprite_ptr == NULL) {
+    if (sprite_id == COMPILED_SPRITE_NONE) {
         return;
     }
 
     /* Compute pixel coordinates relative to camera and playfield offset (8,8) */
-    rel_x_units = (int)comic_x - (int)camera_x;
+    rel_x_units = (int)GAME->comic_x - (int)GAME->camera_x;
     
     /* Bounds check: Reject sprites that extend beyond the screen edges.
      * 
@@ -2431,10 +2417,10 @@ void blit_comic_playfield_offscreen(void)
      *   Unsigned: (unsigned)(-8) + 8 = 65528 + 8 = 65536 (WRONG underflow)
      * Cast to unsigned only for the function call. */
     pixel_x_signed = (rel_x_units * 8) + 8;
-    pixel_y_signed = (int)comic_y * 8 + 8;
+    pixel_y_signed = (int)GAME->comic_y * 8 + 8;
 
-    /* Blit 16x32 masked sprite to the offscreen buffers */
-    blit_sprite_16x32_masked((uint16_t)pixel_x_signed, (uint16_t)pixel_y_signed, (const uint8_t *)sprite_ptr);
+    /* Blit the compiled 16x32 masked sprite to the offscreen buffers */
+    blit_compiled_sprite(sprite_id, (uint16_t)pixel_x_signed, (uint16_t)pixel_y_signed);
 }
 
 void blit_comic_partial_playfield_offscreen(uint16_t max_height)
@@ -2461,7 +2447,7 @@ void blit_comic_partial_playfield_offscreen(uint16_t max_height)
 
 
     /* Skip rendering if animation is set to COMIC_ANIMATION_NONE (used during death sequences) */
-    if (comic_animation == COMIC_ANIMATION_NONE) {
+    if (GAME->comic_animation == COMIC_ANIMATION_NONE) {
         return;
     }
 
@@ -2470,30 +2456,30 @@ void blit_comic_partial_playfield_offscreen(uint16_t max_height)
         return;
     }
 
-    if (comic_animation == COMIC_STANDING) {
-        sprite_ptr = (comic_facing == COMIC_FACING_LEFT)
+    if (GAME->comic_animation == COMIC_STANDING) {
+        sprite_ptr = (GAME->comic_facing == COMIC_FACING_LEFT)
             ? sprite_R4_comic_standing_left_16x32m
             : sprite_R4_comic_standing_right_16x32m;
-    } else if (comic_animation == COMIC_JUMPING) {
-        sprite_ptr = (comic_facing == COMIC_FACING_LEFT)
+    } else if (GAME->comic_animation == COMIC_JUMPING) {
+        sprite_ptr = (GAME->comic_facing == COMIC_FACING_LEFT)
             ? sprite_R4_comic_jumping_left_16x32m
             : sprite_R4_comic_jumping_right_16x32m;
     } else {
         /* Running cycle 1..3 */
-        switch (comic_run_cycle) {
+        switch (GAME->comic_run_cycle) {
             case COMIC_RUNNING_1:
-                sprite_ptr = (comic_facing == COMIC_FACING_LEFT)
+                sprite_ptr = (GAME->comic_facing == COMIC_FACING_LEFT)
                     ? sprite_R4_comic_running_1_left_16x32m
                     : sprite_R4_comic_running_1_right_16x32m;
                 break;
             case COMIC_RUNNING_2:
-                sprite_ptr = (comic_facing == COMIC_FACING_LEFT)
+                sprite_ptr = (GAME->comic_facing == COMIC_FACING_LEFT)
                     ? sprite_R4_comic_running_2_left_16x32m
                     : sprite_R4_comic_running_2_right_16x32m;
                 break;
             case COMIC_RUNNING_3:
             default:
-                sprite_ptr = (comic_facing == COMIC_FACING_LEFT)
+                sprite_ptr = (GAME->comic_facing == COMIC_FACING_LEFT)
                     ? sprite_R4_comic_running_3_left_16x32m
                     : sprite_R4_comic_running_3_right_16x32m;
                 break;
@@ -2505,7 +2491,7 @@ void blit_comic_partial_playfield_offscreen(uint16_t max_height)
     }
 
     /* Compute pixel coordinates relative to camera and playfield offset (8,8) */
-    rel_x_units = (int)comic_x - (int)camera_x;
+    rel_x_units = (int)GAME->comic_x - (int)GAME->camera_x;
     
     /* Horizontal bounds check: reject sprites outside playfield width */
     if (rel_x_units < 0 || rel_x_units >= PLAYFIELD_WIDTH) {
@@ -2514,7 +2500,7 @@ void blit_comic_partial_playfield_offscreen(uint16_t max_height)
     }
 
     pixel_x_signed = (rel_x_units * 8) + 8;
-    pixel_y_signed = (int)comic_y * 8 + 8;
+    pixel_y_signed = (int)GAME->comic_y * 8 + 8;
 
     /* Render only the visible rows (top-origin) using rows-based masked blit.
      * This matches the assembly behavior for partial height rendering. */
@@ -2529,6 +2515,9 @@ void blit_comic_partial_playfield_offscreen(uint16_t max_height)
 
 void swap_video_buffers(void)
 {
+    /* Finish any batched sprites before the frame is shown */
+    sprite_queue_end();
+
     /* Display the offscreen buffer and then toggle which buffer is offscreen */
     switch_video_buffer(offscreen_video_buffer_ptr);
 
@@ -2539,67 +2528,35 @@ void swap_video_buffers(void)
         offscreen_video_buffer_ptr = GRAPHICS_BUFFER_GAMEPLAY_A;
     }
 
+    /* The frame's VRAM traffic ends here (make VRAM_STATS=1) */
+    VRAM_STATS_FRAME();
 }
 
 static void increment_comic_hp(void)
 {
-    uint16_t x_pos;
-    
-    if (comic_hp >= MAX_HP) {
+    if (GAME->comic_hp >= MAX_HP) {
         /* HP is already full; award 1800 bonus points */
         award_points(18);  /* 18 * 100 = 1800 points */
         return;
     }
     
-    /* Increment HP */
-    comic_hp++;
-    
-    /* Render the HP meter cell at Y=82, base X=240
-     * Each unit of HP is 8 pixels wide */
-    x_pos = 240 + (comic_hp << 3);
-    blit_8x16_sprite(x_pos, 82, sprite_meter_full_8x16);
+    /* Increment HP (ui_update() redraws the meter) */
+    GAME->comic_hp++;
 }
 
 void decrement_comic_hp(void)
 {
-    uint16_t x_pos;
-    
-    if (comic_hp == 0) {
+    if (GAME->comic_hp == 0) {
         return;
     }
     
-    /* Render the empty sprite at the current HP position before decrementing */
-    x_pos = 240 + (comic_hp << 3);
-    blit_8x16_sprite(x_pos, 82, sprite_meter_empty_8x16);
-    
-    /* Decrement HP */
-    comic_hp--;
+    /* Decrement HP (ui_update() redraws the meter) */
+    GAME->comic_hp--;
     
     /* Play damage sound */
     play_sound(SOUND_DAMAGE, 2);  /* priority 2 */
 }
 
-static void render_comic_hp_meter(void)
-{
-    uint8_t i;
-    uint16_t x_pos;
-    
-    /* Render exactly MAX_HP cells (cells 1 through MAX_HP) */
-    /* Cell N is at x = 240 + (N * 8) */
-    for (i = 1; i <= MAX_HP; i++) {
-        x_pos = 240 + (i * 8);
-        if (i <= comic_hp) {
-            /* Full cell */
-            blit_8x16_sprite(x_pos, 82, sprite_meter_full_8x16);
-        } else {
-            /* Empty cell */
-            blit_8x16_sprite(x_pos, 82, sprite_meter_empty_8x16);
-        }
-    }
-}
-
-/* address_of_tile_at_coordinates is now defined in physics.c */
-
 /*
  * blit_tile_to_map - Blit a single 16x16 tile to the pre-rendered map buffer
  * 
@@ -2607,10 +2564,10 @@ static void render_comic_hp_meter(void)
  *   tile_id = ID of tile in tileset (0-127)
  *   tile_x = column position in map (0-127)
  *   tile_y = row position in map (0-9)
- *   tileset_ptr = pointer to tileset graphics data
+ *   tileset_ptr = pointer to tileset graphics data (plane-major, see TILESET_ROW_OFFSET)
  * 
  * The tileset contains up to 128 tiles, each 16x16 pixels.
- * Each tile is 128 bytes (32 bytes per plane × 4 planes).
+ * Each tile plane is 16 rows of one 16-bit word.
  * The rendered map buffer is at 0xa000:4000, organized as:
  *   - Each screen row is 256 bytes (40 bytes per pixel row + padding)
  *   - 128 tiles per row (each tile is 2 bytes wide)
@@ -2624,32 +2581,23 @@ static void blit_tile_to_map(uint8_t tile_id, uint8_t tile_x, uint8_t tile_y, co
 {
     uint8_t plane;
     uint8_t row;
-    uint16_t src_offset;
+    const uint16_t *src_rows;
     uint16_t dst_offset;
-    uint8_t byte0, byte1;
     uint8_t __far *dst_ptr;
     
     /* For each plane */
     for (plane = 0; plane < 4; plane++) {
         /* Set plane mask */
-        outp(0x3c4, 0x02);           /* Write to Sequencer Index register */
-        outp(0x3c5, 1 << plane);     /* Write plane mask to Sequencer Data register */
+        VRAM_OUTP(0x3c4, 0x02);           /* Write to Sequencer Index register */
+        VRAM_OUTP(0x3c5, 1 << plane);     /* Write plane mask to Sequencer Data register */
 
         /* Minimal synchronization to ensure sequencer register write completes
          * before accessing video memory. A single I/O read is sufficient on
          * standard VGA/EGA hardware and avoids millisecond-scale delays. */
         (void)inp(0x3DA);            /* Read from VGA status register */
         /* For each row in the tile */
+        src_rows = (const uint16_t *)&tileset_ptr[TILESET_ROW_OFFSET(tile_id, plane, 0)];
         for (row = 0; row < 16; row++) {
-            /* Source offset in tileset_ptr:
-             * Tile ID selects base: tile_id * 128
-             * Plane selects within tile: plane * 32
-             * Row selects within plane: row * 2
-             */
-            src_offset = (tile_id * 128) + (plane * 32) + (row * 2);
-            byte0 = tileset_ptr[src_offset + 0];
-            byte1 = tileset_ptr[src_offset + 1];
-            
             /* Destination offset in RENDERED_MAP_BUFFER:
              * Base position for this tile: (tile_y * 16 * 256) + (tile_x * 2)
              * Plus row offset: row * 256
@@ -2657,58 +2605,194 @@ static void blit_tile_to_map(uint8_t tile_id, uint8_t tile_x, uint8_t tile_y, co
             dst_offset = RENDERED_MAP_BUFFER + (tile_y * 16 * 256) + (tile_x * 2) + (row * 256);
             dst_ptr = (uint8_t __far *)MK_FP(VIDEO_MEMORY_BASE, dst_offset);
             
-            /* Write the bytes */
-            dst_ptr[0] = byte0;
-            dst_ptr[1] = byte1;
+            /* One word store per pixel row (left byte at the lower address) */
+            VRAM_WRITE16(dst_ptr, src_rows[row]);
         }
     }
 }
 
 /*
- * render_map - Pre-render entire tileset into RENDERED_MAP_BUFFER
+ * Lazy map rendering
  * 
- * Iterates through the current level's tile map and renders all tiles
- * into RENDERED_MAP_BUFFER (0xa000:4000). This buffer is then used by
- * blit_map_playfield_offscreen() to render the visible portion each frame.
+ * render_map() renders only the tile columns under and next to the camera
+ * window into RENDERED_MAP_BUFFER. The rest of the 128 columns are rendered
+ * one at a time by render_map_idle() while game_loop waits for the next
+ * tick, ahead of the camera's direction of travel first. Before the
+ * playfield is copied out of the buffer, ensure_map_window_rendered()
+ * renders any visible column that is still missing, so a fast scroll or a
+ * teleport never shows stale map data.
+ */
+#define MAP_RENDER_MARGIN_COLUMNS  2  /* Columns rendered on each side of the window at load */
+
+static uint8_t map_column_rendered[MAP_WIDTH_TILES];
+static uint8_t map_columns_pending = 0;
+static int8_t map_render_direction = 1;      /* +1 = camera moving right, -1 = left */
+static uint16_t map_render_camera_x = 0;     /* camera_x when the direction was last updated */
+
+/*
+ * render_map_column - Render one 16-pixel tile column into RENDERED_MAP_BUFFER
  * 
- * Preconditions:
- *   - current_tiles_ptr must point to a valid tile map (128×10)
- *   - tileset_graphics[] must contain loaded tileset data
- *   - RENDERED_MAP_BUFFER region must be accessible
+ * Input:
+ *   tile_x = column in the tile map (0-127)
+ * 
+ * Renders all 10 tile rows (160 pixel rows) of the column in all four
+ * planes. Does nothing if the column is already rendered.
  */
-static void render_map(void)
+static void render_map_column(uint8_t tile_x)
 {
     uint8_t plane;
     uint8_t tile_y;
-    uint8_t tile_x;
     uint8_t pixel_row;
-    uint16_t map_row_base;
-    uint16_t src_offset;
-    uint16_t dst_offset;
     uint8_t tile_id;
-    const uint8_t *tile_map_row;
-    uint8_t __far *dst_row;
+    const uint16_t *plane_rows;
+    const uint16_t *tile_src;
+    uint8_t __far *dst;
+
+    if (map_column_rendered[tile_x]) {
+        return;
+    }
 
-    /* Render directly into all 160x256 bytes per plane. No explicit clear pass is
-     * needed because every byte in the rendered-map region is overwritten below. */
     for (plane = 0; plane < 4; plane++) {
-        outp(0x3c4, 0x02);       /* SC Index: Map Mask */
-        outp(0x3c5, 1 << plane); /* SC Data: plane mask */
+        VRAM_OUTP(0x3c4, 0x02);       /* SC Index: Map Mask */
+        VRAM_OUTP(0x3c5, 1 << plane); /* SC Data: plane mask */
 
+        /* The transposed tileset makes each plane a table of 16-bit pixel rows */
+        plane_rows = (const uint16_t *)&GAME->tileset_graphics[TILESET_ROW_OFFSET(0, plane, 0)];
+        dst = (uint8_t __far *)MK_FP(VIDEO_MEMORY_BASE, RENDERED_MAP_BUFFER + (uint16_t)tile_x * 2);
         for (tile_y = 0; tile_y < MAP_HEIGHT_TILES; tile_y++) {
-            map_row_base = (uint16_t)tile_y * MAP_WIDTH_TILES;
-            tile_map_row = (current_tiles_ptr != NULL) ? (current_tiles_ptr + map_row_base) : NULL;
+            tile_id = (GAME->current_tiles_ptr != NULL) ? tile_id_at(tile_x, tile_y) : 0;
+            tile_src = plane_rows + (uint16_t)tile_id * 16;
 
             for (pixel_row = 0; pixel_row < 16; pixel_row++) {
-                dst_offset = RENDERED_MAP_BUFFER + (((uint16_t)tile_y * 16 + pixel_row) << 8);
-                dst_row = (uint8_t __far *)MK_FP(VIDEO_MEMORY_BASE, dst_offset);
-
-                for (tile_x = 0; tile_x < MAP_WIDTH_TILES; tile_x++) {
-                    tile_id = (tile_map_row != NULL) ? tile_map_row[tile_x] : 0;
-                    src_offset = (uint16_t)tile_id * 128 + (uint16_t)plane * 32 + (uint16_t)pixel_row * 2;
-                    *dst_row++ = tileset_graphics[src_offset + 0];
-                    *dst_row++ = tileset_graphics[src_offset + 1];
-                }
+                VRAM_WRITE16(dst, *tile_src++);
+                dst += 256;
+            }
+        }
+    }
+
+    map_column_rendered[tile_x] = 1;
+    map_columns_pending--;
+}
+
+/*
+ * render_map_columns - Render an inclusive range of tile columns, clamped to the map
+ */
+static void render_map_columns(int16_t first, int16_t last)
+{
+    int16_t tile_x;
+
+    if (first < 0) {
+        first = 0;
+    }
+    if (last > MAP_WIDTH_TILES - 1) {
+        last = MAP_WIDTH_TILES - 1;
+    }
+    for (tile_x = first; tile_x <= last; tile_x++) {
+        render_map_column((uint8_t)tile_x);
+    }
+}
+
+/*
+ * render_map - Start rendering the current stage into RENDERED_MAP_BUFFER
+ * 
+ * Renders the columns visible at the current camera_x plus
+ * MAP_RENDER_MARGIN_COLUMNS on each side, and leaves the rest for
+ * render_map_idle(). This buffer is then used by
+ * blit_map_playfield_offscreen() to render the visible portion each frame.
+ * 
+ * Preconditions:
+ *   - current_tiles_ptr must point to a valid tile map (128×10)
+ *   - tileset_graphics[] must contain loaded tileset data
+ *   - camera_x must already be set for the new stage
+ */
+static void render_map(void)
+{
+    int16_t first;
+    int16_t last;
+
+    TRACE_BEGIN(RENDER_MAP, GAME->camera_x);
+
+    /* Both pages' playfields are stale relative to the new map */
+    dirty_rects_invalidate();
+
+    memset(map_column_rendered, 0, sizeof(map_column_rendered));
+    map_columns_pending = MAP_WIDTH_TILES;
+
+    /* Render ahead in the direction Comic is facing until the camera moves */
+    map_render_direction = (GAME->comic_facing == COMIC_FACING_LEFT) ? -1 : 1;
+    map_render_camera_x = GAME->camera_x;
+
+    first = (int16_t)(GAME->camera_x / 2) - MAP_RENDER_MARGIN_COLUMNS;
+    last = (int16_t)((GAME->camera_x + PLAYFIELD_WIDTH - 1) / 2) + MAP_RENDER_MARGIN_COLUMNS;
+    render_map_columns(first, last);
+    TRACE_END(RENDER_MAP);
+}
+
+/*
+ * ensure_map_window_rendered - Render any missing column under the camera
+ * 
+ * Also records which way the camera last moved so render_map_idle() works
+ * ahead of it.
+ */
+static void ensure_map_window_rendered(void)
+{
+    if (GAME->camera_x > map_render_camera_x) {
+        map_render_direction = 1;
+    } else if (GAME->camera_x < map_render_camera_x) {
+        map_render_direction = -1;
+    }
+    map_render_camera_x = GAME->camera_x;
+
+    if (map_columns_pending == 0) {
+        return;
+    }
+    render_map_columns((int16_t)(GAME->camera_x / 2), (int16_t)((GAME->camera_x + PLAYFIELD_WIDTH - 1) / 2));
+}
+
+/*
+ * render_map_idle - Render one more map column during the tick wait
+ * 
+ * Picks the nearest unrendered column ahead of the camera window in the
+ * direction of travel; once that side is done, works behind the window.
+ * One column is 1280 bytes of video writes, well inside a tick.
+ */
+static void render_map_idle(void)
+{
+    int16_t first;
+    int16_t last;
+    int16_t tile_x;
+
+    if (map_columns_pending == 0) {
+        return;
+    }
+
+    first = (int16_t)(GAME->camera_x / 2);
+    last = (int16_t)((GAME->camera_x + PLAYFIELD_WIDTH - 1) / 2);
+
+    if (map_render_direction > 0) {
+        for (tile_x = first; tile_x < MAP_WIDTH_TILES; tile_x++) {
+            if (!map_column_rendered[tile_x]) {
+                render_map_column((uint8_t)tile_x);
+                return;
+            }
+        }
+        for (tile_x = first - 1; tile_x >= 0; tile_x--) {
+            if (!map_column_rendered[tile_x]) {
+                render_map_column((uint8_t)tile_x);
+                return;
+            }
+        }
+    } else {
+        for (tile_x = last; tile_x >= 0; tile_x--) {
+            if (!map_column_rendered[tile_x]) {
+                render_map_column((uint8_t)tile_x);
+                return;
+            }
+        }
+        for (tile_x = last + 1; tile_x < MAP_WIDTH_TILES; tile_x++) {
+            if (!map_column_rendered[tile_x]) {
+                render_map_column((uint8_t)tile_x);
+                return;
             }
         }
     }
@@ -2722,7 +2806,7 @@ static void render_map(void)
  * 
  * This function should:
  * 1. Set current_tiles_ptr and current_stage_ptr based on current_stage_number
- * 2. Call render_map to display the stage background
+ * 2. Call render_map to start rendering the stage background
  * 3. Handle door entry: if arriving via door (source_door_*), find the reciprocal door
  *    and position Comic in front of it; otherwise use comic_y_checkpoint/comic_x_checkpoint
  * 4. Clear comic_is_teleporting flag (may be set if respawning mid-teleport)
@@ -2744,49 +2828,52 @@ void load_new_stage(void)
     const stage_t *current_stage_ptr;
     int cam_x;
     
+    /* A stage load is a stall already: write out the buffered log */
+    LOG_DEBUG(STAGE_LOAD, GAME->current_level_number, GAME->current_stage_number, 0);
+    log_flush();
+    write_lag_status();
+    TRACE_BEGIN(LOAD_NEW_STAGE, GAME->current_stage_number);
+
     /* Get the current level data pointer */
-    if (current_level_number < 8) {
+    if (GAME->current_level_number < 8) {
         /* Use the global current_level_ptr, which is accessible to physics.c */
-        current_level_ptr = level_data_pointers[current_level_number];
+        GAME->current_level_ptr = level_data_pointers[GAME->current_level_number];
     } else {
+        TRACE_END(LOAD_NEW_STAGE);
         return;  /* Invalid level */
     }
     
     /* Ensure the level data pointer is valid before using it */
-    if (current_level_ptr == NULL) {
-        current_tiles_ptr = NULL;
+    if (GAME->current_level_ptr == NULL) {
+        GAME->current_tiles_ptr = NULL;
+        tile_query_build();
+        TRACE_END(LOAD_NEW_STAGE);
         return;
     }
     
     /* Set current_tiles_ptr based on current stage (0, 1, or 2) */
-    if (current_stage_number < 3) {
-        current_stage_ptr = &current_level_ptr->stages[current_stage_number];
+    if (GAME->current_stage_number < 3) {
+        current_stage_ptr = &GAME->current_level_ptr->stages[GAME->current_stage_number];
         
         /* Determine which tile map to use */
-        if (current_stage_number == 0) {
-            current_tiles_ptr = pt0.tiles;
-        } else if (current_stage_number == 1) {
-            current_tiles_ptr = pt1.tiles;
-        } else {
-            current_tiles_ptr = pt2.tiles;
-        }
+        GAME->current_tiles_ptr = stage_tiles(GAME->current_stage_number);
         
         /* Initialize Comic's position based on entry method */
-        if (source_door_level_number >= 0) {
+        if (GAME->source_door_level_number >= 0) {
             /* Entering via a door: search for reciprocal door and spawn at door.x + 1 */
             int i;
             int door_found = 0;
             
             for (i = 0; i < 3; i++) {
-                if (current_stage_ptr->doors[i].target_level == source_door_level_number &&
-                    current_stage_ptr->doors[i].target_stage == source_door_stage_number) {
+                if (current_stage_ptr->doors[i].target_level == GAME->source_door_level_number &&
+                    current_stage_ptr->doors[i].target_stage == GAME->source_door_stage_number) {
                     /* Found reciprocal door */
-                    comic_y = current_stage_ptr->doors[i].y;
-                    comic_x = current_stage_ptr->doors[i].x + 1;
+                    GAME->comic_y = current_stage_ptr->doors[i].y;
+                    GAME->comic_x = current_stage_ptr->doors[i].x + 1;
                     
                     /* Update checkpoint for respawn */
-                    comic_y_checkpoint = comic_y;
-                    comic_x_checkpoint = comic_x;
+                    GAME->comic_y_checkpoint = GAME->comic_y;
+                    GAME->comic_x_checkpoint = GAME->comic_x;
                     
                     door_found = 1;
                     break;
@@ -2795,62 +2882,63 @@ void load_new_stage(void)
             
             if (!door_found) {
                 /* Panic: no reciprocal door found (shouldn't happen) */
-                comic_x = 12;
-                comic_y = 8;
+                GAME->comic_x = 12;
+                GAME->comic_y = 8;
             }
         } else {
             /* Entering via left/right boundary or first spawn: use checkpoint */
-            comic_y = comic_y_checkpoint;
-            comic_x = comic_x_checkpoint;
+            GAME->comic_y = GAME->comic_y_checkpoint;
+            GAME->comic_x = GAME->comic_x_checkpoint;
         }
         
         /* Initialize Comic's physics state
          * Start with Comic standing (not falling), let the game loop detect if he needs to fall */
-        comic_is_falling_or_jumping = 0;
-        comic_y_vel = 0;  /* Start at rest */
-        comic_jump_counter = 0;  /* Jump counter will be reinitialized when needed */
+        GAME->comic_is_falling_or_jumping = 0;
+        GAME->comic_y_vel = 0;  /* Start at rest */
+        GAME->comic_jump_counter = 0;  /* Jump counter will be reinitialized when needed */
         
         /* Initialize camera to center on Comic, clamped to valid range.
          * Formula: camera_x = clamp(comic_x - (PLAYFIELD_WIDTH/2 - 1), 0, MAP_WIDTH - PLAYFIELD_WIDTH)
          * This positions the camera so Comic is centered in the playfield. */
-        cam_x = (int)comic_x - (PLAYFIELD_WIDTH / 2 - 1);
+        cam_x = (int)GAME->comic_x - (PLAYFIELD_WIDTH / 2 - 1);
         if (cam_x < 0) {
-            camera_x = 0;
+            GAME->camera_x = 0;
         } else if (cam_x > MAP_WIDTH - PLAYFIELD_WIDTH) {
-            camera_x = MAP_WIDTH - PLAYFIELD_WIDTH;
+            GAME->camera_x = MAP_WIDTH - PLAYFIELD_WIDTH;
         } else {
-            camera_x = (uint16_t)cam_x;
+            GAME->camera_x = (uint16_t)cam_x;
         }
     } else {
-        current_tiles_ptr = NULL;
+        GAME->current_tiles_ptr = NULL;
     }
+    tile_query_build();
     
     /* Initialize enemies from stage data */
-    if (current_stage_number < 3 && current_stage_ptr != NULL) {
+    if (GAME->current_stage_number < 3 && current_stage_ptr != NULL) {
         int i;
         for (i = 0; i < MAX_NUM_ENEMIES; i++) {
             const enemy_record_t *enemy_rec = &current_stage_ptr->enemies[i];
             
             /* Copy enemy definition data */
-            enemies[i].behavior = enemy_rec->behavior;
-            enemy_shp_index[i] = enemy_rec->shp_index;
-            enemies[i].num_animation_frames = shp_get_animation_length(enemy_rec->shp_index);
-            if (enemies[i].num_animation_frames == 0) {
-                enemies[i].num_animation_frames = 1;
+            GAME->enemies[i].behavior = enemy_rec->behavior;
+            GAME->enemy_shp_index[i] = enemy_rec->shp_index;
+            GAME->enemies[i].num_animation_frames = shp_get_animation_length(enemy_rec->shp_index);
+            if (GAME->enemies[i].num_animation_frames == 0) {
+                GAME->enemies[i].num_animation_frames = 1;
             }
-            enemies[i].animation_frames_ptr = 0; /* TODO: Set from SHP file */
+            GAME->enemies[i].animation_frames_ptr = 0; /* TODO: Set from SHP file */
             
             /* Initialize spawn state */
-            enemies[i].state = ENEMY_STATE_DESPAWNED;
-            enemies[i].facing = COMIC_FACING_LEFT;
-            enemies[i].spawn_timer_and_animation = 20; /* Spawn after 20 ticks */
-            enemies[i].restraint = 0;
+            GAME->enemies[i].state = ENEMY_STATE_DESPAWNED;
+            GAME->enemies[i].facing = COMIC_FACING_LEFT;
+            GAME->enemies[i].spawn_timer_and_animation = 20; /* Spawn after 20 ticks */
+            GAME->enemies[i].restraint = 0;
             
             /* Clear position and velocity */
-            enemies[i].x = 0;
-            enemies[i].y = 0;
-            enemies[i].x_vel = 0;
-            enemies[i].y_vel = 0;
+            GAME->enemies[i].x = 0;
+            GAME->enemies[i].y = 0;
+            GAME->enemies[i].x_vel = 0;
+            GAME->enemies[i].y_vel = 0;
         }
     }
     
@@ -2858,19 +2946,19 @@ void load_new_stage(void)
     {
         int i;
         for (i = 0; i < MAX_NUM_FIREBALLS; i++) {
-            fireballs[i].x = FIREBALL_DEAD;
-            fireballs[i].y = FIREBALL_DEAD;
-            fireballs[i].vel = 0;
-            fireballs[i].corkscrew_phase = 0;
-            fireballs[i].animation = 0;
-            fireballs[i].num_animation_frames = 2;
+            GAME->fireballs[i].x = FIREBALL_DEAD;
+            GAME->fireballs[i].y = FIREBALL_DEAD;
+            GAME->fireballs[i].vel = 0;
+            GAME->fireballs[i].corkscrew_phase = 0;
+            GAME->fireballs[i].animation = 0;
+            GAME->fireballs[i].num_animation_frames = 2;
         }
     }
     
     /* Clear teleporting flag */
-    comic_is_teleporting = 0;
+    GAME->comic_is_teleporting = 0;
     
-    /* Pre-render the entire map into RENDERED_MAP_BUFFER */
+    /* Render the map around the camera; game_loop's idle time does the rest */
     render_map();
 
 #ifdef ENABLE_SHP_SMOKE_TEST
@@ -2886,15 +2974,96 @@ void load_new_stage(void)
 #endif
 
     /* Play beam-in animation on first spawn (source_door_level_number == -2) */
-    if (source_door_level_number == -2) {
+    if (GAME->source_door_level_number == -2) {
         beam_in();
-    } else if (source_door_level_number >= 0) {
+    } else if (GAME->source_door_level_number >= 0) {
         /* Entered via door: play exit door animation */
         exit_door_animation();
     }
     
     /* Reset source_door_level_number to -1 (normal entry) for future transitions */
-    source_door_level_number = -1;
+    GAME->source_door_level_number = -1;
+    TRACE_END(LOAD_NEW_STAGE);
+}
+
+/*
+ * stage_tiles - Tile map of a stage of the loaded level
+ * 
+ * Returns:
+ *   One of pt0/pt1/pt2's tiles, or NULL for an invalid stage number
+ */
+static uint8_t *stage_tiles(uint8_t stage_number)
+{
+    switch (stage_number) {
+    case 0:
+        return GAME->pt0.tiles;
+    case 1:
+        return GAME->pt1.tiles;
+    case 2:
+        return GAME->pt2.tiles;
+    default:
+        return NULL;
+    }
+}
+
+/*
+ * render_lives_display - Redraw every life icon into both pages
+ * 
+ * Life icons are normally drawn one at a time as lives change; this draws
+ * them all from the current game state.
+ */
+static void render_lives_display(void)
+{
+    uint8_t i;
+
+    for (i = 1; i <= MAX_NUM_LIVES; i++) {
+        blit_sprite_16x16_masked_both_pages(24 + i * 24, 180,
+            i <= GAME->comic_num_lives ? sprite_life_icon_bright : sprite_life_icon_dark);
+    }
+}
+
+/*
+ * restore_stage_view - Rebuild loaded data and the screen for a replaced game state
+ * 
+ * Input:
+ *   level_changed = the level number differs from the one loaded
+ *   stage_changed = the stage number differs from the one rendered
+ *   lives_shown   = life icons lit on screen (the replaced state's lives)
+ * 
+ * Called by snapshot_restore() after it has copied the saved state in.
+ * Reloads the level only if it changed, and re-renders the map only if
+ * the stage changed. Items, the Blastola Cola and lit life icons can only
+ * be erased by reloading the UI background, so that is done only when the
+ * restored game has fewer of them than the screen shows; otherwise they
+ * are drawn over their matching icons, and the score and meters redraw in
+ * full after ui_reset(). The playfield is redrawn in full on the next
+ * tick.
+ * 
+ * Returns:
+ *   0 on success, -1 if the level could not be loaded
+ */
+int restore_stage_view(uint8_t level_changed, uint8_t stage_changed, uint8_t lives_shown)
+{
+    if (level_changed && load_new_level() != 0) {
+        return -1;
+    }
+    GAME->current_level_ptr = level_data_pointers[GAME->current_level_number];
+    GAME->current_tiles_ptr = stage_tiles(GAME->current_stage_number);
+    tile_query_build();
+
+    if (level_changed || stage_changed) {
+        render_map();
+    }
+
+    if (ui_shows_more() || GAME->comic_num_lives < lives_shown) {
+        if (load_fullscreen_graphic(FILENAME_UI_GRAPHIC, GRAPHICS_BUFFER_GAMEPLAY_A) == 0) {
+            copy_ega_plane(GRAPHICS_BUFFER_GAMEPLAY_A, GRAPHICS_BUFFER_GAMEPLAY_B, 8000);
+        }
+    }
+    dirty_rects_invalidate();
+    ui_reset();
+    render_lives_display();
+    return 0;
 }
 
 /*
@@ -2952,8 +3121,8 @@ void comic_death_animation(void)
         /* Calculate Comic's pixel position for blitting the death animation.
          * Add +8 offsets to align within the playfield (top-left at 8,8),
          * matching blit_comic_playfield_offscreen and enemy rendering. */
-        pixel_x = (((int16_t)comic_x - (int16_t)camera_x) * 8) + 8;
-        pixel_y = ((int16_t)comic_y * 8) + 8;
+        pixel_x = (((int16_t)GAME->comic_x - (int16_t)GAME->camera_x) * 8) + 8;
+        pixel_y = ((int16_t)GAME->comic_y * 8) + 8;
         
         /* Blit the death animation frame with transparency to the offscreen buffer */
         blit_sprite_16x32_masked((uint16_t)pixel_x, (uint16_t)pixel_y, death_frame_ptr);
@@ -2971,7 +3140,7 @@ void comic_death_animation(void)
     /* Clear comic_animation to prevent any sprite rendering.
      * Set to COMIC_ANIMATION_NONE rather than 0 (COMIC_STANDING) to ensure
      * blit_comic_playfield_offscreen() returns early without rendering anything. */
-    comic_animation = COMIC_ANIMATION_NONE;
+    GAME->comic_animation = COMIC_ANIMATION_NONE;
 }
 
 /*
@@ -2992,21 +3161,21 @@ void comic_death_animation(void)
 void comic_dies(void)
 {
     /* Check if we're coming from the death animation (enemy collision) */
-    if (comic_death_animation_finished == 0) {
+    if (GAME->comic_death_animation_finished == 0) {
         /* This is a falling death - show Comic partially visible as he falls off */
         uint16_t visible_height;
         int rel_x_units;
         int visible_units;
         
-        comic_animation = COMIC_JUMPING;
+        GAME->comic_animation = COMIC_JUMPING;
         
-        if (comic_y < PLAYFIELD_HEIGHT) {
+        if (GAME->comic_y < PLAYFIELD_HEIGHT) {
             /* Calculate how many pixels of the sprite are actually visible on screen.
              * Playfield height = 20 units = 160 pixels. If Comic is at unit Y position,
              * then visible_height (in pixels) = (20 - comic_y) * 8.
              * This represents how much of the sprite is above the playfield bottom.
              * Safe calculation: compute visible units first, then convert to pixels. */
-            visible_units = PLAYFIELD_HEIGHT - (int)comic_y;
+            visible_units = PLAYFIELD_HEIGHT - (int)GAME->comic_y;
             visible_height = (uint16_t)(visible_units * 8);
             
             /* Clamp to sprite height (32 pixels) */
@@ -3016,7 +3185,7 @@ void comic_dies(void)
             
             /* Bounds check: Only render if Comic is within horizontal playfield bounds.
              * rel_x_units must be >= 0 (not left of camera) and < PLAYFIELD_WIDTH (not right of camera) */
-            rel_x_units = (int)comic_x - (int)camera_x;
+            rel_x_units = (int)GAME->comic_x - (int)GAME->camera_x;
             if (rel_x_units >= 0 && rel_x_units < PLAYFIELD_WIDTH) {
                 /* Blit the map and clipped Comic sprite.
                  * Note: blit_comic_partial_playfield_offscreen only renders if visible_height >= 32
@@ -3036,7 +3205,7 @@ void comic_dies(void)
         /* Enemy collision death - set animation to a sentinel invalid value.
          * Note: COMIC_ANIMATION_NONE is used here as a non-playable state; actual rendering
          * behavior for this value is controlled by the blitting routines elsewhere. */
-        comic_animation = COMIC_ANIMATION_NONE;
+        GAME->comic_animation = COMIC_ANIMATION_NONE;
     }
     
     /* Common path for both death types */
@@ -3056,26 +3225,26 @@ void comic_dies(void)
     lose_a_life();
     
     /* Clear the death animation finished flag for next death */
-    comic_death_animation_finished = 0;
+    GAME->comic_death_animation_finished = 0;
     
     /* Check if any lives remain */
-    if (comic_num_lives == 0) {
+    if (GAME->comic_num_lives == 0) {
         /* No lives left - show game over screen */
         game_over();
         return;
     }
     
     /* Reset core movement/animation state for respawn (match assembly intent) */
-    comic_run_cycle = 0;
-    comic_x_momentum = 0;
-    comic_animation = COMIC_STANDING;
+    GAME->comic_run_cycle = 0;
+    GAME->comic_x_momentum = 0;
+    GAME->comic_animation = COMIC_STANDING;
     
     /* HP refill behavior on respawn: keep visible meter state and only refill missing cells */
     /* This preserves the current HP display and avoids bonus points while refilling */
-    comic_hp_pending_increase = (comic_hp < MAX_HP) ? (MAX_HP - comic_hp) : 0;
+    GAME->comic_hp_pending_increase = (GAME->comic_hp < MAX_HP) ? (MAX_HP - GAME->comic_hp) : 0;
     
     /* Reset fireball meter counter per assembly */
-    fireball_meter_counter = 2;
+    GAME->fireball_meter_counter = 2;
     
     /* Reload stage to position Comic at checkpoint, clamp camera, and redraw.
      * Note: load_new_stage() will reset physics state (falling/jumping, y_vel, jump_counter)
@@ -3107,7 +3276,7 @@ static void blit_game_over_graphic(uint16_t pixel_offset)
         uint8_t col;
         uint8_t plane_index;
         const uint8_t *src;
-        uint8_t __far *video_mem = (uint8_t __far *)0xa0000000L;
+        uint8_t __far *video_mem = (uint8_t __far *)MK_FP(VIDEO_MEMORY_BASE, 0);
         
         /* Calculate plane index from plane mask (1->0, 2->1, 4->2, 8->3) */
         if (plane == 1) plane_index = 0;
@@ -3119,15 +3288,15 @@ static void blit_game_over_graphic(uint16_t pixel_offset)
         src = (const uint8_t *)sprite_R4_game_over_128x48 + (plane_index * 768);
         
         /* Set plane write mask for normal write mode (Write Mode 0) */
-        outp(0x3CE, 0x05);     /* GC Index: Graphics Mode */
-        outp(0x3CF, 0x00);     /* Graphics Mode: Write Mode 0 (normal) */
-        outp(0x3C4, 0x02);     /* SC Index: Map Mask */
-        outp(0x3C5, plane);    /* Map Mask: write to current plane only */
+        VRAM_OUTP(0x3CE, 0x05);     /* GC Index: Graphics Mode */
+        VRAM_OUTP(0x3CF, 0x00);     /* Graphics Mode: Write Mode 0 (normal) */
+        VRAM_OUTP(0x3C4, 0x02);     /* SC Index: Map Mask */
+        VRAM_OUTP(0x3C5, plane);    /* Map Mask: write to current plane only */
         
         /* Blit the graphic */
         for (row = 0; row < 48; row++) {
             for (col = 0; col < 16; col++) {
-                video_mem[offscreen_video_buffer_ptr + dst_offset + col] = src[src_offset + col];
+                VRAM_WRITE(video_mem + offscreen_video_buffer_ptr + dst_offset + col, src[src_offset + col]);
             }
             src_offset += 16;
             dst_offset += SCREEN_WIDTH / 8;
@@ -3135,10 +3304,10 @@ static void blit_game_over_graphic(uint16_t pixel_offset)
     }
     
     /* Restore graphics mode to default */
-    outp(0x3CE, 0x05);
-    outp(0x3CF, 0x00);
-    outp(0x3C4, 0x02);
-    outp(0x3C5, 0x0F);
+    VRAM_OUTP(0x3CE, 0x05);
+    VRAM_OUTP(0x3CF, 0x00);
+    VRAM_OUTP(0x3C4, 0x02);
+    VRAM_OUTP(0x3C5, 0x0F);
 }
 
 /*
@@ -3254,14 +3423,14 @@ static void game_end_sequence(void)
         
         /* Update score display to show the points being added */
         blit_map_playfield_offscreen();
-        render_score_display();
+        ui_update();
         swap_video_buffers();
         
         wait_n_ticks(1);
     }
     
     /* Award points for remaining lives (10,000 points per life) */
-    while (comic_num_lives > 0) {
+    while (GAME->comic_num_lives > 0) {
         /* Award 10,000 points for this life (10 x 1,000 points) */
         for (points_awarded = 0; points_awarded < 10; points_awarded++) {
             /* Play score tally sound */
@@ -3270,7 +3439,7 @@ static void game_end_sequence(void)
             
             /* Update score display to show the points being added */
             blit_map_playfield_offscreen();
-            render_score_display();
+            ui_update();
             swap_video_buffers();
             
             wait_n_ticks(1);
@@ -3355,10 +3524,10 @@ void award_points(uint16_t points)
     uint8_t carry_into_byte1 = 0;
     
     /* Add points to byte[0] with carry propagation */
-    score_bytes[0] += (uint8_t)points;
-    if (score_bytes[0] >= 100) {
+    GAME->score_bytes[0] += (uint8_t)points;
+    if (GAME->score_bytes[0] >= 100) {
         carry = 1;
-        score_bytes[0] -= 100;
+        GAME->score_bytes[0] -= 100;
         carry_into_byte1 = 1;
     } else {
         carry = 0;
@@ -3366,10 +3535,10 @@ void award_points(uint16_t points)
     
     /* Propagate carry through remaining bytes */
     for (i = 1; i < 3 && carry; i++) {
-        score_bytes[i] += carry;
-        if (score_bytes[i] >= 100) {
+        GAME->score_bytes[i] += carry;
+        if (GAME->score_bytes[i] >= 100) {
             carry = 1;
-            score_bytes[i] -= 100;
+            GAME->score_bytes[i] -= 100;
         } else {
             carry = 0;
         }
@@ -3380,9 +3549,9 @@ void award_points(uint16_t points)
      * above 99 did not produce a real score increment (the score has been
      * clamped), so it must not be counted for extra-life purposes. */
     if (carry) {
-        score_bytes[0] = 99;
-        score_bytes[1] = 99;
-        score_bytes[2] = 99;
+        GAME->score_bytes[0] = 99;
+        GAME->score_bytes[1] = 99;
+        GAME->score_bytes[2] = 99;
         carry_into_byte1 = 0;
     }
 
@@ -3390,9 +3559,9 @@ void award_points(uint16_t points)
      * Guard: carry_into_byte1 is 0 when the score was clamped above, so
      * overflow at max score never counts toward the extra-life threshold. */
     if (carry_into_byte1) {
-        score_10000_counter++;
-        if (score_10000_counter >= 5) {
-            score_10000_counter = 0;
+        GAME->score_10000_counter++;
+        if (GAME->score_10000_counter >= 5) {
+            GAME->score_10000_counter = 0;
             award_extra_life();
         }
     }
@@ -3406,7 +3575,7 @@ void award_points(uint16_t points)
  */
 static void clear_bios_keyboard_buffer(void)
 {
-    uint8_t __far *bios_data = (uint8_t __far *)0x00000000L;
+    uint8_t __far *bios_data = (uint8_t __far *)MK_FP(0x0000, 0);
     uint16_t head = *(uint16_t __far *)(bios_data + BIOS_KEYBOARD_BUFFER_HEAD);
     *(uint16_t __far *)(bios_data + BIOS_KEYBOARD_BUFFER_TAIL) = head;
 }
@@ -3419,8 +3588,8 @@ static void clear_bios_keyboard_buffer(void)
  */
 static void clear_scancode_queue(void)
 {
-    scancode_queue_head = 0;
-    scancode_queue_tail = 0;
+    GAME->scancode_queue_head = 0;
+    GAME->scancode_queue_tail = 0;
 }
 
 /*
@@ -3460,84 +3629,84 @@ static void dos_idle(void)
 static void handle_cheat_codes(void)
 {
     /* W key: Grant teleport wand (edge-triggered on press) */
-    if (key_state_cheat_wand && !previous_key_state_cheat_wand) {
-        if (comic_has_teleport_wand == 0) {
-            comic_has_teleport_wand = 1;
+    if (GAME->key_state_cheat_wand && !GAME->previous_key_state_cheat_wand) {
+        if (GAME->comic_has_teleport_wand == 0) {
+            GAME->comic_has_teleport_wand = 1;
             /* Play item collection sound for feedback */
             play_sound(SOUND_COLLECT_ITEM, 3);
         }
     }
     
     /* K key: Grant door key (edge-triggered on press) */
-    if (key_state_cheat_key && !previous_key_state_cheat_key) {
-        if (comic_has_door_key == 0) {
-            comic_has_door_key = 1;
+    if (GAME->key_state_cheat_key && !GAME->previous_key_state_cheat_key) {
+        if (GAME->comic_has_door_key == 0) {
+            GAME->comic_has_door_key = 1;
             /* Play item collection sound for feedback */
             play_sound(SOUND_COLLECT_ITEM, 3);
         }
     }
     
     /* B key: Grant Blastola Cola (edge-triggered on press) */
-    if (key_state_cheat_cola && !previous_key_state_cheat_cola) {
-        if (comic_firepower < MAX_NUM_FIREBALLS) {
-            comic_firepower++;
+    if (GAME->key_state_cheat_cola && !GAME->previous_key_state_cheat_cola) {
+        if (GAME->comic_firepower < MAX_NUM_FIREBALLS) {
+            GAME->comic_firepower++;
             /* Play item collection sound for feedback */
             play_sound(SOUND_COLLECT_ITEM, 3);
         }
     }
     
     /* C key: Grant Corkscrew (edge-triggered on press) */
-    if (key_state_cheat_corkscrew && !previous_key_state_cheat_corkscrew) {
-        if (comic_has_corkscrew == 0) {
-            comic_has_corkscrew = 1;
+    if (GAME->key_state_cheat_corkscrew && !GAME->previous_key_state_cheat_corkscrew) {
+        if (GAME->comic_has_corkscrew == 0) {
+            GAME->comic_has_corkscrew = 1;
             /* Play item collection sound for feedback */
             play_sound(SOUND_COLLECT_ITEM, 3);
         }
     }
     
     /* O key: Grant Boots (edge-triggered on press) */
-    if (key_state_cheat_boots && !previous_key_state_cheat_boots) {
-        if (comic_jump_power < 5) {
-            comic_jump_power = 5;
+    if (GAME->key_state_cheat_boots && !GAME->previous_key_state_cheat_boots) {
+        if (GAME->comic_jump_power < 5) {
+            GAME->comic_jump_power = 5;
             /* Play item collection sound for feedback */
             play_sound(SOUND_COLLECT_ITEM, 3);
         }
     }
     
     /* L key: Grant Lantern (edge-triggered on press) */
-    if (key_state_cheat_lantern && !previous_key_state_cheat_lantern) {
-        if (comic_has_lantern == 0) {
-            comic_has_lantern = 1;
+    if (GAME->key_state_cheat_lantern && !GAME->previous_key_state_cheat_lantern) {
+        if (GAME->comic_has_lantern == 0) {
+            GAME->comic_has_lantern = 1;
             /* Play item collection sound for feedback */
             play_sound(SOUND_COLLECT_ITEM, 3);
         }
     }
     
     /* S key: Grant Shield (edge-triggered on press) */
-    if (key_state_cheat_shield && !previous_key_state_cheat_shield) {
+    if (GAME->key_state_cheat_shield && !GAME->previous_key_state_cheat_shield) {
         /* Shield starts an HP refill via pending increase.
          * Note: Unlike item collection, this cheat can be used repeatedly to grant
          * multiple extra lives if Comic is at full HP. This is intentional for testing
          * purposes - cheat codes provide more flexible testing than item mechanics. */
-        if (comic_hp >= MAX_HP) {
+        if (GAME->comic_hp >= MAX_HP) {
             /* Full HP: award an extra life */
             award_extra_life();
         } else {
             /* Not full: schedule only the missing HP increments */
-            comic_hp_pending_increase = MAX_HP - comic_hp;
+            GAME->comic_hp_pending_increase = MAX_HP - GAME->comic_hp;
         }
         /* Play item collection sound for feedback */
         play_sound(SOUND_COLLECT_ITEM, 3);
     }
     
     /* P key: Warp to next level (edge-triggered on press) */
-    if (key_state_cheat_level && !previous_key_state_cheat_level) {
-        current_level_number = (current_level_number + 1) % 5;  /* 5 levels: 0-4 */
-        current_stage_number = 0;  /* Reset to first stage */
+    if (GAME->key_state_cheat_level && !GAME->previous_key_state_cheat_level) {
+        GAME->current_level_number = (GAME->current_level_number + 1) % 5;  /* 5 levels: 0-4 */
+        GAME->current_stage_number = 0;  /* Reset to first stage */
         /* Reset spawn position to default */
-        comic_x_checkpoint = 14;
-        comic_y_checkpoint = 12;
-        source_door_level_number = -1;  /* Not entering via door */
+        GAME->comic_x_checkpoint = 14;
+        GAME->comic_y_checkpoint = 12;
+        GAME->source_door_level_number = -1;  /* Not entering via door */
         load_new_level();
         load_new_stage();
         /* Play sound for feedback */
@@ -3545,8 +3714,8 @@ static void handle_cheat_codes(void)
     }
     
     /* Q key: Warp to next stage (edge-triggered on press) */
-    if (key_state_cheat_stage && !previous_key_state_cheat_stage) {
-        current_stage_number = (current_stage_number + 1) % 3;   /* 3 stages per level: 0-2 */
+    if (GAME->key_state_cheat_stage && !GAME->previous_key_state_cheat_stage) {
+        GAME->current_stage_number = (GAME->current_stage_number + 1) % 3;   /* 3 stages per level: 0-2 */
         load_new_stage();
         /* Play sound for feedback */
         play_sound(SOUND_STAGE_EDGE_TRANSITION, 4);
@@ -3569,6 +3738,10 @@ static void handle_cheat_codes(void)
  * - key_state_esc: Escape (quit)
  * 
  * Keymaps are loaded from KEYS.DEF if present; otherwise defaults are used.
+ * 
+ * At most REPLAY_MAX_TICK_SCANCODES scancodes are taken per tick; any more
+ * stay queued for the next tick. When recording, the scancodes taken are
+ * written to the replay as this tick's input.
  */
 static void update_keyboard_input(void)
 {
@@ -3576,66 +3749,122 @@ static void update_keyboard_input(void)
     uint8_t key_count = 0;
     uint8_t is_break;
     uint8_t code;
-    static uint8_t extended_prefix = 0;
+    uint8_t consumed[REPLAY_MAX_TICK_SCANCODES];
     
     /* Process all scancodes in the queue */
-    while (scancode_queue_head != scancode_queue_tail) {
+    while (GAME->scancode_queue_head != GAME->scancode_queue_tail && key_count < REPLAY_MAX_TICK_SCANCODES) {
         /* Get next scancode from queue */
-        scancode = scancode_queue[scancode_queue_tail];
-        scancode_queue_tail = (scancode_queue_tail + 1) % MAX_SCANCODE_QUEUE;
+        scancode = GAME->scancode_queue[GAME->scancode_queue_tail];
+        GAME->scancode_queue_tail = (GAME->scancode_queue_tail + 1) % MAX_SCANCODE_QUEUE;
         
-        key_count++;
+        consumed[key_count++] = scancode;
         
         if (scancode == 0xE0) {
-            extended_prefix = 1;
+            GAME->extended_prefix = 1;
             continue;
         }
 
         /* Handle break (key release) codes */
         is_break = (scancode & 0x80) != 0;
         code = scancode & 0x7F;
-        (void)extended_prefix; /* prefix retained for future use */
-        extended_prefix = 0;
+        (void)GAME->extended_prefix; /* prefix retained for future use */
+        GAME->extended_prefix = 0;
         
         /* Compare scancode with configured keymap */
-        if (code == keymap[0]) {
-            key_state_jump = (uint8_t)(!is_break);  /* SPACE */
-        } else if (code == keymap[1]) {
-            key_state_fire = (uint8_t)(!is_break);  /* INSERT */
-        } else if (code == keymap[2]) {
-            key_state_left = (uint8_t)(!is_break);  /* LEFT ARROW */
-        } else if (code == keymap[3]) {
-            key_state_right = (uint8_t)(!is_break); /* RIGHT ARROW */
-        } else if (code == keymap[4]) {
-            key_state_open = (uint8_t)(!is_break);  /* ALT */
-        } else if (code == keymap[5]) {
-            key_state_teleport = (uint8_t)(!is_break);  /* CAPSLOCK */
+        if (code == GAME->keymap[0]) {
+            GAME->key_state_jump = (uint8_t)(!is_break);  /* SPACE */
+        } else if (code == GAME->keymap[1]) {
+            GAME->key_state_fire = (uint8_t)(!is_break);  /* INSERT */
+        } else if (code == GAME->keymap[2]) {
+            GAME->key_state_left = (uint8_t)(!is_break);  /* LEFT ARROW */
+        } else if (code == GAME->keymap[3]) {
+            GAME->key_state_right = (uint8_t)(!is_break); /* RIGHT ARROW */
+        } else if (code == GAME->keymap[4]) {
+            GAME->key_state_open = (uint8_t)(!is_break);  /* ALT */
+        } else if (code == GAME->keymap[5]) {
+            GAME->key_state_teleport = (uint8_t)(!is_break);  /* CAPSLOCK */
             /* Detect edge transition: key pressed (break=0) and was previously released */
-            if (!is_break && !previous_key_state_teleport) {
-                teleport_key_pressed = 1;  /* Flag for game loop to process */
+            if (!is_break && !GAME->previous_key_state_teleport) {
+                GAME->teleport_key_pressed = 1;  /* Flag for game loop to process */
             }
         } else if (code == SCANCODE_ESC) {
-            key_state_esc = (uint8_t)(!is_break);  /* ESCAPE - hardcoded */
+            GAME->key_state_esc = (uint8_t)(!is_break);  /* ESCAPE - hardcoded */
         } else if (code == SCANCODE_W) {
-            key_state_cheat_wand = (uint8_t)(!is_break);  /* W key - cheat code */
+            GAME->key_state_cheat_wand = (uint8_t)(!is_break);  /* W key - cheat code */
         } else if (code == SCANCODE_K) {
-            key_state_cheat_key = (uint8_t)(!is_break);  /* K key - cheat code */
+            GAME->key_state_cheat_key = (uint8_t)(!is_break);  /* K key - cheat code */
         } else if (code == SCANCODE_B) {
-            key_state_cheat_cola = (uint8_t)(!is_break);  /* B key - cheat code */
+            GAME->key_state_cheat_cola = (uint8_t)(!is_break);  /* B key - cheat code */
         } else if (code == SCANCODE_C) {
-            key_state_cheat_corkscrew = (uint8_t)(!is_break);  /* C key - cheat code */
+            GAME->key_state_cheat_corkscrew = (uint8_t)(!is_break);  /* C key - cheat code */
         } else if (code == SCANCODE_O) {
-            key_state_cheat_boots = (uint8_t)(!is_break);  /* O key - cheat code */
+            GAME->key_state_cheat_boots = (uint8_t)(!is_break);  /* O key - cheat code */
         } else if (code == SCANCODE_L) {
-            key_state_cheat_lantern = (uint8_t)(!is_break);  /* L key - cheat code */
+            GAME->key_state_cheat_lantern = (uint8_t)(!is_break);  /* L key - cheat code */
         } else if (code == SCANCODE_S) {
-            key_state_cheat_shield = (uint8_t)(!is_break);  /* S key - cheat code */
+            GAME->key_state_cheat_shield = (uint8_t)(!is_break);  /* S key - cheat code */
         } else if (code == SCANCODE_P) {
-            key_state_cheat_level = (uint8_t)(!is_break);  /* P key - level warp cheat */
+            GAME->key_state_cheat_level = (uint8_t)(!is_break);  /* P key - level warp cheat */
         } else if (code == SCANCODE_Q) {
-            key_state_cheat_stage = (uint8_t)(!is_break);  /* Q key - stage warp cheat */
+            GAME->key_state_cheat_stage = (uint8_t)(!is_break);  /* Q key - stage warp cheat */
+        } else if (code == SCANCODE_F10) {
+            /* F10 toggles turbo mode on the press, ignoring typematic repeats */
+            if (!is_break && !GAME->key_state_turbo) {
+                GAME->turbo_mode = (uint8_t)!GAME->turbo_mode;
+            }
+            GAME->key_state_turbo = (uint8_t)(!is_break);
+        } else if (code == SCANCODE_F9) {
+            /* F9 steps back on every press and typematic repeat; replays
+             * must run exactly as recorded, so it does nothing there */
+            if (!is_break && GAME->replay.mode == REPLAY_OFF) {
+                GAME->rewind_key_pressed = 1;
+            }
+        } else if (code == SCANCODE_F8) {
+            if (!is_break) {
+                GAME->lag_status_key_pressed = 1;
+            }
         }
     }
+
+    if (GAME->replay.mode == REPLAY_RECORD) {
+        replay_record_tick(consumed, key_count);
+    }
+}
+
+/*
+ * feed_replay_tick - Replace live keyboard input with the next recorded tick
+ * 
+ * Live scancodes are discarded, except that pressing Escape ends playback.
+ * When the recording runs out (or is abandoned) the program ends.
+ */
+static void feed_replay_tick(void)
+{
+    uint8_t scancodes[REPLAY_MAX_TICK_SCANCODES];
+    int8_t count;
+    uint8_t abandon = 0;
+    uint8_t i;
+
+    _disable();
+    while (GAME->scancode_queue_head != GAME->scancode_queue_tail) {
+        if (GAME->scancode_queue[GAME->scancode_queue_tail] == SCANCODE_ESC) {
+            abandon = 1;
+        }
+        GAME->scancode_queue_tail = (GAME->scancode_queue_tail + 1) % MAX_SCANCODE_QUEUE;
+    }
+    _enable();
+
+    count = abandon ? -1 : replay_next_tick(scancodes);
+    if (count < 0) {
+        terminate_program();
+        return;
+    }
+
+    _disable();
+    for (i = 0; i < (uint8_t)count; i++) {
+        GAME->scancode_queue[GAME->scancode_queue_head] = scancodes[i];
+        GAME->scancode_queue_head = (GAME->scancode_queue_head + 1) % MAX_SCANCODE_QUEUE;
+    }
+    _enable();
 }
 
 /*
@@ -3650,12 +3879,12 @@ static void update_keyboard_input(void)
  */
 static void face_or_move_left(void)
 {
-    if (comic_facing == COMIC_FACING_LEFT) {
+    if (GAME->comic_facing == COMIC_FACING_LEFT) {
         /* Already facing left, so move left */
         move_left();
     } else {
         /* Facing right, so just change facing direction */
-        comic_facing = COMIC_FACING_LEFT;
+        GAME->comic_facing = COMIC_FACING_LEFT;
     }
 }
 
@@ -3671,300 +3900,517 @@ static void face_or_move_left(void)
  */
 static void face_or_move_right(void)
 {
-    if (comic_facing == COMIC_FACING_RIGHT) {
+    if (GAME->comic_facing == COMIC_FACING_RIGHT) {
         /* Already facing right, so move right */
         move_right();
     } else {
         /* Facing left, so just change facing direction */
-        comic_facing = COMIC_FACING_RIGHT;
+        GAME->comic_facing = COMIC_FACING_RIGHT;
     }
 }
 
 /*
- * game_loop - Main game loop
+ * turbo_frame_due - Decide whether this tick's frame is drawn
  * 
- * This is the main game loop that runs continuously until the game ends.
- * Each iteration:
- * 1. Clears the BIOS keyboard buffer
- * 2. Waits for a game tick (set by interrupt handler)
- * 3. Processes input and updates game state
- * 4. Renders the frame
- * 5. Handles non-player actors (enemies, fireballs, items)
+ * Returns:
+ *   1 outside turbo mode and on every turbo_draw_interval-th turbo tick,
+ *   otherwise 0 (the tick's playfield and sprites are not drawn)
+ */
+static uint8_t turbo_frame_due(void)
+{
+    if (!GAME->turbo_mode) {
+        GAME->turbo_draw_counter = 0;
+        return 1;
+    }
+    if (++GAME->turbo_draw_counter < GAME->turbo_draw_interval) {
+        return 0;
+    }
+    GAME->turbo_draw_counter = 0;
+    return 1;
+}
+
+/*
+ * draw_rewound_frame - Show the game state rewind_step_back() restored
+ */
+static void draw_rewound_frame(void)
+{
+    sprite_queue_begin();
+    blit_map_playfield_offscreen();
+    blit_comic_playfield_offscreen();
+    render_actors();
+    ui_update();
+    swap_video_buffers();
+}
+
+/*
+ * rewind_tick - Step back a tick on F9 and hold the game there
+ * 
+ * While held, only the keyboard is read: F9 steps back again, and any
+ * game key (or Escape) lets the game carry on from the rewound tick. The
+ * keys held in the restored state are released, since they are not the
+ * keys held now.
  * 
- * The loop continues until win_counter reaches 1 (win condition) or the
- * player dies with no remaining lives.
+ * Returns:
+ *   1 if the tick was spent rewinding or holding, 0 to run it normally
  */
-void game_loop(void)
+static uint8_t rewind_tick(void)
+{
+    if (GAME->rewind_hold) {
+        update_keyboard_input();
+    }
+
+    if (GAME->rewind_key_pressed) {
+        GAME->rewind_key_pressed = 0;
+        if (rewind_step_back() == 0) {
+            /* The input fields run from key_state_esc to teleport_key_pressed */
+            memset(&GAME->key_state_esc, 0,
+                   offsetof(game_state_t, teleport_key_pressed) + 1 -
+                   offsetof(game_state_t, key_state_esc));
+            draw_rewound_frame();
+            GAME->rewind_hold = 1;
+        }
+        return GAME->rewind_hold;
+    }
+
+    if (GAME->key_state_jump || GAME->key_state_fire || GAME->key_state_left ||
+        GAME->key_state_right || GAME->key_state_open || GAME->key_state_teleport ||
+        GAME->key_state_esc) {
+        GAME->rewind_hold = 0;
+    }
+    return GAME->rewind_hold;
+}
+
+/*
+ * run_game_tick - Wait for the next game tick and run it
+ * 
+ * One iteration of the main game loop:
+ * 1. Waits for a game tick (set by interrupt handler)
+ * 2. Processes input and updates game state
+ * 3. Renders the frame
+ * 4. Handles non-player actors (enemies, fireballs, items)
+ * 
+ * Kept separate from game_loop() so that the host build can step the
+ * simulation one tick at a time.
+ * 
+ * Returns:
+ *   1 to keep running, 0 once win_counter has reached 1 and the game end
+ *   sequence has played (dying with no lives left never returns)
+ */
+uint8_t run_game_tick(void)
 {
-    uint16_t tile_addr;
-    uint8_t tile_value;
     uint8_t skip_rendering;
+    uint8_t draw_frame;
     
-    while (1) {
-        skip_rendering = 0;
-        
-        /* Busy-wait until int8_handler sets game_tick_flag */
-        while (game_tick_flag != 1) {
-            /* While waiting, reinitialize comic_jump_counter if Comic is not
-             * in the air and the player is not pressing the jump button.
-             * This recharge happens continuously during the wait, ensuring the
-             * jump counter is always ready when a tick arrives. This provides
-             * responsive jump input timing. */
-            if (comic_is_falling_or_jumping == 0 && key_state_jump == 0) {
-                comic_jump_counter = comic_jump_power;
-            }
-            
-            /* Yield CPU time to reduce CPU usage during wait */
-            dos_idle();
+    skip_rendering = 0;
+    profile_tick();
+    
+    /* Replays and turbo mode run flat out: only the jump recharge from the
+     * wait below. Sound keeps its own pace in int8_handler. */
+    if (GAME->replay.mode == REPLAY_PLAYBACK || GAME->turbo_mode) {
+        if (GAME->comic_is_falling_or_jumping == 0 && GAME->key_state_jump == 0) {
+            GAME->comic_jump_counter = GAME->comic_jump_power;
         }
-        
-        /* Clear the tick flag */
-        game_tick_flag = 0;
-        /* Reset landing sentinel for this tick */
-        landed_this_tick = 0;
-        
-        /* Read keyboard input and update key_state variables */
-        update_keyboard_input();
-        
-        /* Process cheat codes (for testing/debugging) */
-        handle_cheat_codes();
-        
-        /* Initiate jump if conditions are met (matching original assembly):
-         * - Player is standing (not in air)
-         * - Jump key transitioned from released to pressed (edge-triggered, not level-triggered)
-         * - Jump power has been recharged (comic_jump_power > 1)
-         * 
-         * Edge-triggering prevents repeated jumps while the key is continuously held.
-         * The key must transition from 0 (released) to 1 (pressed) to initiate a jump.
-         */
-        if (comic_is_falling_or_jumping == 0 && key_state_jump && !previous_key_state_jump && comic_jump_power > 1) {
-            /* Start a new jump: reset counter to power, mark as in air */
-            comic_jump_counter = comic_jump_power;
-            comic_is_falling_or_jumping = 1;
-            minimum_jump_frames = 0;  /* No forced frames - rely on key press duration only */
-        }
-        
-        /* Update previous frame state for edge-triggered input */
-        previous_key_state_jump = key_state_jump;
-        previous_key_state_teleport = key_state_teleport;
-        previous_key_state_cheat_wand = key_state_cheat_wand;
-        previous_key_state_cheat_key = key_state_cheat_key;
-        previous_key_state_cheat_cola = key_state_cheat_cola;
-        previous_key_state_cheat_corkscrew = key_state_cheat_corkscrew;
-        previous_key_state_cheat_boots = key_state_cheat_boots;
-        previous_key_state_cheat_lantern = key_state_cheat_lantern;
-        previous_key_state_cheat_shield = key_state_cheat_shield;
-        previous_key_state_cheat_level = key_state_cheat_level;
-        previous_key_state_cheat_stage = key_state_cheat_stage;
-        
-        /* Check for win condition
-         * When the player wins, win_counter is set to a delay value (e.g., 200).
-         * It decrements each tick until it reaches 1, at which point the game
-         * end sequence begins. The value 1 (not 0) is the trigger point, allowing
-         * win_counter to distinguish between: 0=no win, 1=trigger sequence, >1=counting down */
-        if (win_counter != 0) {
-            win_counter--;
-            if (win_counter == 1) {
-                /* Player has won - play victory sequence and exit game loop */
-                game_end_sequence();
-                return;
-            }
+        GAME->game_tick_flag = 1;
+    }
+    
+    /* Busy-wait until int8_handler sets game_tick_flag */
+    while (GAME->game_tick_flag != 1) {
+        /* While waiting, reinitialize comic_jump_counter if Comic is not
+         * in the air and the player is not pressing the jump button.
+         * This recharge happens continuously during the wait, ensuring the
+         * jump counter is always ready when a tick arrives. This provides
+         * responsive jump input timing. */
+        if (GAME->comic_is_falling_or_jumping == 0 && GAME->key_state_jump == 0) {
+            GAME->comic_jump_counter = GAME->comic_jump_power;
         }
         
-        /* Advance comic_run_cycle in the cycle COMIC_RUNNING_1, COMIC_RUNNING_2, COMIC_RUNNING_3 */
-        comic_run_cycle++;
-        if (comic_run_cycle > COMIC_RUNNING_3) {
-            comic_run_cycle = COMIC_RUNNING_1;
+        /* Use the wait to render map columns ahead of the camera */
+        render_map_idle();
+
+        /* Yield CPU time to reduce CPU usage during wait */
+        dos_idle();
+    }
+    
+    /* Clear the tick flag */
+    GAME->game_tick_flag = 0;
+    draw_frame = turbo_frame_due();
+    PROFILE_MARK(PROFILE_WAIT);
+
+    /* Only a tick that waited for the timer can fall behind it */
+    if (GAME->replay.mode != REPLAY_PLAYBACK && !GAME->turbo_mode) {
+        profile_tick_started(GAME->current_level_number, GAME->current_stage_number);
+    }
+
+    /* F9 steps back to where earlier ticks started (see rewind.h); every
+     * tick that does run is recorded for that first */
+    if ((GAME->rewind_key_pressed || GAME->rewind_hold) && rewind_tick()) {
+        PROFILE_MARK(PROFILE_REWIND);
+        return 1;
+    }
+    if (GAME->replay.mode == REPLAY_OFF) {
+        rewind_record_tick();
+    }
+    PROFILE_MARK(PROFILE_REWIND);
+
+    /* Reset landing sentinel for this tick */
+    GAME->landed_this_tick = 0;
+    
+    /* Read keyboard input and update key_state variables */
+    if (GAME->replay.mode == REPLAY_PLAYBACK) {
+        feed_replay_tick();
+    }
+    update_keyboard_input();
+    
+    /* Process cheat codes (for testing/debugging) */
+    handle_cheat_codes();
+
+    /* Initiate jump if conditions are met (matching original assembly):
+     * - Player is standing (not in air)
+     * - Jump key transitioned from released to pressed (edge-triggered, not level-triggered)
+     * - Jump power has been recharged (comic_jump_power > 1)
+     * 
+     * Edge-triggering prevents repeated jumps while the key is continuously held.
+     * The key must transition from 0 (released) to 1 (pressed) to initiate a jump.
+     */
+    if (GAME->comic_is_falling_or_jumping == 0 && GAME->key_state_jump && !GAME->previous_key_state_jump && GAME->comic_jump_power > 1) {
+        /* Start a new jump: reset counter to power, mark as in air */
+        GAME->comic_jump_counter = GAME->comic_jump_power;
+        GAME->comic_is_falling_or_jumping = 1;
+        GAME->minimum_jump_frames = 0;  /* No forced frames - rely on key press duration only */
+    }
+    
+    /* Update previous frame state for edge-triggered input */
+    GAME->previous_key_state_jump = GAME->key_state_jump;
+    GAME->previous_key_state_teleport = GAME->key_state_teleport;
+    GAME->previous_key_state_cheat_wand = GAME->key_state_cheat_wand;
+    GAME->previous_key_state_cheat_key = GAME->key_state_cheat_key;
+    GAME->previous_key_state_cheat_cola = GAME->key_state_cheat_cola;
+    GAME->previous_key_state_cheat_corkscrew = GAME->key_state_cheat_corkscrew;
+    GAME->previous_key_state_cheat_boots = GAME->key_state_cheat_boots;
+    GAME->previous_key_state_cheat_lantern = GAME->key_state_cheat_lantern;
+    GAME->previous_key_state_cheat_shield = GAME->key_state_cheat_shield;
+    GAME->previous_key_state_cheat_level = GAME->key_state_cheat_level;
+    GAME->previous_key_state_cheat_stage = GAME->key_state_cheat_stage;
+    PROFILE_MARK(PROFILE_INPUT);
+    
+    /* Check for win condition
+     * When the player wins, win_counter is set to a delay value (e.g., 200).
+     * It decrements each tick until it reaches 1, at which point the game
+     * end sequence begins. The value 1 (not 0) is the trigger point, allowing
+     * win_counter to distinguish between: 0=no win, 1=trigger sequence, >1=counting down */
+    if (GAME->win_counter != 0) {
+        GAME->win_counter--;
+        if (GAME->win_counter == 1) {
+            /* Player has won - play victory sequence and exit game loop */
+            game_end_sequence();
+            return 0;
         }
+    }
+    
+    /* Advance comic_run_cycle in the cycle COMIC_RUNNING_1, COMIC_RUNNING_2, COMIC_RUNNING_3 */
+    GAME->comic_run_cycle++;
+    if (GAME->comic_run_cycle > COMIC_RUNNING_3) {
+        GAME->comic_run_cycle = COMIC_RUNNING_1;
+    }
+    
+    /* Put Comic in standing state by default; may be overridden by input or physics */
+    GAME->comic_animation = COMIC_STANDING;
+    
+    /* Award pending HP increase (one unit per tick) */
+    if (GAME->comic_hp_pending_increase > 0) {
+        GAME->comic_hp_pending_increase--;
+        increment_comic_hp();
+    }
+    
+    /* Handle teleportation */
+    if (GAME->comic_is_teleporting != 0) {
+        handle_teleport();
+        /* Consume any teleport edge captured during the active teleport.
+         * Without this, the goto below bypasses the normal reset path and
+         * a stale press can trigger begin_teleport() on the first non-teleport tick. */
+        GAME->teleport_key_pressed = 0;
+        /* Match assembly (.check_teleport => handle_teleport => jmp .handle_nonplayer_actors):
+         * skip pause and fire entirely during teleport, go straight to actor handling. */
+        skip_rendering = 1;
+        goto handle_nonplayer_actors;
+    }
+    /* Handle falling, jumping, and movement only if not teleporting */
+    else {
+        /* Snapshot whether physics will run this tick.
+         * Assembly .check_falling_or_jumping / .check_jump_input both take the
+         * jmp handle_fall_or_jump path when in air or when jump is initiated,
+         * and handle_fall_or_jump returns directly to .check_pause_input,
+         * SKIPPING .check_open_input, .check_teleport_input, .check_left_input,
+         * .check_right_input and .check_for_floor entirely.
+         * We capture this before physics so we can replicate that skip below. */
+        uint8_t was_in_air = GAME->comic_is_falling_or_jumping;
+
+        /* Call physics to handle gravity and collisions (single call per frame) */
+        handle_fall_or_jump();
         
-        /* Put Comic in standing state by default; may be overridden by input or physics */
-        comic_animation = COMIC_STANDING;
-        
-        /* Award pending HP increase (one unit per tick) */
-        if (comic_hp_pending_increase > 0) {
-            comic_hp_pending_increase--;
-            increment_comic_hp();
+        /* Check open input (doors) - only if:
+         *   - Not currently or previously in air (assembly skips this when physics ran)
+         *   - Not falling/jumping now
+         *   - Open key is pressed */
+        if (!was_in_air && GAME->comic_is_falling_or_jumping == 0 && GAME->key_state_open == 1) {
+            if (check_door_activation()) {
+                /* Match assembly .check_open_input -> jmp activate_door:
+                 * do not continue pause/fire/render logic in this tick. */
+                GAME->teleport_key_pressed = 0;
+                return 1;
+            }
         }
         
-        /* Handle teleportation */
-        if (comic_is_teleporting != 0) {
+        /* Check teleport input - only if not previously in air, not falling/jumping,
+         * and teleport key was pressed this frame */
+        if (!was_in_air && GAME->comic_is_falling_or_jumping == 0 && GAME->teleport_key_pressed && GAME->comic_has_teleport_wand != 0) {
+            begin_teleport();
+            /* Match assembly (.check_teleport_input => begin_teleport => jmp .check_teleport):
+             * execute the first teleport frame immediately in this tick, then skip
+             * pause and fire and go straight to actor handling. */
             handle_teleport();
-            /* Consume any teleport edge captured during the active teleport.
-             * Without this, the goto below bypasses the normal reset path and
-             * a stale press can trigger begin_teleport() on the first non-teleport tick. */
-            teleport_key_pressed = 0;
-            /* Match assembly (.check_teleport => handle_teleport => jmp .handle_nonplayer_actors):
-             * skip pause and fire entirely during teleport, go straight to actor handling. */
             skip_rendering = 1;
+            GAME->teleport_key_pressed = 0;
             goto handle_nonplayer_actors;
         }
-        /* Handle falling, jumping, and movement only if not teleporting */
-        else {
-            /* Snapshot whether physics will run this tick.
-             * Assembly .check_falling_or_jumping / .check_jump_input both take the
-             * jmp handle_fall_or_jump path when in air or when jump is initiated,
-             * and handle_fall_or_jump returns directly to .check_pause_input,
-             * SKIPPING .check_open_input, .check_teleport_input, .check_left_input,
-             * .check_right_input and .check_for_floor entirely.
-             * We capture this before physics so we can replicate that skip below. */
-            uint8_t was_in_air = comic_is_falling_or_jumping;
-
-            /* Call physics to handle gravity and collisions (single call per frame) */
-            handle_fall_or_jump();
-            
-            /* Check open input (doors) - only if:
-             *   - Not currently or previously in air (assembly skips this when physics ran)
-             *   - Not falling/jumping now
-             *   - Open key is pressed */
-            if (!was_in_air && comic_is_falling_or_jumping == 0 && key_state_open == 1) {
-                if (check_door_activation()) {
-                    /* Match assembly .check_open_input -> jmp activate_door:
-                     * do not continue pause/fire/render logic in this tick. */
-                    teleport_key_pressed = 0;
-                    continue;
-                }
+        /* Handle left/right movement - only if not falling/jumping, not teleporting,
+         * and did NOT just land this tick (assembly jumps to pause after landing). */
+        else if (GAME->comic_is_falling_or_jumping == 0 && GAME->landed_this_tick == 0) {
+            uint8_t foot_y;
+
+            GAME->comic_x_momentum = 0;
+            /* Note: If both left and right keys are pressed simultaneously,
+             * right movement takes priority (momentum is set to -5 then
+             * immediately overwritten to +5). This matches the original
+             * assembly behavior. */
+            if (GAME->key_state_left == 1) {
+                GAME->comic_x_momentum = -5;
+                face_or_move_left();
             }
-            
-            /* Check teleport input - only if not previously in air, not falling/jumping,
-             * and teleport key was pressed this frame */
-            if (!was_in_air && comic_is_falling_or_jumping == 0 && teleport_key_pressed && comic_has_teleport_wand != 0) {
-                begin_teleport();
-                /* Match assembly (.check_teleport_input => begin_teleport => jmp .check_teleport):
-                 * execute the first teleport frame immediately in this tick, then skip
-                 * pause and fire and go straight to actor handling. */
-                handle_teleport();
-                skip_rendering = 1;
-                teleport_key_pressed = 0;
-                goto handle_nonplayer_actors;
+            if (GAME->key_state_right == 1) {
+                GAME->comic_x_momentum = +5;
+                face_or_move_right();
             }
-            /* Handle left/right movement - only if not falling/jumping, not teleporting,
-             * and did NOT just land this tick (assembly jumps to pause after landing). */
-            else if (comic_is_falling_or_jumping == 0 && landed_this_tick == 0) {
-                uint8_t foot_y;
-                uint16_t foot_offset;
-                uint8_t foot_tile;
-                uint8_t foot_solid;
-                uint8_t right_foot_solid;
-
-                comic_x_momentum = 0;
-                /* Note: If both left and right keys are pressed simultaneously,
-                 * right movement takes priority (momentum is set to -5 then
-                 * immediately overwritten to +5). This matches the original
-                 * assembly behavior. */
-                if (key_state_left == 1) {
-                    comic_x_momentum = -5;
-                    face_or_move_left();
-                }
-                if (key_state_right == 1) {
-                    comic_x_momentum = +5;
-                    face_or_move_right();
-                }
-
-                /* Check for floor below Comic (walked off an edge) */
-                foot_y = comic_y + 4;
-                foot_offset = address_of_tile_at_coordinates(comic_x / 2, foot_y / 2);
-                foot_solid = 0;
-                right_foot_solid = 0;
-                if (current_tiles_ptr != NULL && foot_offset < MAP_WIDTH_TILES * MAP_HEIGHT_TILES) {
-                    foot_tile = current_tiles_ptr[foot_offset];
-                    if (foot_tile > tileset_last_passable) {
-                        foot_solid = 1;
-                    }
-                    if ((comic_x & 1) && (foot_offset + 1) < MAP_WIDTH_TILES * MAP_HEIGHT_TILES) {
-                        foot_tile = current_tiles_ptr[foot_offset + 1];
-                        if (foot_tile > tileset_last_passable) {
-                            right_foot_solid = 1;
-                        }
-                    }
-                }
 
-                if (!foot_solid && !right_foot_solid) {
-                    /* Start falling after walking off an edge */
-                    comic_y_vel = 8;
-                    if (comic_x_momentum > 0) {
-                        comic_x_momentum = +2;
-                    } else if (comic_x_momentum < 0) {
-                        comic_x_momentum = -2;
-                    }
-                    comic_is_falling_or_jumping = 1;
-                    comic_jump_counter = 1;
+            /* Check for floor below Comic (walked off an edge) */
+            foot_y = GAME->comic_y + 4;
+            if (!solid_span_x(GAME->comic_x, foot_y)) {
+                /* Start falling after walking off an edge */
+                GAME->comic_y_vel = 8;
+                if (GAME->comic_x_momentum > 0) {
+                    GAME->comic_x_momentum = +2;
+                } else if (GAME->comic_x_momentum < 0) {
+                    GAME->comic_x_momentum = -2;
                 }
+                GAME->comic_is_falling_or_jumping = 1;
+                GAME->comic_jump_counter = 1;
             }
-            
-            /* Clear the teleport flag after checking */
-            teleport_key_pressed = 0;
         }
+        
+        /* Clear the teleport flag after checking */
+        GAME->teleport_key_pressed = 0;
+    }
 
-        if (stage_transitioned_this_tick) {
-            /* Match assembly stage_edge_transition -> jmp load_new_stage -> jmp game_loop. */
-            stage_transitioned_this_tick = 0;
-            continue;
+    if (GAME->stage_transitioned_this_tick) {
+        /* Match assembly stage_edge_transition -> jmp load_new_stage -> jmp game_loop. */
+        GAME->stage_transitioned_this_tick = 0;
+        return 1;
+    }
+    
+    /* Check escape key (pause) */
+    if (GAME->key_state_esc == 1) {
+        PROFILE_MARK(PROFILE_PHYSICS);
+        pause_game();
+        /* Wait for escape key release */
+        while (GAME->key_state_esc == 1) {
+            dos_idle();  /* Yield CPU while waiting for key release */
         }
-        
-        /* Check escape key (pause) */
-        if (key_state_esc == 1) {
-            pause_game();
-            /* Wait for escape key release */
-            while (key_state_esc == 1) {
-                dos_idle();  /* Yield CPU while waiting for key release */
+        PROFILE_MARK(PROFILE_OTHER);
+    }
+    
+    /* Check fire input */
+    if (GAME->key_state_fire == 1) {
+        if (GAME->fireball_meter > 0) {
+            try_to_fire();
+            
+            /* fireball_meter increases/decreases at a rate of 1 unit per 2 ticks.
+             * fireball_meter_counter alternates 2, 1, 2, 1, ... to track when to adjust.
+             * When firing: decrement meter when counter is 2 (before decrementing counter)
+             * When not firing: increment meter when counter wraps from 1 to 0 */
+            if (GAME->fireball_meter_counter != 1) {
+                /* Counter is 2; decrement meter before decrementing counter */
+                decrement_fireball_meter();
             }
         }
-        
-        /* Check fire input */
-        if (key_state_fire == 1) {
-            if (fireball_meter > 0) {
-                try_to_fire();
-                
-                /* fireball_meter increases/decreases at a rate of 1 unit per 2 ticks.
-                 * fireball_meter_counter alternates 2, 1, 2, 1, ... to track when to adjust.
-                 * When firing: decrement meter when counter is 2 (before decrementing counter)
-                 * When not firing: increment meter when counter wraps from 1 to 0 */
-                if (fireball_meter_counter != 1) {
-                    /* Counter is 2; decrement meter before decrementing counter */
-                    decrement_fireball_meter();
-                }
-            }
+    }
+    
+    /* Always decrement counter (whether firing or not) */
+    GAME->fireball_meter_counter--;
+    if (GAME->fireball_meter_counter == 0) {
+        /* Counter wrapped from 1 to 0. Increment meter only if NOT firing.
+         * When firing: meter decrements every 2 ticks (only on counter==2)
+         * When not firing: meter increments every 2 ticks (on counter wrap)
+         * This asymmetry creates different rates: -1/2 ticks vs +1/2 ticks */
+        if (GAME->key_state_fire != 1) {
+            /* Not firing; allow meter to recharge */
+            increment_fireball_meter();
         }
-        
-        /* Always decrement counter (whether firing or not) */
-        fireball_meter_counter--;
-        if (fireball_meter_counter == 0) {
-            /* Counter wrapped from 1 to 0. Increment meter only if NOT firing.
-             * When firing: meter decrements every 2 ticks (only on counter==2)
-             * When not firing: meter increments every 2 ticks (on counter wrap)
-             * This asymmetry creates different rates: -1/2 ticks vs +1/2 ticks */
-            if (key_state_fire != 1) {
-                /* Not firing; allow meter to recharge */
-                increment_fireball_meter();
-            }
-            /* Always wrap counter back to 2 */
-            fireball_meter_counter = 2;
+        /* Always wrap counter back to 2 */
+        GAME->fireball_meter_counter = 2;
+    }
+    
+    PROFILE_MARK(PROFILE_PHYSICS);
+
+    /* Collect this tick's sprites and draw them plane by plane just
+     * before the swap (swap_video_buffers ends the batch) */
+    sprite_queue_begin();
+
+    /* Render the map and Comic (unless teleport already handled it or
+     * turbo mode is not drawing this tick) */
+    if (!skip_rendering && draw_frame) {
+        blit_map_playfield_offscreen();
+        PROFILE_MARK(PROFILE_MAP);
+        blit_comic_playfield_offscreen();
+        PROFILE_MARK(PROFILE_COMIC);
+    }
+    
+    /* Label for goto from teleport branches: assembly skips pause/fire during
+     * teleport and jumps directly here (.handle_nonplayer_actors). */
+    handle_nonplayer_actors:
+    PROFILE_MARK(PROFILE_PHYSICS);  /* The teleport, on the goto path */
+    sprite_queue_begin();
+    if (!draw_frame) {
+        sprite_queue_skip_frame();
+    }
+
+    /* Handle enemies, fireballs, and items */
+    handle_enemies();
+    PROFILE_MARK(PROFILE_ENEMIES);
+    handle_fireballs();
+    PROFILE_MARK(PROFILE_FIREBALLS);
+    handle_item();
+    PROFILE_MARK(PROFILE_ITEMS);
+    
+    if (draw_frame) {
+        /* Bring the score, inventory and meters in the offscreen page up to date */
+        ui_update();
+        PROFILE_MARK(PROFILE_UI);
+        swap_video_buffers();
+    } else {
+        /* Draw what went into both pages and keep showing the last frame */
+        sprite_queue_end();
+    }
+    PROFILE_MARK(PROFILE_SWAP);
+    
+    return 1;
+}
+
+/*
+ * game_loop - Main game loop
+ * 
+ * Runs game ticks until the game ends: win_counter reaches 1 (win
+ * condition) or the player dies with no remaining lives.
+ */
+void game_loop(void)
+{
+    while (run_game_tick()) {
+    }
+}
+
+/* The host build (make host) has its own main() in host/host_sim.c */
+#ifndef HOST_BUILD
+
+/*
+ * parse_command_line - Apply startup options
+ * 
+ * Input:
+ *   argc, argv = arguments passed to main()
+ * 
+ * Options are case-insensitive and may start with '/' or '-':
+ *   /BITMASK      - draw the masked sprites that are not compiled (enemies,
+ *                   status panel icons, door and death animations) with the
+ *                   EGA Bit Mask register instead of per-plane
+ *                   read-modify-write; Comic, items, sparks and fireballs
+ *                   are compiled sprites and do not change
+ *   /RECORD:file  - record the game's input to a replay file
+ *   /REPLAY:file  - play a replay file back at full speed, skipping the
+ *                   startup notice and title sequence; Escape stops it
+ *   /TURBO[:n]    - start in turbo mode, drawing every nth tick (default 1,
+ *                   every tick); F10 toggles turbo mode during play
+ *   /PROFILE[:BARS] - time each phase of every tick and write the table to
+ *                   DEBUG.LOG on exit; BARS also draws each tick's phases
+ *                   as a bar below the UI panel (see profile.h)
+ *   /TRACE        - record a timeline of tick phases, loads, blits and
+ *                   sound notes and write it to TRACE.BIN on exit
+ *                   (see trace.h)
+ * 
+ * Unknown options are reported and otherwise ignored.
+ */
+static void parse_command_line(int argc, char *argv[])
+{
+    int i;
+    int interval;
+    const char *opt;
+
+    for (i = 1; i < argc; i++) {
+        opt = argv[i];
+        if (opt[0] == '/' || opt[0] == '-') {
+            opt++;
         }
-        
-        /* Render the map and Comic (unless teleport already handled it) */
-        if (!skip_rendering) {
-            blit_map_playfield_offscreen();
-            blit_comic_playfield_offscreen();
-            render_comic_hp_meter();
+
+        if (stricmp(opt, "BITMASK") == 0) {
+            set_masked_blit_engine(MASKED_BLIT_ENGINE_BITMASK);
+        } else if (strnicmp(opt, "RECORD:", 7) == 0) {
+            replay_open_record(opt + 7);
+        } else if (strnicmp(opt, "REPLAY:", 7) == 0) {
+            replay_open_playback(opt + 7);
+        } else if (stricmp(opt, "TURBO") == 0) {
+            GAME->turbo_mode = 1;
+        } else if (strnicmp(opt, "TURBO:", 6) == 0) {
+            GAME->turbo_mode = 1;
+            interval = atoi(opt + 6);
+            if (interval < 1 || interval > 255) {
+                fprintf(stderr, "Turbo draw interval '%s' out of range, using 1\n", opt + 6);
+                interval = 1;
+            }
+            GAME->turbo_draw_interval = (uint8_t)interval;
+        } else if (stricmp(opt, "PROFILE") == 0) {
+            profile_start(PROFILE_BARS_OFF);
+        } else if (stricmp(opt, "PROFILE:BARS") == 0) {
+            profile_start(PROFILE_BARS_ON);
+        } else if (stricmp(opt, "TRACE") == 0) {
+            trace_start();
+        } else {
+            fprintf(stderr, "Unknown option '%s' ignored\n", argv[i]);
         }
-        
-        /* Label for goto from teleport branches: assembly skips pause/fire during
-         * teleport and jumps directly here (.handle_nonplayer_actors). */
-        handle_nonplayer_actors:
+    }
+}
 
-        /* Handle enemies, fireballs, and items */
-        handle_enemies();
-        handle_fireballs();
-        handle_item();
-        
-        /* Render inventory display items on the UI */
-        render_inventory_display();
-        
-        /* Render score display on the UI */
-        render_score_display();
-        
-        swap_video_buffers();
+/*
+ * replay_game - Set up the gameplay screen and play back a replay
+ * 
+ * Does what title_sequence() does before the game starts, minus the title
+ * and story screens and their key waits.
+ */
+static void replay_game(void)
+{
+    union REGS regs;
+
+    regs.h.ah = 0x00;  /* AH=0x00: set video mode */
+    regs.h.al = 0x0D;  /* AL=0x0D: 320x200 16-color EGA */
+    int86(0x10, &regs, &regs);
+    init_ega_graphics();
+    init_default_palette();
+
+    if (load_fullscreen_graphic(FILENAME_UI_GRAPHIC, GRAPHICS_BUFFER_GAMEPLAY_A) == 0) {
+        copy_ega_plane(GRAPHICS_BUFFER_GAMEPLAY_A, GRAPHICS_BUFFER_GAMEPLAY_B, 8000);
     }
+    switch_video_buffer(GRAPHICS_BUFFER_GAMEPLAY_B);
+
+    if (begin_game() != 0) {
+        return;
+    }
+    game_loop();
 }
 
 /*
@@ -3973,6 +4419,7 @@ void game_loop(void)
  * Entry point for the C-only version.
  * Performs all initialization in C:
  * - DS initialization (handled by C runtime)
+ * - Parse command-line options
  * - Disable PC speaker
  * - Install interrupt handler sentinel
  * - Calibrate CPU speed
@@ -3984,20 +4431,13 @@ void game_loop(void)
  * - Run title sequence
  * - Exit
  */
-int main(void)
+int main(int argc, char *argv[])
 {
-    int i, j;
+    /* Start from a clean game state (no items, empty score, level 1) */
+    game_state_init(&game_state);
+
+    parse_command_line(argc, argv);
 
-    /* Initialize score carry counter used for 50,000-point extra lives. */
-    score_10000_counter = 0;
-    
-    /* Initialize items_collected array */
-    for (i = 0; i < 8; i++) {
-        for (j = 0; j < 16; j++) {
-            items_collected[i][j] = 0;
-        }
-    }
-    
     /* Disable the PC speaker */
     disable_pc_speaker();
     
@@ -4030,6 +4470,13 @@ int main(void)
         int86(0x10, &regs, &regs);
     }
     
+    /* A replay goes straight into the game */
+    if (GAME->replay.mode == REPLAY_PLAYBACK) {
+        replay_game();
+        terminate_program();
+        return 0;
+    }
+    
     /* Display the startup notice and handle user input */
     if (!display_startup_notice()) {
         /* User pressed Escape to exit */
@@ -4045,3 +4492,5 @@ int main(void)
     
     return 0;
 }
+
+#endif /* HOST_BUILD */
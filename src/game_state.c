@@ -0,0 +1,62 @@
+/*
+ * game_state.c - Mutable state of one game
+ *
+ * See game_state.h.
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include "game_state.h"
+#include "physics.h"
+
+game_state_t game_state;
+
+#ifdef HOST_BUILD
+game_state_t *game_current = &game_state;
+
+/*
+ * game_select - Make a game the one GAME refers to
+ *
+ * Input:
+ *   state = game to run; it keeps its own input, rewind and replay state,
+ *           so switching between games between ticks is safe
+ */
+void game_select(game_state_t *state)
+{
+    game_current = state;
+}
+#endif
+
+/* Default keymap: Space, Ins, Left, Right, Alt, Caps Lock */
+static const uint8_t default_keymap[6] = { 0x39, 0x52, 0x4B, 0x4D, 0x38, 0x3A };
+
+/*
+ * game_state_init - Put a game in its power-on state
+ *
+ * Input:
+ *   state = state to initialize; everything not set here starts at zero
+ */
+void game_state_init(game_state_t *state)
+{
+    memset(state, 0, sizeof(*state));
+
+    state->current_level_number = LEVEL_NUMBER_FOREST;
+    state->source_door_level_number = -2;
+    state->comic_y_checkpoint = 12;
+    state->comic_x_checkpoint = 14;
+
+    state->comic_animation = COMIC_STANDING;
+    state->comic_facing = COMIC_FACING_RIGHT;
+    state->comic_run_cycle = COMIC_RUNNING_1;
+    state->comic_jump_power = JUMP_POWER_DEFAULT;
+    state->comic_hp_pending_increase = MAX_HP;  /* Fill HP at game start */
+
+    state->fireball_meter_counter = 2;
+    state->enemy_respawn_counter_cycle = 20;
+    state->spawn_offset_cycle = PLAYFIELD_WIDTH;
+
+    memcpy(state->keymap, default_keymap, sizeof(state->keymap));
+    state->turbo_draw_interval = 1;
+    state->replay.mode = REPLAY_OFF;
+    state->replay.handle = -1;
+}
@@ -0,0 +1,303 @@
+/*
+ * graphic_cache.c - Cache of decoded fullscreen .EGA graphics
+ *
+ * load_fullscreen_graphic() stores each graphic it decodes here by reading
+ * the four planes back out of video memory, and checks here before opening
+ * a file. A hit is a straight 4 x 8000-byte copy into the target page.
+ *
+ * Storage is chosen on first use:
+ *   - EMS (INT 67h), when an expanded memory manager is loaded: one handle
+ *     of GRAPHIC_CACHE_EMS_ENTRIES * 2 pages. An entry's two 16 KB logical
+ *     pages are mapped into physical pages 0 and 1 of the page frame, so
+ *     the 32000-byte entry is contiguous at frame:0000.
+ *   - Conventional memory otherwise: up to GRAPHIC_CACHE_CONVENTIONAL_ENTRIES
+ *     buffers, each allocated on first store. If an allocation fails the
+ *     graphic is simply not cached.
+ * When every slot is in use, the least recently used entry is replaced.
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <dos.h>
+#include <i86.h>
+#include "globals.h"
+#include "graphics.h"
+#include "graphic_cache.h"
+#include "vram.h"
+
+#define VIDEO_MEMORY_BASE       0xa000
+
+#define EMS_INTERRUPT           0x67
+#define EMS_PAGES_PER_ENTRY     2
+#define EMS_DRIVER_NAME_OFFSET  0x0a  /* Device name within the INT 67h handler's segment */
+
+#define CACHE_NAME_LEN          13    /* 8.3 filename plus terminator */
+#define CACHE_MAX_ENTRIES       GRAPHIC_CACHE_EMS_ENTRIES
+
+#define CACHE_BACKEND_UNKNOWN       0  /* Not probed yet */
+#define CACHE_BACKEND_EMS           1
+#define CACHE_BACKEND_CONVENTIONAL  2
+
+typedef struct {
+    char name[CACHE_NAME_LEN];   /* Empty string = slot unused */
+    uint16_t last_used;          /* use_clock value at last store or restore */
+    uint8_t __far *buffer;       /* Conventional backend only */
+} cache_entry_t;
+
+static cache_entry_t cache_entries[CACHE_MAX_ENTRIES];
+static uint8_t cache_backend = CACHE_BACKEND_UNKNOWN;
+static uint8_t cache_num_entries = 0;
+static uint16_t ems_handle;
+static uint16_t ems_frame_segment;
+static uint16_t use_clock = 0;
+
+/*
+ * ems_init - Detect an expanded memory manager and allocate the cache's pages
+ *
+ * Returns:
+ *   1 if EMS pages were allocated, 0 if EMS is absent or has too few pages
+ */
+static uint8_t ems_init(void)
+{
+    union REGS regs;
+    struct SREGS sregs;
+    const char __far *driver_name;
+
+    /* Get the INT 67h vector (DOS INT 21h AH=35h) */
+    segread(&sregs);
+    regs.h.ah = 0x35;
+    regs.h.al = EMS_INTERRUPT;
+    int86x(0x21, &regs, &regs, &sregs);
+    if (sregs.es == 0) {
+        return 0;
+    }
+
+    /* An EMM driver's device header names it "EMMXXXX0" */
+    driver_name = (const char __far *)MK_FP(sregs.es, EMS_DRIVER_NAME_OFFSET);
+    if (_fmemcmp(driver_name, "EMMXXXX0", 8) != 0) {
+        return 0;
+    }
+
+    /* AH=40h: get status */
+    regs.h.ah = 0x40;
+    int86(EMS_INTERRUPT, &regs, &regs);
+    if (regs.h.ah != 0) {
+        return 0;
+    }
+
+    /* AH=41h: get page frame segment */
+    regs.h.ah = 0x41;
+    int86(EMS_INTERRUPT, &regs, &regs);
+    if (regs.h.ah != 0) {
+        return 0;
+    }
+    ems_frame_segment = regs.x.bx;
+
+    /* AH=43h: allocate pages */
+    regs.h.ah = 0x43;
+    regs.x.bx = CACHE_MAX_ENTRIES * EMS_PAGES_PER_ENTRY;
+    int86(EMS_INTERRUPT, &regs, &regs);
+    if (regs.h.ah != 0) {
+        return 0;
+    }
+    ems_handle = regs.x.dx;
+
+    return 1;
+}
+
+/*
+ * cache_probe - Pick the cache backend on first use
+ */
+static void cache_probe(void)
+{
+    if (cache_backend != CACHE_BACKEND_UNKNOWN) {
+        return;
+    }
+
+    if (ems_init()) {
+        cache_backend = CACHE_BACKEND_EMS;
+        cache_num_entries = GRAPHIC_CACHE_EMS_ENTRIES;
+    } else {
+        cache_backend = CACHE_BACKEND_CONVENTIONAL;
+        cache_num_entries = GRAPHIC_CACHE_CONVENTIONAL_ENTRIES;
+    }
+}
+
+/*
+ * entry_buffer - Make a slot's data addressable
+ *
+ * Input:
+ *   slot     = cache slot index
+ *   allocate = 1 to allocate a conventional buffer if the slot has none
+ *
+ * Returns:
+ *   Far pointer to the slot's 32000 bytes, or NULL on failure
+ */
+static uint8_t __far *entry_buffer(uint8_t slot, uint8_t allocate)
+{
+    union REGS regs;
+    uint8_t page;
+
+    if (cache_backend == CACHE_BACKEND_EMS) {
+        /* AH=44h: map the entry's logical pages to physical pages 0 and 1 */
+        for (page = 0; page < EMS_PAGES_PER_ENTRY; page++) {
+            regs.h.ah = 0x44;
+            regs.h.al = page;
+            regs.x.bx = (uint16_t)slot * EMS_PAGES_PER_ENTRY + page;
+            regs.x.dx = ems_handle;
+            int86(EMS_INTERRUPT, &regs, &regs);
+            if (regs.h.ah != 0) {
+                return NULL;
+            }
+        }
+        return (uint8_t __far *)MK_FP(ems_frame_segment, 0);
+    }
+
+    if (cache_entries[slot].buffer == NULL && allocate) {
+        cache_entries[slot].buffer = (uint8_t __far *)malloc(GRAPHIC_CACHE_ENTRY_SIZE);
+    }
+    return cache_entries[slot].buffer;
+}
+
+/*
+ * find_entry - Return the slot holding filename, or -1
+ */
+static int8_t find_entry(const char *filename)
+{
+    uint8_t slot;
+
+    for (slot = 0; slot < cache_num_entries; slot++) {
+        if (cache_entries[slot].name[0] != '\0' &&
+            stricmp(cache_entries[slot].name, filename) == 0) {
+            return (int8_t)slot;
+        }
+    }
+    return -1;
+}
+
+/*
+ * graphic_cache_restore - Copy a cached graphic into video memory
+ *
+ * Input:
+ *   filename   = graphic filename as passed to load_fullscreen_graphic()
+ *   dst_offset = video memory offset of the destination page
+ *
+ * Returns:
+ *   1 if the graphic was cached and has been drawn, 0 otherwise
+ */
+uint8_t graphic_cache_restore(const char *filename, uint16_t dst_offset)
+{
+    uint8_t __far *buffer;
+    int8_t slot;
+    uint8_t plane;
+
+    cache_probe();
+
+    slot = find_entry(filename);
+    if (slot < 0) {
+        return 0;
+    }
+
+    buffer = entry_buffer((uint8_t)slot, 0);
+    if (buffer == NULL) {
+        return 0;
+    }
+
+    for (plane = 0; plane < 4; plane++) {
+        enable_ega_plane_write(plane);
+        VRAM_COPY_TO((uint8_t __far *)MK_FP(VIDEO_MEMORY_BASE, dst_offset),
+                     buffer + (uint16_t)plane * GRAPHIC_CACHE_PLANE_SIZE,
+                     GRAPHIC_CACHE_PLANE_SIZE);
+    }
+
+    cache_entries[slot].last_used = ++use_clock;
+    return 1;
+}
+
+/*
+ * graphic_cache_store - Save a freshly decoded graphic from video memory
+ *
+ * Input:
+ *   filename   = graphic filename as passed to load_fullscreen_graphic()
+ *   src_offset = video memory offset the graphic was decoded to
+ *
+ * Reads the four planes back through Read Map Select. Filenames longer
+ * than 8.3 and graphics that are already cached are ignored.
+ */
+void graphic_cache_store(const char *filename, uint16_t src_offset)
+{
+    uint8_t __far *buffer;
+    uint8_t slot;
+    uint8_t candidate;
+    uint8_t plane;
+
+    cache_probe();
+
+    if (cache_num_entries == 0 || strlen(filename) >= CACHE_NAME_LEN) {
+        return;
+    }
+    if (find_entry(filename) >= 0) {
+        return;
+    }
+
+    /* Prefer an unused slot, otherwise replace the least recently used */
+    slot = 0;
+    for (candidate = 0; candidate < cache_num_entries; candidate++) {
+        if (cache_entries[candidate].name[0] == '\0') {
+            slot = candidate;
+            break;
+        }
+        if ((uint16_t)(use_clock - cache_entries[candidate].last_used) >
+            (uint16_t)(use_clock - cache_entries[slot].last_used)) {
+            slot = candidate;
+        }
+    }
+
+    cache_entries[slot].name[0] = '\0';
+    buffer = entry_buffer(slot, 1);
+    if (buffer == NULL) {
+        return;
+    }
+
+    for (plane = 0; plane < 4; plane++) {
+        enable_ega_plane_read(plane);
+        VRAM_COPY_FROM(buffer + (uint16_t)plane * GRAPHIC_CACHE_PLANE_SIZE,
+                       (uint8_t __far *)MK_FP(VIDEO_MEMORY_BASE, src_offset),
+                       GRAPHIC_CACHE_PLANE_SIZE);
+    }
+
+    strcpy(cache_entries[slot].name, filename);
+    cache_entries[slot].last_used = ++use_clock;
+}
+
+/*
+ * graphic_cache_shutdown - Release the cache's memory
+ *
+ * EMS pages stay allocated after a program exits unless they are freed,
+ * so this must run before returning to DOS.
+ */
+void graphic_cache_shutdown(void)
+{
+    union REGS regs;
+    uint8_t slot;
+
+    if (cache_backend == CACHE_BACKEND_EMS) {
+        /* AH=45h: deallocate pages */
+        regs.h.ah = 0x45;
+        regs.x.dx = ems_handle;
+        int86(EMS_INTERRUPT, &regs, &regs);
+    }
+
+    for (slot = 0; slot < CACHE_MAX_ENTRIES; slot++) {
+        if (cache_entries[slot].buffer != NULL) {
+            free(cache_entries[slot].buffer);
+            cache_entries[slot].buffer = NULL;
+        }
+        cache_entries[slot].name[0] = '\0';
+    }
+
+    /* Leave the cache empty and disabled */
+    cache_backend = CACHE_BACKEND_CONVENTIONAL;
+    cache_num_entries = 0;
+}
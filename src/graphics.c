@@ -7,13 +7,22 @@
 
 #include <stdint.h>
 #include <stdio.h>
+#include <string.h>
 #include <dos.h>
 #include <conio.h>
 #include <i86.h>
+#include <fcntl.h>
+#include <io.h>
 #include "globals.h"
 #include "graphics.h"
+#include "dirty_rects.h"
+#include "graphic_cache.h"
+#include "compiled_sprites.h"
 #include "sprite_data.h"
 #include "timing.h"
+#include "vram.h"
+#include "game_state.h"
+#include "trace.h"
 
 /* EGA Register Addresses */
 #define EGA_CRTC_INDEX_PORT     0x3d4
@@ -29,6 +38,8 @@
 /* Graphics register indices */
 #define EGA_READ_PLANE_SELECT   0x04
 #define EGA_WRITE_PLANE_ENABLE  0x02
+#define EGA_GRAPHICS_MODE       0x05
+#define EGA_BIT_MASK            0x08
 
 /* Palette register indices for title sequence fade effects */
 #define PALETTE_REG_BACKGROUND  2   /* Background color register */
@@ -53,20 +64,8 @@ static uint16_t current_display_offset = GRAPHICS_BUFFER_GAMEPLAY_A;
 /* Forward declaration for static helper function */
 static void set_palette_register(uint8_t index, uint8_t color);
 
-/* Inventory item flags (defined in game_main.c) */
-extern uint8_t comic_has_door_key;
-extern uint8_t comic_has_teleport_wand;
-extern uint8_t comic_has_corkscrew;
-extern uint8_t comic_has_lantern;
-extern uint8_t comic_has_gems;         /* 1 if Gems collected, 0 otherwise */
-extern uint8_t comic_has_crown;        /* 1 if Crown collected, 0 otherwise */
-extern uint8_t comic_has_gold;         /* 1 if Gold collected, 0 otherwise */
-extern uint8_t comic_firepower;        /* Number of active fireball slots (controls Blastola Cola inventory display) */
-extern uint8_t comic_num_treasures;    /* Number of treasures collected (0-3, used for win/victory logic) */
-extern uint8_t comic_jump_power;       /* Jump power level (controls Boots display at >4) */
-
-/* Score data (defined in game_main.c) */
-extern uint8_t score_bytes[3];  /* 3-byte score in base-100 representation */
+/* Offscreen buffer (defined in game_main.c) */
+extern uint16_t offscreen_video_buffer_ptr; /* Current offscreen buffer offset */
 
 /*
  * init_ega_graphics - Initialize EGA graphics controller for pixel writing
@@ -77,8 +76,8 @@ extern uint8_t score_bytes[3];  /* 3-byte score in base-100 representation */
 void init_ega_graphics(void)
 {
     /* Set Graphics Controller Write Mode to 0 */
-    outp(EGA_GRAPHICS_INDEX_PORT, 0x05);  /* GC Register 5: Graphics Mode */
-    outp(EGA_GRAPHICS_DATA_PORT, 0x00);   /* Bits 0-1: Write Mode 0, Bit 3: Read Mode 0 */
+    VRAM_OUTP(EGA_GRAPHICS_INDEX_PORT, 0x05);  /* GC Register 5: Graphics Mode */
+    VRAM_OUTP(EGA_GRAPHICS_DATA_PORT, 0x00);   /* Bits 0-1: Write Mode 0, Bit 3: Read Mode 0 */
 }
 
 /*
@@ -102,8 +101,8 @@ void enable_ega_plane_write(uint8_t plane)
     }
     
     /* Output to Sequencer Registers at port 0x3c4/0x3c5 */
-    outp(EGA_SEQUENCER_INDEX_PORT, 0x02);  /* SC Map Mask register */
-    outp(EGA_SEQUENCER_DATA_PORT, mask);
+    VRAM_OUTP(EGA_SEQUENCER_INDEX_PORT, 0x02);  /* SC Map Mask register */
+    VRAM_OUTP(EGA_SEQUENCER_DATA_PORT, mask);
 }
 
 /*
@@ -118,8 +117,8 @@ void enable_ega_plane_write(uint8_t plane)
 void enable_ega_plane_read(uint8_t plane)
 {
     /* Output to Graphics Registers at port 0x3ce/0x3cf */
-    outp(EGA_GRAPHICS_INDEX_PORT, EGA_READ_PLANE_SELECT);
-    outp(EGA_GRAPHICS_DATA_PORT, plane);
+    VRAM_OUTP(EGA_GRAPHICS_INDEX_PORT, EGA_READ_PLANE_SELECT);
+    VRAM_OUTP(EGA_GRAPHICS_DATA_PORT, plane);
 }
 
 /*
@@ -134,6 +133,74 @@ void enable_ega_plane_read_write(uint8_t plane)
     enable_ega_plane_write(plane);
 }
 
+/*
+ * enable_ega_plane_write_all - Enable writing to all four EGA color planes
+ * 
+ * Sets the Sequencer Map Mask register (SC Register 0x02) to 0x0f so a
+ * single CPU write reaches every plane. Used together with write mode 1
+ * for latched video-to-video copies.
+ */
+void enable_ega_plane_write_all(void)
+{
+    VRAM_OUTP(EGA_SEQUENCER_INDEX_PORT, EGA_WRITE_PLANE_ENABLE);
+    VRAM_OUTP(EGA_SEQUENCER_DATA_PORT, 0x0f);
+}
+
+/*
+ * set_ega_write_mode - Select the Graphics Controller write mode
+ * 
+ * Input:
+ *   mode = EGA_WRITE_MODE_0 (CPU data through Map Mask) or
+ *          EGA_WRITE_MODE_1 (store the latches loaded by the last read)
+ * 
+ * Writes GC Register 5 (Graphics Mode). Read mode is left at 0.
+ */
+void set_ega_write_mode(uint8_t mode)
+{
+    VRAM_OUTP(EGA_GRAPHICS_INDEX_PORT, EGA_GRAPHICS_MODE);
+    VRAM_OUTP(EGA_GRAPHICS_DATA_PORT, mode & 0x03);
+}
+
+/*
+ * copy_ega_latched - Copy a rectangle of video memory through the EGA latches
+ * 
+ * Input:
+ *   src_offset   = source offset within segment 0xa000
+ *   src_stride   = bytes between source rows
+ *   dst_offset   = destination offset within segment 0xa000
+ *   dst_stride   = bytes between destination rows
+ *   width_bytes  = bytes per row to copy
+ *   rows         = number of rows to copy
+ * 
+ * In write mode 1 each CPU read loads all four plane latches and each CPU
+ * write stores them back, so one pass moves every plane at once (a quarter
+ * of the memory traffic of a plane-by-plane copy). Both rectangles must be
+ * in video memory. Leaves all planes write-enabled and restores write mode 0.
+ */
+void copy_ega_latched(uint16_t src_offset, uint16_t src_stride,
+                      uint16_t dst_offset, uint16_t dst_stride,
+                      uint16_t width_bytes, uint16_t rows)
+{
+    uint8_t __far *src_row = (uint8_t __far *)MK_FP(VIDEO_MEMORY_BASE, src_offset);
+    uint8_t __far *dst_row = (uint8_t __far *)MK_FP(VIDEO_MEMORY_BASE, dst_offset);
+    uint16_t row;
+    uint16_t col;
+
+    enable_ega_plane_write_all();
+    set_ega_write_mode(EGA_WRITE_MODE_1);
+
+    for (row = 0; row < rows; row++) {
+        for (col = 0; col < width_bytes; col++) {
+            /* Read loads the latches; the written value is ignored in mode 1 */
+            VRAM_WRITE(dst_row + col, VRAM_READ(src_row + col));
+        }
+        src_row += src_stride;
+        dst_row += dst_stride;
+    }
+
+    set_ega_write_mode(EGA_WRITE_MODE_0);
+}
+
 /*
  * rle_decode - Decode RLE-encoded data for one EGA plane
  * 
@@ -156,6 +223,8 @@ void enable_ega_plane_read_write(uint8_t plane)
  * 
  * Safety: Validates source buffer bounds to prevent reading beyond truncated files.
  * If source data ends prematurely, stops decoding and returns bytes consumed.
+ * load_fullscreen_graphic() only uses this decoder for streams the fast
+ * path (rle_decode_planes_fast) rejects.
  */
 uint16_t rle_decode(uint8_t *src_ptr, uint16_t src_size, uint16_t dst_offset, uint16_t plane_size)
 {
@@ -197,7 +266,7 @@ uint16_t rle_decode(uint8_t *src_ptr, uint16_t src_size, uint16_t dst_offset, ui
                 
                 byte_value = *src_ptr++;  /* Read literal byte */
                 bytes_consumed++;
-                *video_ptr++ = byte_value;
+                VRAM_WRITE(video_ptr++, byte_value);
                 bytes_decoded++;
             }
         } else {
@@ -227,7 +296,7 @@ uint16_t rle_decode(uint8_t *src_ptr, uint16_t src_size, uint16_t dst_offset, ui
             
             /* Output the repeated byte */
             for (; repeat_count > 0; repeat_count--) {
-                *video_ptr++ = byte_value;
+                VRAM_WRITE(video_ptr++, byte_value);
                 bytes_decoded++;
             }
         }
@@ -237,14 +306,178 @@ uint16_t rle_decode(uint8_t *src_ptr, uint16_t src_size, uint16_t dst_offset, ui
 }
 
 /*
- * load_fullscreen_graphic - Load and decode a fullscreen .EGA graphic from disk
+ * Fast RLE decoding for fullscreen graphics
+ * 
+ * rle_scan_plane() walks one plane's control bytes up front, checking once
+ * per run that the run's source bytes exist and that it stays inside the
+ * plane. When all four planes pass, rle_decode_planes_fast() decodes them
+ * together without any further checks, emitting each run with
+ * _fmemset/_fmemcpy (rep stosb / rep movsb). Where the four planes are in
+ * the same repeat run (black, white and grey areas), the bytes are written
+ * once with the Map Mask set to 0x0f. Otherwise each plane's share of the
+ * span is written with only that plane enabled. Streams that fail the scan
+ * go through the byte-at-a-time rle_decode() instead.
+ */
+typedef struct {
+    const uint8_t *src;  /* Next source byte (literal data or next control byte) */
+    uint8_t run_left;    /* Bytes left in the current run */
+    uint8_t run_repeat;  /* 1 = repeat run, 0 = literal run */
+    uint8_t run_value;   /* Byte repeated by a repeat run */
+} rle_stream_t;
+
+/*
+ * rle_scan_plane - Validate one plane's RLE stream and find its length
+ * 
+ * Input:
+ *   src_ptr    = start of the plane's RLE data
+ *   src_size   = bytes available from src_ptr
+ *   plane_size = bytes the plane must decode to
+ * 
+ * Returns:
+ *   Number of source bytes the plane uses, or 0 if the stream is truncated
+ *   or a run would overrun the plane
+ */
+static uint16_t rle_scan_plane(const uint8_t *src_ptr, uint16_t src_size, uint16_t plane_size)
+{
+    uint16_t consumed = 0;
+    uint16_t decoded = 0;
+    uint16_t count;
+    uint8_t control_byte;
+
+    while (decoded < plane_size) {
+        if (consumed >= src_size) {
+            return 0;
+        }
+        control_byte = src_ptr[consumed++];
+
+        if (control_byte < 0x80) {
+            count = control_byte;
+            if (count > src_size - consumed) {
+                return 0;
+            }
+            consumed += count;
+        } else {
+            count = control_byte - 128;
+            if (consumed >= src_size) {
+                return 0;
+            }
+            consumed++;
+        }
+
+        if (count > plane_size - decoded) {
+            return 0;
+        }
+        decoded += count;
+    }
+    return consumed;
+}
+
+/*
+ * rle_next_run - Load the next non-empty run of a validated stream
+ */
+static void rle_next_run(rle_stream_t *stream)
+{
+    uint8_t control_byte;
+
+    do {
+        control_byte = *stream->src++;
+        if (control_byte < 0x80) {
+            stream->run_left = control_byte;
+            stream->run_repeat = 0;
+        } else {
+            stream->run_left = control_byte - 128;
+            stream->run_repeat = 1;
+            stream->run_value = *stream->src++;
+        }
+    } while (stream->run_left == 0);
+}
+
+/*
+ * rle_decode_planes_fast - Decode four validated RLE planes in one pass
+ * 
+ * Input:
+ *   plane_src  = start of each plane's RLE data (each checked by rle_scan_plane)
+ *   dst_offset = offset in video memory where the planes go
+ *   plane_size = bytes per plane
+ * 
+ * Every byte of every plane is written, so no clear pass is needed.
+ * Leaves the Map Mask at whatever the last span used.
+ */
+static void rle_decode_planes_fast(const uint8_t *plane_src[4], uint16_t dst_offset, uint16_t plane_size)
+{
+    rle_stream_t streams[4];
+    uint8_t __far *dst = (uint8_t __far *)MK_FP(VIDEO_MEMORY_BASE, dst_offset);
+    uint16_t pos = 0;
+    uint8_t current_mask = 0;
+    uint8_t span;
+    uint8_t shared;
+    uint8_t plane;
+
+    for (plane = 0; plane < 4; plane++) {
+        streams[plane].src = plane_src[plane];
+        streams[plane].run_left = 0;
+    }
+
+    /* Only the Map Mask data port changes below */
+    VRAM_OUTP(EGA_SEQUENCER_INDEX_PORT, EGA_WRITE_PLANE_ENABLE);
+
+    while (pos < plane_size) {
+        /* The span is as long as the shortest current run across the planes */
+        span = 0xff;
+        for (plane = 0; plane < 4; plane++) {
+            if (streams[plane].run_left == 0) {
+                rle_next_run(&streams[plane]);
+            }
+            if (streams[plane].run_left < span) {
+                span = streams[plane].run_left;
+            }
+        }
+
+        shared = streams[0].run_repeat;
+        for (plane = 1; plane < 4 && shared; plane++) {
+            shared = streams[plane].run_repeat &&
+                     streams[plane].run_value == streams[0].run_value;
+        }
+
+        if (shared) {
+            /* Same repeated byte in every plane: one write reaches all four */
+            if (current_mask != 0x0f) {
+                VRAM_OUTP(EGA_SEQUENCER_DATA_PORT, 0x0f);
+                current_mask = 0x0f;
+            }
+            VRAM_FILL(dst + pos, streams[0].run_value, span);
+        } else {
+            for (plane = 0; plane < 4; plane++) {
+                if (current_mask != (uint8_t)(1 << plane)) {
+                    current_mask = (uint8_t)(1 << plane);
+                    VRAM_OUTP(EGA_SEQUENCER_DATA_PORT, current_mask);
+                }
+                if (streams[plane].run_repeat) {
+                    VRAM_FILL(dst + pos, streams[plane].run_value, span);
+                } else {
+                    VRAM_COPY_TO(dst + pos, streams[plane].src, span);
+                    streams[plane].src += span;
+                }
+            }
+        }
+
+        for (plane = 0; plane < 4; plane++) {
+            streams[plane].run_left -= span;
+        }
+        pos += span;
+    }
+}
+
+/*
+ * decode_fullscreen_graphic - Load and decode a fullscreen .EGA graphic from disk
  * 
  * Input:
  *   filename = pointer to null-terminated filename (e.g., "SYS000.EGA")
  *   dst_offset = video memory offset where graphic goes (0x0000, 0x8000, etc.)
  * 
  * Process:
- *   1. Open file using DOS INT 21h
+ *   0. If the decoded graphic is cached (graphic_cache.c), copy it and return
+ *   1. Open file
  *   2. Read entire file into temporary buffer
  *   3. Close file
  *   4. Decode RLE data for each of 4 EGA planes
@@ -260,59 +493,45 @@ uint16_t rle_decode(uint8_t *src_ptr, uint16_t src_size, uint16_t dst_offset, ui
  *   -1 if file open failed
  *   -2 if file read failed
  */
-int load_fullscreen_graphic(const char *filename, uint16_t dst_offset)
+static int decode_fullscreen_graphic(const char *filename, uint16_t dst_offset)
 {
-    union REGS regs;
-    struct SREGS sregs;
     int file_handle;
+    int read_result;
     uint16_t bytes_read;
     uint8_t *src_ptr;
     uint16_t plane_size;
     uint8_t plane;
     uint16_t src_offset;
     uint16_t remaining_src_bytes;
+    uint16_t plane_bytes;
+    const uint8_t *plane_src[4];
+    
+    /* Queued sprites belong underneath the new graphic */
+    sprite_queue_flush();
     
-    /* Open the file (DOS INT 21h AH=3Dh) */
-    /* Must set DS:DX to point to filename string for large memory model */
-    regs.h.ah = 0x3d;  /* AH=3Dh: open existing file */
-    regs.h.al = 0x00;  /* AL=00h: read-only */
-    regs.x.dx = FP_OFF(filename);  /* DX = offset of filename */
-    sregs.ds = FP_SEG(filename);   /* DS = segment of filename */
-    int86x(0x21, &regs, &regs, &sregs);
+    /* The destination page no longer matches the rendered map */
+    dirty_rects_invalidate();
+    
+    /* Graphics shown before are copied from the decoded-plane cache */
+    if (graphic_cache_restore(filename, dst_offset)) {
+        return 0;
+    }
     
-    if (regs.x.cflag) {
+    /* Open the file */
+    file_handle = _open(filename, O_RDONLY | O_BINARY);
+    if (file_handle == -1) {
         fprintf(stderr, "ERROR: Failed to open file '%s'\n", filename);
         return -1;  /* File open failed */
     }
     
-    file_handle = regs.x.ax;
-    
-    /* Read entire file into temporary buffer (DOS INT 21h AH=3Fh) */
-    /* Must set DS:DX to point to buffer for large memory model */
-    regs.h.ah = 0x3f;  /* AH=3Fh: read from file */
-    regs.x.bx = file_handle;
-    regs.x.cx = GRAPHICS_LOAD_BUFFER_SIZE;  /* Max bytes to read */
-    regs.x.dx = FP_OFF(graphics_load_buffer);  /* DX = offset of buffer */
-    sregs.ds = FP_SEG(graphics_load_buffer);   /* DS = segment of buffer */
-    int86x(0x21, &regs, &regs, &sregs);
-
-    /* Check for read error (carry flag set) */
-    if (regs.x.cflag) {
+    /* Read entire file into temporary buffer */
+    read_result = _read(file_handle, graphics_load_buffer, GRAPHICS_LOAD_BUFFER_SIZE);
+    _close(file_handle);
+    if (read_result == -1) {
         fprintf(stderr, "ERROR: Failed to read file '%s'\n", filename);
-        /* Close the file before returning */
-        regs.h.ah = 0x3e;  /* AH=3Eh: close file */
-        regs.x.bx = file_handle;
-        int86(0x21, &regs, &regs);
         return -2;  /* File read failed (per documentation) */
     }
-
-    /* Save number of bytes actually read (AX) */
-    bytes_read = regs.x.ax;
-    
-    /* Close the file (DOS INT 21h AH=3Eh) */
-    regs.h.ah = 0x3e;  /* AH=3Eh: close file */
-    regs.x.bx = file_handle;
-    int86(0x21, &regs, &regs);
+    bytes_read = (uint16_t)read_result;
     
     /* Validate file has at least the 2-byte header */
     if (bytes_read < 2) {
@@ -334,24 +553,31 @@ int load_fullscreen_graphic(const char *filename, uint16_t dst_offset)
     
     src_offset = 2;  /* Skip past the plane size word */
     
-    /* Clear the destination buffer to black (zeros) before decoding */
-    /* This is important to ensure old video data doesn't show through */
-    {
-        uint8_t plane_clear;
-        uint16_t i;
-        uint8_t __far *video_ptr;
-        
-        /* Clear all 4 planes */
-        for (plane_clear = 0; plane_clear < 4; plane_clear++) {
-            enable_ega_plane_write(plane_clear);
-            video_ptr = (uint8_t __far *)MK_FP(0xa000, dst_offset);
-            
-            /* Clear 8000 bytes (one full plane) with zeros */
-            for (i = 0; i < 8000; i++) {
-                *video_ptr++ = 0x00;
-            }
+    /* Fast path: if all four plane streams are complete and well formed,
+     * decode them together with string instructions */
+    for (plane = 0; plane < 4; plane++) {
+        if (bytes_read <= src_offset) {
+            break;
         }
+        plane_bytes = rle_scan_plane(&src_ptr[src_offset], bytes_read - src_offset, plane_size);
+        if (plane_bytes == 0) {
+            break;
+        }
+        plane_src[plane] = &src_ptr[src_offset];
+        src_offset += plane_bytes;
+    }
+    if (plane == 4) {
+        rle_decode_planes_fast(plane_src, dst_offset, plane_size);
+        graphic_cache_store(filename, dst_offset);
+        return 0;
     }
+    src_offset = 2;
+    
+    /* Clear the destination buffer to black (zeros) before decoding */
+    /* This is important to ensure old video data doesn't show through */
+    /* All four planes are cleared at once with the Map Mask set to 0x0f */
+    enable_ega_plane_write_all();
+    VRAM_FILL((uint8_t __far *)MK_FP(VIDEO_MEMORY_BASE, dst_offset), 0x00, 8000);
     
     /* Decode and write each of the 4 EGA planes */
     /* Standard BGRI order: Blue(0), Green(1), Red(2), Intensity(3) */
@@ -370,9 +596,25 @@ int load_fullscreen_graphic(const char *filename, uint16_t dst_offset)
         src_offset += rle_decode(&src_ptr[src_offset], remaining_src_bytes, dst_offset, plane_size);
     }
     
+    graphic_cache_store(filename, dst_offset);
     return 0;  /* Success */
 }
 
+/*
+ * load_fullscreen_graphic - Load and decode a fullscreen .EGA graphic
+ * 
+ * decode_fullscreen_graphic() as one span of the tick trace (see trace.h).
+ */
+int load_fullscreen_graphic(const char *filename, uint16_t dst_offset)
+{
+    int result;
+
+    TRACE_BEGIN(LOAD_FULLSCREEN_GRAPHIC, dst_offset);
+    result = decode_fullscreen_graphic(filename, dst_offset);
+    TRACE_END(LOAD_FULLSCREEN_GRAPHIC);
+    return result;
+}
+
 /*
  * switch_video_buffer - Change which video memory buffer is displayed
  * 
@@ -400,12 +642,12 @@ void switch_video_buffer(uint16_t buffer_offset)
      */
     
     /* Write to CRTC Start Address High Register (0x0c) */
-    outp(EGA_CRTC_INDEX_PORT, 0x0c);
-    outp(EGA_CRTC_DATA_PORT, (buffer_offset >> 8) & 0xff);
+    VRAM_OUTP(EGA_CRTC_INDEX_PORT, 0x0c);
+    VRAM_OUTP(EGA_CRTC_DATA_PORT, (buffer_offset >> 8) & 0xff);
     
     /* Write to CRTC Start Address Low Register (0x0d) */
-    outp(EGA_CRTC_INDEX_PORT, 0x0d);
-    outp(EGA_CRTC_DATA_PORT, buffer_offset & 0xff);
+    VRAM_OUTP(EGA_CRTC_INDEX_PORT, 0x0d);
+    VRAM_OUTP(EGA_CRTC_DATA_PORT, buffer_offset & 0xff);
     
     current_display_offset = buffer_offset;
 }
@@ -577,6 +819,8 @@ void copy_ega_plane(uint16_t src_offset, uint16_t dst_offset, uint16_t num_bytes
     uint8_t __far *src_ptr;
     uint8_t __far *dst_ptr;
     
+    dirty_rects_invalidate();
+    
     /* Copy each of the 4 EGA planes independently */
     for (plane = 0; plane < 4; plane++) {
         /* Select plane for both reading and writing */
@@ -588,7 +832,7 @@ void copy_ega_plane(uint16_t src_offset, uint16_t dst_offset, uint16_t num_bytes
         
         /* Copy bytes for this plane */
         for (i = 0; i < num_bytes; i++) {
-            dst_ptr[i] = src_ptr[i];
+            VRAM_WRITE(dst_ptr + i, VRAM_READ(src_ptr + i));
         }
     }
 }
@@ -604,14 +848,466 @@ void copy_plane_bytes(uint16_t src_offset, uint16_t dst_offset, uint16_t num_byt
     uint16_t i;
 
     for (i = 0; i < num_bytes; i++) {
-        dst_ptr[i] = src_ptr[i];
+        VRAM_WRITE(dst_ptr + i, VRAM_READ(src_ptr + i));
+    }
+}
+
+/*
+ * Sprite blit descriptors and the per-frame submission queue
+ * 
+ * Every 16-pixel and 8-pixel sprite blit is described by a sprite_blit_t and
+ * drawn one plane at a time by draw_sprite_plane(). Outside a batch, a blit
+ * programs the plane registers and draws all four planes immediately. While
+ * a batch is open (sprite_queue_begin), blits are queued and the queue is
+ * drawn plane-major on flush: the Map Mask and Read Map Select registers
+ * are programmed once per plane per frame instead of once per plane per
+ * sprite. Sprites are drawn in submission order within each plane, so the
+ * result is identical to drawing them immediately.
+ * 
+ * Gameplay sprites are redrawn every tick, so they go to the offscreen
+ * buffer only. Static UI (score, inventory, HP and fireball meters, life
+ * icons) must survive page flips and uses the *_both_pages blitters.
+ */
+#define SPRITE_KIND_MASKED_16    0  /* 16 wide, 4 planes + mask (read-modify-write) */
+#define SPRITE_KIND_UNMASKED_16  1  /* 16 wide, 4 planes, overwrites background */
+#define SPRITE_KIND_UNMASKED_8   2  /* 8 wide, 4 planes, overwrites background */
+#define SPRITE_KIND_COMPILED     3  /* Generated per-plane routines (compiled_sprites.c) */
+#define SPRITE_KIND_MASKED_16_BM 4  /* Same data as MASKED_16, merged by the GC Bit Mask */
+
+/* Destination pages (sprite_blit_t.pages) */
+#define SPRITE_PAGE_A            0x01
+#define SPRITE_PAGE_B            0x02
+#define SPRITE_PAGES_BOTH        (SPRITE_PAGE_A | SPRITE_PAGE_B)
+
+#define SPRITE_QUEUE_SIZE        32
+
+typedef struct {
+    const uint8_t __far *data;  /* Sprite data (unused for compiled sprites) */
+    uint16_t base_offset;       /* Top-left offset relative to the page start */
+    uint8_t kind;               /* SPRITE_KIND_* */
+    uint8_t sprite_rows;        /* Rows stored per plane in the sprite data */
+    uint8_t draw_rows;          /* Rows to draw, from the top */
+    uint8_t compiled_id;        /* COMPILED_SPRITE_* for SPRITE_KIND_COMPILED */
+    uint8_t pages;              /* SPRITE_PAGE_* bits to draw into */
+} sprite_blit_t;
+
+static sprite_blit_t sprite_queue[SPRITE_QUEUE_SIZE];
+static uint8_t sprite_queue_count = 0;
+static uint8_t sprite_queue_active = 0;
+static uint8_t sprite_queue_skip_offscreen = 0;  /* Drop offscreen-only blits until the batch ends */
+
+/* Kind used for masked 16-pixel sprites; chosen by set_masked_blit_engine() */
+static uint8_t masked_sprite_kind = SPRITE_KIND_MASKED_16;
+
+/*
+ * draw_sprite_plane_page - Draw one plane of a sprite into one gameplay page
+ * 
+ * The caller must already have selected the plane for reading and writing.
+ * Masked sprites combine as (background & mask) | (sprite & ~mask): a mask
+ * bit of 1 keeps the background.
+ */
+static void draw_sprite_plane_page(const sprite_blit_t *blit, uint8_t plane, uint16_t page)
+{
+    uint8_t __far *video_ptr;
+    uint8_t row;
+
+    video_ptr = (uint8_t __far *)MK_FP(VIDEO_MEMORY_BASE, page + blit->base_offset);
+
+    switch (blit->kind) {
+        case SPRITE_KIND_MASKED_16: {
+            uint16_t plane_size = (uint16_t)blit->sprite_rows * 2;
+            const uint8_t __far *plane_data = blit->data + plane * plane_size;
+            const uint8_t __far *mask_data = blit->data + 4 * plane_size;
+            uint8_t m0, m1;
+
+            for (row = 0; row < blit->draw_rows; row++) {
+                m0 = mask_data[0];
+                m1 = mask_data[1];
+
+                VRAM_WRITE(video_ptr, (VRAM_READ(video_ptr) & m0) | (plane_data[0] & ~m0));
+                VRAM_WRITE(video_ptr + 1, (VRAM_READ(video_ptr + 1) & m1) | (plane_data[1] & ~m1));
+
+                plane_data += 2;
+                mask_data += 2;
+                video_ptr += SCREEN_WIDTH / 8;
+            }
+            break;
+        }
+        case SPRITE_KIND_UNMASKED_16: {
+            const uint8_t __far *plane_data = blit->data + plane * ((uint16_t)blit->sprite_rows * 2);
+
+            for (row = 0; row < blit->draw_rows; row++) {
+                VRAM_WRITE(video_ptr, plane_data[0]);
+                VRAM_WRITE(video_ptr + 1, plane_data[1]);
+
+                plane_data += 2;
+                video_ptr += SCREEN_WIDTH / 8;
+            }
+            break;
+        }
+        case SPRITE_KIND_UNMASKED_8: {
+            const uint8_t __far *plane_data = blit->data + plane * (uint16_t)blit->sprite_rows;
+
+            for (row = 0; row < blit->draw_rows; row++) {
+                VRAM_WRITE(video_ptr, plane_data[row]);
+                video_ptr += SCREEN_WIDTH / 8;
+            }
+            break;
+        }
+        case SPRITE_KIND_COMPILED:
+            draw_compiled_sprite_plane(blit->compiled_id, plane, video_ptr);
+            break;
+        default:
+            /* SPRITE_KIND_MASKED_16_BM draws all planes at once */
+            break;
+    }
+}
+
+/*
+ * draw_sprite_plane - Draw one plane of a sprite into each page it targets
+ */
+static void draw_sprite_plane(const sprite_blit_t *blit, uint8_t plane)
+{
+    if (blit->pages & SPRITE_PAGE_A) {
+        draw_sprite_plane_page(blit, plane, GRAPHICS_BUFFER_GAMEPLAY_A);
+    }
+    if (blit->pages & SPRITE_PAGE_B) {
+        draw_sprite_plane_page(blit, plane, GRAPHICS_BUFFER_GAMEPLAY_B);
+    }
+}
+
+/* Bit Mask and Map Mask values last written during a run of Bit Mask sprites */
+typedef struct {
+    uint8_t bit_mask;
+    uint8_t map_mask;
+    uint8_t descending;     /* Next byte writes planes 3..0 instead of 0..3 */
+} bitmask_ports_t;
+
+/*
+ * draw_sprite_bitmask_page - Draw a masked 16-pixel sprite using the GC Bit Mask
+ * 
+ * For each sprite byte the inverted mask is loaded into the Bit Mask
+ * register and one read of the destination loads all four plane latches
+ * with the background. Each plane's write then stores sprite bits where the
+ * Bit Mask is 1 and latched background bits where it is 0, so the merge is
+ * done by the hardware: one VRAM read per byte instead of one per plane.
+ * Fully transparent bytes are skipped and fully opaque bytes need no read.
+ * 
+ * Port writes are what this costs instead, so none is repeated: the Bit
+ * Mask is only written when the mask byte differs from the last one, and
+ * the planes are written 0..3 and 3..0 on alternate bytes so that each
+ * byte starts on the plane the last one ended on. That leaves three Map
+ * Mask writes per byte, plus one Bit Mask write per change of mask.
+ * 
+ * Input:
+ *   blit  = the sprite
+ *   page  = gameplay page offset
+ *   ports = register values left by the previous sprite in the run; updated
+ */
+static void draw_sprite_bitmask_page(const sprite_blit_t *blit, uint16_t page, bitmask_ports_t *ports)
+{
+    uint16_t plane_size = (uint16_t)blit->sprite_rows * 2;
+    const uint8_t __far *sprite_data = blit->data;
+    const uint8_t __far *mask_data = blit->data + 4 * plane_size;
+    uint8_t __far *video_ptr;
+    uint16_t src;
+    uint8_t row;
+    uint8_t col;
+    uint8_t i;
+    uint8_t plane;
+    uint8_t mask;
+
+    video_ptr = (uint8_t __far *)MK_FP(VIDEO_MEMORY_BASE, page + blit->base_offset);
+
+    for (row = 0; row < blit->draw_rows; row++) {
+        for (col = 0; col < 2; col++) {
+            src = (uint16_t)row * 2 + col;
+            mask = mask_data[src];
+            if (mask == 0xff) {
+                continue;  /* Fully transparent */
+            }
+
+            if (ports->bit_mask != (uint8_t)~mask) {
+                ports->bit_mask = (uint8_t)~mask;
+                VRAM_OUTP(EGA_GRAPHICS_DATA_PORT, ports->bit_mask);
+            }
+            if (mask != 0x00) {
+                /* Load all four latches with the background (volatile so the read is kept) */
+                (void)VRAM_READ((volatile uint8_t __far *)video_ptr + col);
+            }
+            for (i = 0; i < 4; i++) {
+                plane = ports->descending ? (uint8_t)(3 - i) : i;
+                if (ports->map_mask != (uint8_t)(1 << plane)) {
+                    ports->map_mask = (uint8_t)(1 << plane);
+                    VRAM_OUTP(EGA_SEQUENCER_DATA_PORT, ports->map_mask);
+                }
+                VRAM_WRITE(video_ptr + col, sprite_data[plane * plane_size + src]);
+            }
+            ports->descending ^= 1;
+        }
+        video_ptr += SCREEN_WIDTH / 8;
+    }
+}
+
+/*
+ * draw_bitmask_run - Draw consecutive Bit Mask sprites into each page they target
+ * 
+ * The register indexes are selected once for the whole run, and the Bit
+ * Mask is put back to 0xff (all bits from the CPU), which is what every
+ * other blit expects, once at its end.
+ * 
+ * Input:
+ *   blits = first sprite of the run
+ *   count = number of sprites
+ */
+static void draw_bitmask_run(const sprite_blit_t *blits, uint8_t count)
+{
+    bitmask_ports_t ports;
+    uint8_t i;
+
+    /* Leave the Map Mask and Bit Mask registers selected; only data ports change below */
+    VRAM_OUTP(EGA_SEQUENCER_INDEX_PORT, EGA_WRITE_PLANE_ENABLE);
+    VRAM_OUTP(EGA_GRAPHICS_INDEX_PORT, EGA_BIT_MASK);
+    ports.bit_mask = 0xff;
+    ports.map_mask = 0;         /* Unknown: the first byte writes it */
+    ports.descending = 0;
+
+    for (i = 0; i < count; i++) {
+        if (blits[i].pages & SPRITE_PAGE_A) {
+            draw_sprite_bitmask_page(&blits[i], GRAPHICS_BUFFER_GAMEPLAY_A, &ports);
+        }
+        if (blits[i].pages & SPRITE_PAGE_B) {
+            draw_sprite_bitmask_page(&blits[i], GRAPHICS_BUFFER_GAMEPLAY_B, &ports);
+        }
+    }
+
+    if (ports.bit_mask != 0xff) {
+        VRAM_OUTP(EGA_GRAPHICS_DATA_PORT, 0xff);
     }
 }
 
+/*
+ * flush_sprite_queue - Draw all queued sprites plane by plane and empty the queue
+ * 
+ * Runs of per-plane sprites are drawn plane-major. Bit Mask sprites draw all
+ * planes in one pass, so they end the current run, and each run of them is
+ * drawn together; this keeps submission order between the two engines.
+ */
+static void flush_sprite_queue(void)
+{
+    uint8_t plane;
+    uint8_t start;
+    uint8_t end;
+    uint8_t i;
+
+    if (sprite_queue_count == 0) {
+        return;
+    }
+    TRACE_BEGIN(SPRITE_FLUSH, sprite_queue_count);
+
+    start = 0;
+    while (start < sprite_queue_count) {
+        end = start;
+        if (sprite_queue[start].kind == SPRITE_KIND_MASKED_16_BM) {
+            while (end < sprite_queue_count && sprite_queue[end].kind == SPRITE_KIND_MASKED_16_BM) {
+                end++;
+            }
+            draw_bitmask_run(&sprite_queue[start], (uint8_t)(end - start));
+            start = end;
+            continue;
+        }
+
+        while (end < sprite_queue_count && sprite_queue[end].kind != SPRITE_KIND_MASKED_16_BM) {
+            end++;
+        }
+        for (plane = 0; plane < 4; plane++) {
+            enable_ega_plane_read_write(plane);
+            for (i = start; i < end; i++) {
+                draw_sprite_plane(&sprite_queue[i], plane);
+            }
+        }
+        start = end;
+    }
+    sprite_queue_count = 0;
+    TRACE_END(SPRITE_FLUSH);
+}
+
+/*
+ * offscreen_sprite_page - SPRITE_PAGE_* bit for the current offscreen buffer
+ */
+static uint8_t offscreen_sprite_page(void)
+{
+    return (offscreen_video_buffer_ptr == GRAPHICS_BUFFER_GAMEPLAY_B) ? SPRITE_PAGE_B : SPRITE_PAGE_A;
+}
+
+/*
+ * submit_sprite_blit - Draw a sprite now, or queue it if a batch is open
+ * 
+ * blit->pages must be set. The offscreen page is resolved here, at submit
+ * time; queued sprites are always flushed before swap_video_buffers()
+ * toggles it.
+ */
+static void submit_sprite_blit(const sprite_blit_t *blit)
+{
+    uint8_t plane;
+    uint8_t width_bytes = (uint8_t)(blit->kind == SPRITE_KIND_UNMASKED_8 ? 1 : 2);
+
+    /* A frame that will not be shown needs only the UI drawn into both pages */
+    if (sprite_queue_skip_offscreen && blit->pages != SPRITE_PAGES_BOTH) {
+        return;
+    }
+
+    /* Restore the sprite's area of each page it touches on that page's next refresh */
+    if (blit->pages == SPRITE_PAGES_BOTH) {
+        dirty_rects_mark_both_pages(blit->base_offset, width_bytes, blit->draw_rows);
+    } else if (blit->pages == SPRITE_PAGE_A) {
+        dirty_rects_mark_offset(GRAPHICS_BUFFER_GAMEPLAY_A + blit->base_offset, width_bytes, blit->draw_rows);
+    } else {
+        dirty_rects_mark_offset(GRAPHICS_BUFFER_GAMEPLAY_B + blit->base_offset, width_bytes, blit->draw_rows);
+    }
+
+    if (sprite_queue_active) {
+        if (sprite_queue_count >= SPRITE_QUEUE_SIZE) {
+            flush_sprite_queue();
+        }
+        sprite_queue[sprite_queue_count++] = *blit;
+        return;
+    }
+
+    TRACE_BEGIN(SPRITE_BLIT, blit->kind);
+    if (blit->kind == SPRITE_KIND_MASKED_16_BM) {
+        draw_bitmask_run(blit, 1);
+    } else {
+        for (plane = 0; plane < 4; plane++) {
+            /* Enable BOTH reading and writing to this plane (needed for masked blitting) */
+            enable_ega_plane_read_write(plane);
+            draw_sprite_plane(blit, plane);
+        }
+    }
+    TRACE_END(SPRITE_BLIT);
+}
+
+/*
+ * sprite_queue_begin - Start collecting sprite blits for plane-major drawing
+ * 
+ * Used by game_loop for the per-tick sprite pass. Only safe while nothing
+ * else writes to the gameplay pages until the batch is flushed; code that
+ * draws directly (blit_wxh, the map restore) flushes the queue first.
+ */
+void sprite_queue_begin(void)
+{
+    sprite_queue_active = 1;
+}
+
+/*
+ * sprite_queue_flush - Draw everything queued so far; the batch stays open
+ */
+void sprite_queue_flush(void)
+{
+    flush_sprite_queue();
+}
+
+/*
+ * sprite_queue_skip_frame - Discard this batch's gameplay sprites
+ * 
+ * Used when a tick's frame will not be displayed (turbo mode drawing only
+ * every Nth tick). Sprites for the offscreen page are dropped without being
+ * drawn or marked dirty; sprites drawn into both pages still go through.
+ * Lasts until sprite_queue_end(), so a swap during the tick (a death or
+ * door animation) draws normally again.
+ */
+void sprite_queue_skip_frame(void)
+{
+    sprite_queue_skip_offscreen = 1;
+}
+
+/*
+ * sprite_queue_end - Draw everything queued and return to immediate blits
+ * 
+ * Called by swap_video_buffers() so no queued sprite misses its frame.
+ */
+void sprite_queue_end(void)
+{
+    flush_sprite_queue();
+    sprite_queue_active = 0;
+    sprite_queue_skip_offscreen = 0;
+}
+
+/*
+ * submit_sprite_at - Fill in a descriptor for a sprite at a pixel position and submit it
+ */
+static void submit_sprite_at(uint16_t pixel_x, uint16_t pixel_y, const uint8_t __far *sprite_data,
+                             uint8_t kind, uint8_t rows, uint8_t pages)
+{
+    sprite_blit_t blit;
+
+    blit.data = sprite_data;
+    blit.base_offset = (pixel_y * 320 + pixel_x) / 8;
+    blit.kind = kind;
+    blit.sprite_rows = rows;
+    blit.draw_rows = rows;
+    blit.compiled_id = COMPILED_SPRITE_NONE;
+    blit.pages = pages;
+    submit_sprite_blit(&blit);
+}
+
+/*
+ * set_masked_blit_engine - Select how masked 16-pixel sprites are drawn
+ * 
+ * Input:
+ *   engine = MASKED_BLIT_ENGINE_CPU (read-modify-write per plane, default) or
+ *            MASKED_BLIT_ENGINE_BITMASK (GC Bit Mask register and latches)
+ * 
+ * Applies to blit_sprite_16x8_masked, blit_sprite_16x16_masked,
+ * blit_sprite_16x32_masked and blit_sprite_16x32_masked_rows. Chosen once
+ * at startup; sprites already queued keep the engine they were submitted with.
+ */
+void set_masked_blit_engine(uint8_t engine)
+{
+    if (engine == MASKED_BLIT_ENGINE_BITMASK) {
+        masked_sprite_kind = SPRITE_KIND_MASKED_16_BM;
+    } else {
+        masked_sprite_kind = SPRITE_KIND_MASKED_16;
+    }
+}
+
+/*
+ * get_masked_blit_engine - Return the current MASKED_BLIT_ENGINE_* value
+ */
+uint8_t get_masked_blit_engine(void)
+{
+    if (masked_sprite_kind == SPRITE_KIND_MASKED_16_BM) {
+        return MASKED_BLIT_ENGINE_BITMASK;
+    }
+    return MASKED_BLIT_ENGINE_CPU;
+}
+
+/*
+ * submit_compiled_sprite - Draw or queue a compiled sprite
+ * 
+ * Input:
+ *   sprite_id   = COMPILED_SPRITE_* ID
+ *   base_offset = top-left offset relative to the page start
+ *   rows        = sprite height in pixel rows
+ */
+void submit_compiled_sprite(uint8_t sprite_id, uint16_t base_offset, uint8_t rows)
+{
+    sprite_blit_t blit;
+
+    blit.data = NULL;
+    blit.base_offset = base_offset;
+    blit.kind = SPRITE_KIND_COMPILED;
+    blit.sprite_rows = rows;
+    blit.draw_rows = rows;
+    blit.compiled_id = sprite_id;
+    blit.pages = offscreen_sprite_page();
+    submit_sprite_blit(&blit);
+}
+
 /*
  * blit_sprite_16x16_masked - Blit a 16x16 masked EGA sprite to video memory
  * 
- * Blits a 16x16 sprite with mask to both gameplay buffers (0x0000 and 0x2000)
+ * Blits a 16x16 sprite with mask to the offscreen gameplay buffer
  * at the specified pixel coordinate. The sprite is in EGA planar format.
  * Works with both embedded sprites and runtime-loaded .SHP sprites.
  * 
@@ -630,67 +1326,25 @@ void copy_plane_bytes(uint16_t src_offset, uint16_t dst_offset, uint16_t num_byt
  */
 void blit_sprite_16x16_masked(uint16_t pixel_x, uint16_t pixel_y, const uint8_t *sprite_data)
 {
-    uint16_t base_offset;
-    uint8_t plane;
-    uint8_t row;
-    uint8_t col;
-    uint8_t sprite_byte;
-    uint8_t mask_byte;
-    uint8_t current_a;
-    uint8_t current_b;
-    uint16_t video_offset;
-    uint8_t __far *video_ptr_a;
-    uint8_t __far *video_ptr_b;
-    const uint8_t *plane_data;
-    const uint8_t *mask_data;
-    uint16_t plane_offset;
-    
-    /* Calculate video memory offset for top-left corner of sprite */
-    base_offset = (pixel_y * 320 + pixel_x) / 8;
-    
-    /* Mask data starts at byte 128 of the sprite */
-    mask_data = sprite_data + 128;
-    
-    /* Blit each of the 4 color planes */
-    for (plane = 0; plane < 4; plane++) {
-        /* Enable BOTH reading and writing to this plane (needed for masked blitting) */
-        enable_ega_plane_read_write(plane);
-        
-        /* Plane data: Blue=0, Green=32, Red=64, Intensity=96 bytes offset */
-        plane_offset = plane * 32;
-        plane_data = sprite_data + plane_offset;
-        
-        /* Copy this plane to both buffers, 2 bytes per row (16 pixels wide) */
-        for (row = 0; row < 16; row++) {
-            /* Calculate video offset for this row */
-            video_offset = base_offset + (row * 40);
-            
-            /* Get pointers to both video buffers for this row */
-            video_ptr_a = (uint8_t __far *)MK_FP(VIDEO_MEMORY_BASE, GRAPHICS_BUFFER_GAMEPLAY_A + video_offset);
-            video_ptr_b = (uint8_t __far *)MK_FP(VIDEO_MEMORY_BASE, GRAPHICS_BUFFER_GAMEPLAY_B + video_offset);
-            
-            /* Copy 2 bytes per row (16 pixels in EGA format = 2 bytes) */
-            for (col = 0; col < 2; col++) {
-                sprite_byte = plane_data[row * 2 + col];
-                mask_byte = mask_data[row * 2 + col];
-                
-                /* Read current video memory */
-                current_a = video_ptr_a[col];
-                current_b = video_ptr_b[col];
-                
-                /* Apply masking: bit=1 keeps background, bit=0 writes sprite */
-                video_ptr_a[col] = (current_a & mask_byte) | (sprite_byte & ~mask_byte);
-                video_ptr_b[col] = (current_b & mask_byte) | (sprite_byte & ~mask_byte);
-            }
-        }
-    }
+    submit_sprite_at(pixel_x, pixel_y, sprite_data, masked_sprite_kind, 16, offscreen_sprite_page());
+}
+
+/*
+ * blit_sprite_16x16_masked_both_pages - Blit a 16x16 masked sprite to both gameplay buffers
+ * 
+ * For static UI (life icons) that must persist across page flips.
+ * Same input and sprite format as blit_sprite_16x16_masked().
+ */
+void blit_sprite_16x16_masked_both_pages(uint16_t pixel_x, uint16_t pixel_y, const uint8_t *sprite_data)
+{
+    submit_sprite_at(pixel_x, pixel_y, sprite_data, masked_sprite_kind, 16, SPRITE_PAGES_BOTH);
 }
 
 
 /*
  * blit_sprite_16x16_unmasked - Blit a 16x16 unmasked EGA sprite to video memory
  * 
- * Blits a 16x16 sprite without mask to both gameplay buffers (0x0000 and 0x2000)
+ * Blits a 16x16 sprite without mask to the offscreen gameplay buffer
  * at the specified pixel coordinate. Completely overwrites the destination area.
  * The sprite is in EGA planar format (128 bytes: 32 bytes per plane × 4 planes).
  * 
@@ -707,44 +1361,7 @@ void blit_sprite_16x16_masked(uint16_t pixel_x, uint16_t pixel_y, const uint8_t
  */
 void blit_sprite_16x16_unmasked(uint16_t pixel_x, uint16_t pixel_y, const uint8_t *sprite_data)
 {
-    uint16_t base_offset;
-    uint8_t plane;
-    uint8_t row;
-    uint8_t col;
-    uint16_t video_offset;
-    uint8_t __far *video_ptr_a;
-    uint8_t __far *video_ptr_b;
-    const uint8_t *plane_data;
-    uint16_t plane_offset;
-    
-    /* Calculate video memory offset for top-left corner of sprite */
-    base_offset = (pixel_y * 320 + pixel_x) / 8;
-    
-    /* Blit each of the 4 color planes */
-    for (plane = 0; plane < 4; plane++) {
-        /* Enable writing to this plane only (no need to read for unmasked) */
-        enable_ega_plane_write(plane);
-        
-        /* Plane data: Blue=0, Green=32, Red=64, Intensity=96 bytes offset */
-        plane_offset = plane * 32;
-        plane_data = sprite_data + plane_offset;
-        
-        /* Copy this plane to both buffers, 2 bytes per row (16 pixels wide) */
-        for (row = 0; row < 16; row++) {
-            /* Calculate video offset for this row */
-            video_offset = base_offset + (row * 40);
-            
-            /* Get pointers to both video buffers for this row */
-            video_ptr_a = (uint8_t __far *)MK_FP(VIDEO_MEMORY_BASE, GRAPHICS_BUFFER_GAMEPLAY_A + video_offset);
-            video_ptr_b = (uint8_t __far *)MK_FP(VIDEO_MEMORY_BASE, GRAPHICS_BUFFER_GAMEPLAY_B + video_offset);
-            
-            /* Copy 2 bytes per row (16 pixels in EGA format = 2 bytes) - direct overwrite */
-            for (col = 0; col < 2; col++) {
-                video_ptr_a[col] = plane_data[row * 2 + col];
-                video_ptr_b[col] = plane_data[row * 2 + col];
-            }
-        }
-    }
+    submit_sprite_at(pixel_x, pixel_y, sprite_data, SPRITE_KIND_UNMASKED_16, 16, offscreen_sprite_page());
 }
 
 
@@ -760,75 +1377,7 @@ void blit_sprite_16x16_unmasked(uint16_t pixel_x, uint16_t pixel_y, const uint8_
  */
 void blit_sprite_16x32_masked(uint16_t pixel_x, uint16_t pixel_y, const uint8_t *sprite_data)
 {
-    uint16_t base_offset;
-    uint8_t plane;
-    uint8_t row;
-    uint8_t rows_to_draw;
-    const uint8_t *plane_base;
-    const uint8_t *mask_base;
-    uint8_t __far *video_ptr_a;
-    uint8_t __far *video_ptr_b;
-    uint16_t screen_row_bytes;
-    uint8_t b0;
-    uint8_t b1;
-    uint8_t m0;
-    uint8_t m1;
-
-    /* Validate sprite doesn't exceed screen bounds
-     * Screen is 320×200; sprite is 16×32
-     * Sprite extends from (pixel_x, pixel_y) to (pixel_x+15, pixel_y+31) */
-    
-    /* Check horizontal bounds: pixel_x must fit within screen and sprite can't overflow */
-    if (pixel_x >= SCREEN_WIDTH || pixel_x + 16 > SCREEN_WIDTH) {
-        return;  /* Sprite entirely or partially off-screen horizontally */
-    }
-    
-    /* Check vertical bounds: pixel_y must be within screen */
-    if (pixel_y >= SCREEN_HEIGHT) {
-        return;  /* Sprite entirely off-screen vertically (below bottom) */
-    }
-    
-    /* Calculate how many rows we can safely draw
-     * If sprite extends past screen bottom, limit rows to fit within screen */
-    if (pixel_y + 32 > SCREEN_HEIGHT) {
-        rows_to_draw = SCREEN_HEIGHT - pixel_y;  /* Clamp to remaining screen height */
-    } else {
-        rows_to_draw = 32;  /* Full sprite fits */
-    }
-
-    base_offset = (pixel_y * 320 + pixel_x) / 8;
-    mask_base = sprite_data + 256;
-    screen_row_bytes = SCREEN_WIDTH / 8; /* 40 */
-
-    /* For each plane, copy rows to both buffers */
-    for (plane = 0; plane < 4; plane++) {
-        plane_base = sprite_data + plane * 64; /* 64 bytes per plane */
-
-        /* Start at top row for both buffers */
-        video_ptr_a = (uint8_t __far *)MK_FP(VIDEO_MEMORY_BASE, GRAPHICS_BUFFER_GAMEPLAY_A + base_offset);
-        video_ptr_b = (uint8_t __far *)MK_FP(VIDEO_MEMORY_BASE, GRAPHICS_BUFFER_GAMEPLAY_B + base_offset);
-
-        /* Enable plane for both reading and writing */
-        enable_ega_plane_read_write(plane);
-
-        for (row = 0; row < rows_to_draw; row++) {
-            /* Two bytes per row */
-            b0 = plane_base[row * 2 + 0];
-            b1 = plane_base[row * 2 + 1];
-            m0 = mask_base[row * 2 + 0];
-            m1 = mask_base[row * 2 + 1];
-
-            video_ptr_a[0] = (video_ptr_a[0] & m0) | (b0 & ~m0);
-            video_ptr_a[1] = (video_ptr_a[1] & m1) | (b1 & ~m1);
-
-            video_ptr_b[0] = (video_ptr_b[0] & m0) | (b0 & ~m0);
-            video_ptr_b[1] = (video_ptr_b[1] & m1) | (b1 & ~m1);
-
-            /* Advance to next screen row (40 bytes) */
-            video_ptr_a += screen_row_bytes;
-            video_ptr_b += screen_row_bytes;
-        }
-    }
+    blit_sprite_16x32_masked_rows(pixel_x, pixel_y, sprite_data, 32);
 }
 
 /*
@@ -847,25 +1396,15 @@ void blit_sprite_16x32_masked(uint16_t pixel_x, uint16_t pixel_y, const uint8_t
  *   rows: number of rows to draw (1-32), top-origin
  *
  * Behavior:
+ *   - Rejects sprites that overflow the screen horizontally or start below it
  *   - Clamps rows to 1..32 and to available screen space (bottom edge)
  *   - Draws only the first 'rows' rows of the sprite, using mask combine
- *   - Writes to both gameplay buffers (A and B) to keep them in sync
+ *   - Writes to the offscreen gameplay buffer only
  */
 void blit_sprite_16x32_masked_rows(uint16_t pixel_x, uint16_t pixel_y, const uint8_t *sprite_data, uint8_t rows)
 {
-    uint16_t base_offset;
-    uint8_t plane;
-    uint8_t row;
+    sprite_blit_t blit;
     uint8_t rows_to_draw;
-    const uint8_t *plane_base;
-    const uint8_t *mask_base;
-    uint8_t __far *video_ptr_a;
-    uint8_t __far *video_ptr_b;
-    uint16_t screen_row_bytes;
-    uint8_t b0;
-    uint8_t b1;
-    uint8_t m0;
-    uint8_t m1;
 
     /* Horizontal bounds: sprite is 16px wide and must not overflow */
     if (pixel_x >= SCREEN_WIDTH || pixel_x + 16 > SCREEN_WIDTH) {
@@ -895,39 +1434,14 @@ void blit_sprite_16x32_masked_rows(uint16_t pixel_x, uint16_t pixel_y, const uin
         return;
     }
 
-    base_offset = (uint16_t)((pixel_y * 320 + pixel_x) / 8);
-    mask_base = sprite_data + 256;
-    screen_row_bytes = SCREEN_WIDTH / 8; /* 40 */
-
-    /* For each plane, copy rows to both buffers */
-    for (plane = 0; plane < 4; plane++) {
-        plane_base = sprite_data + plane * 64; /* 64 bytes per plane */
-
-        /* Start at top row for both buffers */
-        video_ptr_a = (uint8_t __far *)MK_FP(VIDEO_MEMORY_BASE, GRAPHICS_BUFFER_GAMEPLAY_A + base_offset);
-        video_ptr_b = (uint8_t __far *)MK_FP(VIDEO_MEMORY_BASE, GRAPHICS_BUFFER_GAMEPLAY_B + base_offset);
-
-        /* Enable plane for both reading and writing */
-        enable_ega_plane_read_write(plane);
-
-        for (row = 0; row < rows_to_draw; row++) {
-            /* Two bytes per row */
-            b0 = plane_base[row * 2 + 0];
-            b1 = plane_base[row * 2 + 1];
-            m0 = mask_base[row * 2 + 0];
-            m1 = mask_base[row * 2 + 1];
-
-            video_ptr_a[0] = (video_ptr_a[0] & m0) | (b0 & ~m0);
-            video_ptr_a[1] = (video_ptr_a[1] & m1) | (b1 & ~m1);
-
-            video_ptr_b[0] = (video_ptr_b[0] & m0) | (b0 & ~m0);
-            video_ptr_b[1] = (video_ptr_b[1] & m1) | (b1 & ~m1);
-
-            /* Advance to next screen row (40 bytes) */
-            video_ptr_a += screen_row_bytes;
-            video_ptr_b += screen_row_bytes;
-        }
-    }
+    blit.data = sprite_data;
+    blit.base_offset = (uint16_t)((pixel_y * 320 + pixel_x) / 8);
+    blit.kind = masked_sprite_kind;
+    blit.sprite_rows = 32;
+    blit.draw_rows = rows_to_draw;
+    blit.compiled_id = COMPILED_SPRITE_NONE;
+    blit.pages = offscreen_sprite_page();
+    submit_sprite_blit(&blit);
 }
 /*
  * blit_sprite_16x8_masked - Blit a 16x8 masked EGA sprite to video memory
@@ -941,50 +1455,10 @@ void blit_sprite_16x32_masked_rows(uint16_t pixel_x, uint16_t pixel_y, const uin
  */
 void blit_sprite_16x8_masked(uint16_t pixel_x, uint16_t pixel_y, const uint8_t *sprite_data)
 {
-    uint16_t base_offset;
-    uint8_t plane;
-    uint8_t row;
-    uint8_t col;
-    uint8_t sprite_byte;
-    uint8_t mask_byte;
-    uint8_t current_a;
-    uint8_t current_b;
-    uint16_t video_offset;
-    uint8_t __far *video_ptr_a;
-    uint8_t __far *video_ptr_b;
-    const uint8_t *plane_data;
-    const uint8_t *mask_data;
-    uint16_t plane_offset;
-
-    base_offset = (pixel_y * 320 + pixel_x) / 8;
-    mask_data = sprite_data + 64;
-
-    for (plane = 0; plane < 4; plane++) {
-        enable_ega_plane_read_write(plane);
-
-        plane_offset = (uint16_t)(plane * 16);
-        plane_data = sprite_data + plane_offset;
-
-        for (row = 0; row < 8; row++) {
-            video_offset = base_offset + (row * 40);
-
-            video_ptr_a = (uint8_t __far *)MK_FP(VIDEO_MEMORY_BASE, GRAPHICS_BUFFER_GAMEPLAY_A + video_offset);
-            video_ptr_b = (uint8_t __far *)MK_FP(VIDEO_MEMORY_BASE, GRAPHICS_BUFFER_GAMEPLAY_B + video_offset);
-
-            for (col = 0; col < 2; col++) {
-                sprite_byte = plane_data[row * 2 + col];
-                mask_byte = mask_data[row * 2 + col];
-
-                current_a = video_ptr_a[col];
-                current_b = video_ptr_b[col];
-
-                video_ptr_a[col] = (current_a & mask_byte) | (sprite_byte & ~mask_byte);
-                video_ptr_b[col] = (current_b & mask_byte) | (sprite_byte & ~mask_byte);
-            }
-        }
-    }
+    submit_sprite_at(pixel_x, pixel_y, sprite_data, masked_sprite_kind, 8, offscreen_sprite_page());
 }
 
+
 /*
  * blit_wxh - Blit a variable-size graphic to video memory
  * 
@@ -1010,13 +1484,19 @@ void blit_wxh(uint16_t dest_offset, const uint8_t __far *graphic, uint16_t width
     uint8_t plane;
     uint8_t plane_mask;
     
+    /* Draw anything queued first so it stays underneath this graphic */
+    sprite_queue_flush();
+    
+    /* Large graphics (pause, game over) land in a single page */
+    dirty_rects_mark_offset(dest_offset, (uint8_t)width_bytes, (uint8_t)height);
+    
     /* Blit each plane */
     for (plane = 0; plane < 4; plane++) {
         plane_mask = 1 << plane;
         
         /* Select write plane */
-        outp(0x3C4, 0x02);  /* Map Mask register */
-        outp(0x3C5, plane_mask);
+        VRAM_OUTP(0x3C4, 0x02);  /* Map Mask register */
+        VRAM_OUTP(0x3C5, plane_mask);
         
         /* Point to this plane's data */
         plane_ptr = graphic + (plane * plane_size);
@@ -1025,7 +1505,7 @@ void blit_wxh(uint16_t dest_offset, const uint8_t __far *graphic, uint16_t width
         for (row = 0; row < height; row++) {
             dest_ptr = (uint8_t __far *)MK_FP(VIDEO_MEMORY_BASE, dest_offset + (row * 40));
             for (col = 0; col < width_bytes; col++) {
-                *dest_ptr++ = *plane_ptr++;
+                VRAM_WRITE(dest_ptr++, *plane_ptr++);
             }
         }
     }
@@ -1033,110 +1513,9 @@ void blit_wxh(uint16_t dest_offset, const uint8_t __far *graphic, uint16_t width
 
 
 /*
- * render_inventory_display - Render inventory items on the game UI
- *
- * Displays all inventory items that Comic has collected on the UI background.
- * Items are rendered at their fixed UI positions (from the original assembly).
- *
- * Inventory positions (pixel coordinates):
- *   Row 1 (Y=112):
- *     Blastola Cola: (232, 112) - shown if comic_firepower > 0
- *     Corkscrew:    (256, 112) - shown if comic_has_corkscrew = 1
- *     Door Key:     (280, 112) - shown if comic_has_door_key = 1
- *
- *   Row 2 (Y=136):
- *     Boots:        (232, 136) - shown if comic_jump_power > 4
- *     Lantern:      (256, 136) - shown if comic_has_lantern = 1
- *     Teleport Wand:(280, 136) - shown if comic_has_teleport_wand = 1
- *
- *   Row 3 (Y=160):
- *     Gems:         (232, 160) - shown if comic_num_treasures > 0
- *     Crown:        (256, 160) - shown if comic_num_treasures > 1
- *     Gold:         (280, 160) - shown if comic_num_treasures > 2
- *
- * All inventory items are 16x16 sprites with even/odd plane data.
- * Items are only rendered if Comic has collected them.
- */
-void render_inventory_display(void)
-{
-    /* Row 1 (Y=112) */
-    /* Always render Blastola Cola to keep both buffers in sync (prevents blinking) */
-    if (comic_firepower > 0) {
-        /* Render Blastola Cola at (232, 112) - sprite varies based on firepower level
-         * Use unmasked blit to completely overwrite old sprite (no transparency) */
-        const uint8_t *blastola_sprite = NULL;
-        switch (comic_firepower) {
-            case 1:
-                blastola_sprite = sprite_blastola_cola_inventory_1_even_16x16m;
-                break;
-            case 2:
-                blastola_sprite = sprite_blastola_cola_inventory_2_even_16x16m;
-                break;
-            case 3:
-                blastola_sprite = sprite_blastola_cola_inventory_3_even_16x16m;
-                break;
-            case 4:
-                blastola_sprite = sprite_blastola_cola_inventory_4_even_16x16m;
-                break;
-            case 5:
-                blastola_sprite = sprite_blastola_cola_inventory_5_even_16x16m;
-                break;
-            default:
-                blastola_sprite = sprite_blastola_cola_even_16x16m;
-                break;
-        }
-        blit_sprite_16x16_unmasked(232, 112, blastola_sprite);
-    }
-    
-    if (comic_has_corkscrew) {
-        /* Render Corkscrew at (256, 112) */
-        blit_sprite_16x16_masked(256, 112, sprite_corkscrew_even_16x16m);
-    }
-    
-    if (comic_has_door_key) {
-        /* Render Door Key at (280, 112) */
-        blit_sprite_16x16_masked(280, 112, sprite_door_key_even_16x16m);
-    }
-    
-    /* Row 2 (Y=136) */
-    if (comic_jump_power > 4) {
-        /* Render Boots at (232, 136) - shows when jump power exceeds default (Boots grant jump power 5) */
-        blit_sprite_16x16_masked(232, 136, sprite_boots_even_16x16m);
-    }
-    
-    if (comic_has_lantern) {
-        /* Render Lantern at (256, 136) - collected in Castle level */
-        blit_sprite_16x16_masked(256, 136, sprite_lantern_even_16x16m);
-    }
-    
-    if (comic_has_teleport_wand) {
-        /* Render Teleport Wand at (280, 136) */
-        blit_sprite_16x16_masked(280, 136, sprite_teleport_wand_even_16x16m);
-    }
-    
-    /* Row 3 (Y=160) - Treasures */
-    if (comic_has_gems) {
-        /* Render Gems at (232, 160) - first treasure */
-        blit_sprite_16x16_masked(232, 160, sprite_gems_even_16x16m);
-    }
-    
-    if (comic_has_crown) {
-        /* Render Crown at (256, 160) - second treasure */
-        blit_sprite_16x16_masked(256, 160, sprite_crown_even_16x16m);
-    }
-    
-    if (comic_has_gold) {
-        /* Render Gold at (280, 160) - third treasure */
-        blit_sprite_16x16_masked(280, 160, sprite_gold_even_16x16m);
-    }
-}
-
-
-/*
- * blit_8x16_sprite - Blit an 8x16 unmasked EGA sprite to both video buffers
+ * blit_8x16_sprite - Blit an 8x16 unmasked EGA sprite to the offscreen buffer
  *
  * Sprite format: EGA planar (4 planes, 16 bytes each = 64 bytes total)
- * Blits to both the onscreen and offscreen video buffers.
  *
  * Input:
  *   pixel_x, pixel_y = top-left corner in pixel coordinates
@@ -1144,116 +1523,6 @@ void render_inventory_display(void)
  */
 void blit_8x16_sprite(uint16_t pixel_x, uint16_t pixel_y, const uint8_t __far *sprite_data)
 {
-    uint16_t base_offset;
-    uint8_t plane;
-    uint8_t row;
-    uint8_t sprite_byte;
-    uint16_t video_offset;
-    uint8_t __far *video_ptr_a;
-    uint8_t __far *video_ptr_b;
-    const uint8_t *plane_data;
-    uint16_t plane_offset;
-    
-    /* Calculate video memory offset for top-left corner of sprite */
-    base_offset = (pixel_y * 320 + pixel_x) / 8;
-    
-    /* Blit each of the 4 color planes */
-    for (plane = 0; plane < 4; plane++) {
-        /* Enable writing to this plane */
-        enable_ega_plane_write(plane);
-        
-        /* Plane data: Blue=0, Green=16, Red=32, Intensity=48 bytes offset */
-        plane_offset = plane * 16;
-        plane_data = sprite_data + plane_offset;
-        
-        /* Copy this plane to both buffers, 1 byte per row (8 pixels wide) */
-        for (row = 0; row < 16; row++) {
-            /* Calculate video offset for this row */
-            video_offset = base_offset + (row * 40);
-            
-            /* Get pointers to both video buffers for this row */
-            video_ptr_a = (uint8_t __far *)MK_FP(VIDEO_MEMORY_BASE, GRAPHICS_BUFFER_GAMEPLAY_A + video_offset);
-            video_ptr_b = (uint8_t __far *)MK_FP(VIDEO_MEMORY_BASE, GRAPHICS_BUFFER_GAMEPLAY_B + video_offset);
-            
-            /* Copy 1 byte per row (8 pixels in EGA format = 1 byte) */
-            sprite_byte = plane_data[row];
-            
-            /* Write to both buffers */
-            *video_ptr_a = sprite_byte;
-            *video_ptr_b = sprite_byte;
-        }
-    }
-}
-
-
-/*
- * render_score_display - Render the 6-digit score on the game UI
- *
- * Displays the current score at the top of the screen.
- * Score is stored as 3 bytes in base-100 representation using the formula:
- *   score = score_bytes[0] + (score_bytes[1] * 100) + (score_bytes[2] * 10000)
- * 
- * Storage format (3 bytes, base-100):
- *   score_bytes[0] = rightmost digit pair (0-99, typically "00" since minimum award is 100 points)
- *   score_bytes[1] = middle digit pair (0-99, represents hundreds and thousands)
- *   score_bytes[2] = leftmost digit pair (0-99, represents ten-thousands and hundred-thousands)
- * 
- * Display format (6 decimal digits rendered at X=232-280):
- *   X=232-248: score_bytes[2] as 2 decimal digits (leftmost: ten-thousands place)
- *   X=248-264: score_bytes[1] as 2 decimal digits (middle: thousands place)
- *   X=264-280: score_bytes[0] as 2 decimal digits (rightmost: hundreds place, typically "00")
- * 
- * Each base-100 byte is converted to 2 decimal digits via division and modulo.
- * Example: score_bytes=[0, 20, 0] represents score of 0 + (20*100) + 0 = 2000 and displays as "002000"
- * Example: score_bytes=[0, 0, 5] represents score of 0 + 0 + (5*10000) = 50000 and displays as "050000"
- * Example: score_bytes=[5, 0, 0] represents score of 5 + 0 + 0 = 5 and displays as "000005"
- * 
- * Y coordinate is 24 (near top of screen).
- */
-void render_score_display(void)
-{
-    const uint8_t __far *digit_sprites[10] = {
-        sprite_score_digit_0_8x16,
-        sprite_score_digit_1_8x16,
-        sprite_score_digit_2_8x16,
-        sprite_score_digit_3_8x16,
-        sprite_score_digit_4_8x16,
-        sprite_score_digit_5_8x16,
-        sprite_score_digit_6_8x16,
-        sprite_score_digit_7_8x16,
-        sprite_score_digit_8_8x16,
-        sprite_score_digit_9_8x16
-    };
-    
-    uint8_t digit_idx;
-    uint8_t base100_value;
-    uint8_t high_decimal;
-    uint8_t low_decimal;
-    int16_t x_pos;
-    uint16_t pixel_y = 24;
-    
-    /* Render 3 base-100 bytes as 6 decimal digits */
-    /* Assembly starts at di=0x3e1 (X=264) for score[0] and moves left */
-    for (digit_idx = 0; digit_idx < 3; digit_idx++) {
-        base100_value = score_bytes[digit_idx];
-        
-        /* Convert base-100 byte to 2 decimal digits via division */
-        /* Assembly uses repeated subtraction: high = base100/10, low = base100%10 */
-        high_decimal = base100_value / 10;
-        low_decimal = base100_value % 10;
-        
-        /* Calculate X position: start at 264 and move left by 16 pixels each iteration */
-        x_pos = 264 - (digit_idx * 16);  /* 264, 248, 232 for indices 0, 1, 2 */
-        
-        /* Assembly's blit_score_digit does: inc di (move right 8), blit low, dec di, blit high */
-        /* So it blits LOW digit first at x+8, then HIGH digit at x */
-        if (low_decimal < 10) {
-            blit_8x16_sprite((uint16_t)(x_pos + 8), pixel_y, digit_sprites[low_decimal]);
-        }
-        
-        if (high_decimal < 10) {
-            blit_8x16_sprite((uint16_t)x_pos, pixel_y, digit_sprites[high_decimal]);
-        }
-    }
+    submit_sprite_at(pixel_x, pixel_y, sprite_data, SPRITE_KIND_UNMASKED_8, 16, offscreen_sprite_page());
 }
 
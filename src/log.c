@@ -0,0 +1,85 @@
+/*
+ * log.c - Buffered diagnostics log, flushed to DEBUG.LOG between ticks
+ * 
+ * See log.h. The ring lives in its own far segment so that it costs no
+ * DGROUP space; a record is 8 bytes, so the ring holds the last 256.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include "globals.h"
+#include "profile.h"
+#include "log.h"
+
+#define LOG_RING_RECORDS    256     /* Power of two: head and count wrap with a mask */
+
+typedef struct {
+    uint16_t time;          /* profile_irq0_count: 18.2 per second, wraps hourly */
+    uint8_t message;
+    uint8_t unused;
+    uint16_t args[3];
+} log_record_t;
+
+static const char *log_formats[LOG_NUM_MESSAGES] = {
+#define LOG_MESSAGE(id, format) format,
+#include "log_messages.h"
+#undef LOG_MESSAGE
+};
+
+static log_record_t __far ring[LOG_RING_RECORDS];
+static uint16_t ring_head = 0;      /* Where the next record goes */
+static uint16_t ring_count = 0;
+static uint16_t overwritten = 0;    /* Records lost since the last flush */
+
+void log_event(uint8_t message, uint16_t a, uint16_t b, uint16_t c)
+{
+    log_record_t __far *record = &ring[ring_head];
+
+    record->time = profile_irq0_count;
+    record->message = message;
+    record->args[0] = a;
+    record->args[1] = b;
+    record->args[2] = c;
+
+    ring_head = (ring_head + 1) & (LOG_RING_RECORDS - 1);
+    if (ring_count < LOG_RING_RECORDS) {
+        ring_count++;
+    } else if (overwritten != 0xffff) {
+        overwritten++;
+    }
+}
+
+void log_flush(void)
+{
+    log_record_t __far *record;
+    char text[128];
+    uint32_t ms;
+    uint16_t index;
+
+    if (ring_count == 0) {
+        return;
+    }
+
+    if (overwritten != 0) {
+        debug_log("(%u older log records overwritten)\n", overwritten);
+    }
+
+    index = (ring_head - ring_count) & (LOG_RING_RECORDS - 1);
+    while (ring_count > 0) {
+        record = &ring[index];
+        if (record->message < LOG_NUM_MESSAGES) {
+            snprintf(text, sizeof(text), log_formats[record->message],
+                     record->args[0], record->args[1], record->args[2]);
+        } else {
+            snprintf(text, sizeof(text), "Message %u: %u %u %u", record->message,
+                     record->args[0], record->args[1], record->args[2]);
+        }
+        /* One timer interrupt is 65536 / 1193182 s = 54.925 ms */
+        ms = (uint32_t)record->time * 54925UL / 1000UL;
+        debug_log("%5lu.%03lu %s\n", (unsigned long)(ms / 1000UL), (unsigned long)(ms % 1000UL), text);
+
+        index = (index + 1) & (LOG_RING_RECORDS - 1);
+        ring_count--;
+    }
+    overwritten = 0;
+}
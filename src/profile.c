@@ -0,0 +1,489 @@
+/*
+ * profile.c - Per-phase timing of game ticks
+ *
+ * See profile.h. Times are kept in PIT counts while a tick runs and turned
+ * into microseconds when the tick ends; the running sums are split into
+ * milliseconds and a microsecond remainder so that a session of any
+ * length fits in 32 bits.
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include <conio.h>
+#include <i86.h>
+#include "globals.h"
+#include "graphics.h"
+#include "vram.h"
+#include "profile.h"
+#include "log.h"
+
+#ifdef HOST_BUILD
+#include <time.h>
+#endif
+
+#define PIT_HZ                  1193182UL
+#define PIT_CHANNEL0_PORT       0x40
+#define PIT_COMMAND_PORT        0x43
+#define PIT_LATCH_CHANNEL0      0x00
+#define PIT_CHANNEL0_MODE2      0x34  /* Channel 0, lo/hi byte, rate generator */
+#define PIT_CHANNEL0_MODE3      0x36  /* Channel 0, lo/hi byte, square wave (BIOS default) */
+#define PIC_COMMAND_PORT        0x20
+#define PIC_READ_IRR            0x0a  /* OCW3: next read of port 0x20 returns the IRR */
+
+/* Samples above this (about 4 seconds) are clamped so the conversion to
+ * microseconds fits in 32 bits */
+#define MAX_SAMPLE_COUNTS       0x004c0000UL
+
+/* Overlay: rows 196-199 of the right-hand UI panel, x = 216-311 */
+#define BAR_X_BYTE              27
+#define BAR_WIDTH_BYTES         12
+#define BAR_Y                   196
+#define BAR_ROWS                4
+#define BAR_SHIFT               11    /* 2048 PIT counts (1.7 ms) per pixel */
+#define BAR_TICK_PIXELS         64    /* One game tick: two timer periods */
+#define BAR_TICK_COLOR          15
+
+#define BUSY_ROW                PROFILE_NUM_PHASES  /* Every phase but the wait */
+
+#define LAG_LEVELS              (LEVEL_NUMBER_COMP + 1)
+#define LAG_STAGES              3
+
+typedef struct {
+    uint32_t ticks;         /* Ticks that marked the phase */
+    uint32_t min_us;
+    uint32_t max_us;
+    uint32_t sum_ms;
+    uint16_t sum_us;        /* Remainder of the sum below 1 ms */
+} phase_stats_t;
+
+typedef struct {
+    uint32_t ticks;         /* Timer-paced ticks run in the stage */
+    uint32_t lag;           /* Lag frames after them */
+} stage_lag_t;
+
+/* Where a burst happened */
+typedef struct {
+    uint16_t count;
+    uint8_t level;
+    uint8_t stage;
+} lag_burst_t;
+
+static const char *level_names[LAG_LEVELS] = {
+    "LAKE", "FOREST", "SPACE", "BASE", "CAVE", "SHED", "CASTLE", "COMP"
+};
+
+static const char *phase_names[PROFILE_NUM_PHASES + 1] = {
+    "wait", "rewind", "input", "physics", "map", "comic", "enemies",
+    "fireballs", "items", "ui", "swap", "other", "busy"
+};
+
+/* EGA default palette colors; the wait is not drawn */
+static const uint8_t phase_colors[PROFILE_NUM_PHASES] = {
+    0, 8, 1, 2, 3, 4, 5, 6, 7, 9, 14, 12
+};
+
+uint8_t profile_enabled = 0;
+volatile uint16_t profile_irq0_count = 0;
+
+static uint8_t clock_running = 0;
+static uint8_t bars_enabled = 0;
+static uint8_t tick_started = 0;
+static uint32_t last_time = 0;
+static uint32_t tick_counts[PROFILE_NUM_PHASES];
+static uint16_t tick_marked = 0;    /* Bit per phase marked this tick */
+static phase_stats_t stats[PROFILE_NUM_PHASES + 1];
+
+volatile uint8_t profile_tick_active = 0;
+volatile uint8_t profile_lag_pending = 0;
+
+static uint8_t lag_tick_started = 0;
+static uint8_t lag_level = 0;       /* Where the running tick started */
+static uint8_t lag_stage = 0;
+static uint16_t lag_this_tick = 0;
+static uint16_t lag_run = 0;        /* Consecutive ticks with lag, so far */
+static uint32_t lag_ticks = 0;
+static uint32_t lag_total = 0;
+static uint32_t lag_by_phase[PROFILE_NUM_PHASES];
+static stage_lag_t lag_by_stage[LAG_LEVELS][LAG_STAGES];
+static lag_burst_t worst_tick;      /* Most lag frames after one tick */
+static lag_burst_t worst_run;       /* Longest run of ticks with lag */
+
+/*
+ * profile_read_timer_locked - Current time in PIT counts, interrupts off
+ *
+ * The caller disables interrupts, so that the latched count and
+ * profile_irq0_count belong together, and can do more in the same
+ * critical section (trace_event() claims its record slot).
+ *
+ * Returns:
+ *   Counts since profile_clock_start(), modulo 2^32 (about an hour)
+ */
+#ifdef HOST_BUILD
+uint32_t profile_read_timer_locked(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint32_t)((uint64_t)now.tv_sec * PIT_HZ +
+                      (uint64_t)now.tv_nsec * PIT_HZ / 1000000000UL);
+}
+#else
+uint32_t profile_read_timer_locked(void)
+{
+    uint16_t count;
+    uint16_t wraps;
+    uint8_t irr;
+
+    outp(PIT_COMMAND_PORT, PIT_LATCH_CHANNEL0);
+    count = (uint16_t)inp(PIT_CHANNEL0_PORT);
+    count |= (uint16_t)inp(PIT_CHANNEL0_PORT) << 8;
+    wraps = profile_irq0_count;
+    outp(PIC_COMMAND_PORT, PIC_READ_IRR);
+    irr = (uint8_t)inp(PIC_COMMAND_PORT);
+
+    /* The count has reloaded but int8_handler has not run yet */
+    if ((irr & 0x01) && count > 0x8000) {
+        wraps++;
+    }
+    return ((uint32_t)wraps << 16) | (uint16_t)(0 - count);
+}
+#endif
+
+/*
+ * profile_read_timer - Current time in PIT counts
+ *
+ * Leaves interrupts enabled. Inside int8_handler() that is harmless: until
+ * the BIOS handler sends the EOI the PIC holds back every lower-priority
+ * interrupt, which is all of them.
+ */
+uint32_t profile_read_timer(void)
+{
+    uint32_t now;
+
+    _disable();
+    now = profile_read_timer_locked();
+    _enable();
+    return now;
+}
+
+/*
+ * add_sample - Add one tick's time for a phase to its statistics
+ *
+ * Input:
+ *   s      = the phase's statistics
+ *   counts = the phase's time in the tick, in PIT counts
+ */
+static void add_sample(phase_stats_t *s, uint32_t counts)
+{
+    uint32_t us;
+
+    if (counts > MAX_SAMPLE_COUNTS) {
+        counts = MAX_SAMPLE_COUNTS;
+    }
+    us = (counts * 838UL + 500UL) / 1000UL;
+
+    if (s->ticks == 0 || us < s->min_us) {
+        s->min_us = us;
+    }
+    if (us > s->max_us) {
+        s->max_us = us;
+    }
+    s->sum_ms += us / 1000UL;
+    s->sum_us += (uint16_t)(us % 1000UL);
+    if (s->sum_us >= 1000) {
+        s->sum_ms++;
+        s->sum_us -= 1000;
+    }
+    s->ticks++;
+}
+
+/*
+ * set_bar_pixel - Set one pixel of the overlay's plane rows
+ */
+static void set_bar_pixel(uint8_t planes[4][BAR_WIDTH_BYTES], uint16_t x, uint8_t color)
+{
+    uint8_t plane;
+    uint8_t bit = (uint8_t)(0x80 >> (x & 7));
+
+    for (plane = 0; plane < 4; plane++) {
+        if (color & (1 << plane)) {
+            planes[plane][x >> 3] |= bit;
+        } else {
+            planes[plane][x >> 3] &= (uint8_t)~bit;
+        }
+    }
+}
+
+/*
+ * draw_bars - Draw the ended tick's phases as a stacked bar in both pages
+ *
+ * Each busy phase gets a run of pixels in its color, left to right in
+ * phase order; a white pixel marks the length of a game tick.
+ */
+static void draw_bars(void)
+{
+    uint8_t planes[4][BAR_WIDTH_BYTES];
+    uint8_t __far *row;
+    uint32_t width;
+    uint16_t x = 0;
+    uint16_t end;
+    uint16_t page;
+    uint8_t phase;
+    uint8_t plane;
+    uint8_t y;
+
+    memset(planes, 0, sizeof(planes));
+    for (phase = PROFILE_WAIT + 1; phase < PROFILE_NUM_PHASES; phase++) {
+        width = tick_counts[phase] >> BAR_SHIFT;
+        end = (uint16_t)(width < (uint32_t)(BAR_WIDTH_BYTES * 8 - x) ? x + width : BAR_WIDTH_BYTES * 8);
+        for (; x < end; x++) {
+            set_bar_pixel(planes, x, phase_colors[phase]);
+        }
+    }
+    if (x <= BAR_TICK_PIXELS) {
+        set_bar_pixel(planes, BAR_TICK_PIXELS, BAR_TICK_COLOR);
+    }
+
+    for (plane = 0; plane < 4; plane++) {
+        enable_ega_plane_write(plane);
+        for (page = GRAPHICS_BUFFER_GAMEPLAY_A; page <= GRAPHICS_BUFFER_GAMEPLAY_B;
+             page += GRAPHICS_BUFFER_GAMEPLAY_B - GRAPHICS_BUFFER_GAMEPLAY_A) {
+            for (y = 0; y < BAR_ROWS; y++) {
+                row = (uint8_t __far *)MK_FP(0xa000, page + (BAR_Y + y) * 40 + BAR_X_BYTE);
+                VRAM_COPY_TO(row, planes[plane], BAR_WIDTH_BYTES);
+            }
+        }
+    }
+    enable_ega_plane_write_all();
+}
+
+/*
+ * end_lag_tick - Add the tick that just ended to the lag frame totals
+ */
+static void end_lag_tick(void)
+{
+    stage_lag_t *stage;
+
+    profile_tick_active = 0;
+    if (!lag_tick_started) {
+        return;
+    }
+    lag_tick_started = 0;
+
+    /* Lag that came due after the last mark */
+    if (profile_lag_pending) {
+        profile_charge_lag(PROFILE_OTHER);
+    }
+
+    stage = &lag_by_stage[lag_level][lag_stage];
+    stage->ticks++;
+    stage->lag += lag_this_tick;
+    lag_ticks++;
+    lag_total += lag_this_tick;
+
+    if (lag_this_tick == 0) {
+        lag_run = 0;
+        return;
+    }
+    LOG_WARN(LAG_FRAMES, lag_this_tick, lag_level, lag_stage);
+    if (lag_this_tick > worst_tick.count) {
+        worst_tick.count = lag_this_tick;
+        worst_tick.level = lag_level;
+        worst_tick.stage = lag_stage;
+    }
+    if (++lag_run > worst_run.count) {
+        worst_run.count = lag_run;
+        worst_run.level = lag_level;
+        worst_run.stage = lag_stage;
+    }
+    lag_this_tick = 0;
+}
+
+void profile_clock_start(void)
+{
+    if (clock_running) {
+        return;
+    }
+#ifndef HOST_BUILD
+    /* Mode 2 with the same divisor (0 = 65536) keeps the 18.2 Hz interrupt */
+    outp(PIT_COMMAND_PORT, PIT_CHANNEL0_MODE2);
+    outp(PIT_CHANNEL0_PORT, 0);
+    outp(PIT_CHANNEL0_PORT, 0);
+#endif
+    clock_running = 1;
+}
+
+void profile_start(uint8_t bars)
+{
+    profile_clock_start();
+    memset(stats, 0, sizeof(stats));
+    profile_enabled = 1;
+    bars_enabled = bars;
+    profile_resync();
+}
+
+void profile_stop(void)
+{
+    profile_enabled = 0;
+    if (!clock_running) {
+        return;
+    }
+#ifndef HOST_BUILD
+    outp(PIT_COMMAND_PORT, PIT_CHANNEL0_MODE3);
+    outp(PIT_CHANNEL0_PORT, 0);
+    outp(PIT_CHANNEL0_PORT, 0);
+#endif
+    clock_running = 0;
+}
+
+void profile_mark(uint8_t phase)
+{
+    uint32_t now = profile_read_timer();
+
+    tick_counts[phase] += now - last_time;
+    tick_marked |= (uint16_t)(1 << phase);
+    last_time = now;
+}
+
+void profile_charge_lag(uint8_t phase)
+{
+    uint8_t lag;
+
+    _disable();
+    lag = profile_lag_pending;
+    profile_lag_pending = 0;
+    _enable();
+
+    lag_by_phase[phase] += lag;
+    lag_this_tick += lag;
+}
+
+void profile_tick_started(uint8_t level, uint8_t stage)
+{
+    if (level >= LAG_LEVELS || stage >= LAG_STAGES) {
+        return;
+    }
+    lag_level = level;
+    lag_stage = stage;
+    lag_tick_started = 1;
+    profile_tick_active = 1;
+}
+
+void profile_tick(void)
+{
+    uint32_t busy = 0;
+    uint8_t phase;
+
+    end_lag_tick();
+    TRACE_INSTANT(PHASE, PROFILE_OTHER);
+    TRACE_INSTANT(TICK, 0);
+    if (!profile_enabled) {
+        return;
+    }
+
+    profile_mark(PROFILE_OTHER);
+    if (tick_started) {
+        for (phase = 0; phase < PROFILE_NUM_PHASES; phase++) {
+            if (tick_marked & (1 << phase)) {
+                add_sample(&stats[phase], tick_counts[phase]);
+                if (phase != PROFILE_WAIT) {
+                    busy += tick_counts[phase];
+                }
+            }
+        }
+        add_sample(&stats[BUSY_ROW], busy);
+        if (bars_enabled) {
+            draw_bars();
+        }
+    }
+
+    memset(tick_counts, 0, sizeof(tick_counts));
+    tick_marked = 0;
+    tick_started = 1;
+
+    /* The overlay is charged to the new tick */
+    if (bars_enabled) {
+        profile_mark(PROFILE_OTHER);
+    }
+}
+
+void profile_resync(void)
+{
+    profile_tick_active = 0;
+    profile_lag_pending = 0;
+    lag_tick_started = 0;
+    lag_this_tick = 0;
+    lag_run = 0;
+    if (!profile_enabled) {
+        return;
+    }
+    last_time = profile_read_timer();
+    tick_started = 0;
+}
+
+void profile_report(void (*print)(const char *format, ...))
+{
+    phase_stats_t *s;
+    uint32_t avg_us;
+    uint8_t phase;
+
+    if (!profile_enabled) {
+        return;
+    }
+
+    print("Tick profile: %lu ticks, times in us\n", (unsigned long)stats[BUSY_ROW].ticks);
+    print("%-10s %8s %8s %8s %8s\n", "phase", "ticks", "min", "avg", "max");
+    for (phase = 0; phase <= BUSY_ROW; phase++) {
+        s = &stats[phase];
+        if (s->ticks == 0) {
+            continue;
+        }
+        /* (sum_ms * 1000 + sum_us) / ticks without overflowing 32 bits */
+        avg_us = s->sum_ms / s->ticks * 1000UL +
+                 ((s->sum_ms % s->ticks) * 1000UL + s->sum_us) / s->ticks;
+        print("%-10s %8lu %8lu %8lu %8lu\n", phase_names[phase], (unsigned long)s->ticks,
+              (unsigned long)s->min_us, (unsigned long)avg_us, (unsigned long)s->max_us);
+    }
+}
+
+void profile_lag_report(void (*print)(const char *format, ...))
+{
+    stage_lag_t *stage;
+    uint8_t level;
+    uint8_t stage_number;
+    uint8_t phase;
+
+    if (lag_ticks == 0) {
+        return;
+    }
+
+    print("Lag frames: %lu after %lu timer-paced ticks\n",
+          (unsigned long)lag_total, (unsigned long)lag_ticks);
+    if (lag_total == 0) {
+        return;
+    }
+
+    print("%-10s %5s %8s %8s\n", "level", "stage", "ticks", "lag");
+    for (level = 0; level < LAG_LEVELS; level++) {
+        for (stage_number = 0; stage_number < LAG_STAGES; stage_number++) {
+            stage = &lag_by_stage[level][stage_number];
+            if (stage->ticks == 0) {
+                continue;
+            }
+            print("%-10s %5u %8lu %8lu\n", level_names[level], stage_number,
+                  (unsigned long)stage->ticks, (unsigned long)stage->lag);
+        }
+    }
+
+    print("%-10s %8s\n", "phase", "lag");
+    for (phase = 0; phase < PROFILE_NUM_PHASES; phase++) {
+        if (lag_by_phase[phase] != 0) {
+            print("%-10s %8lu\n", phase_names[phase], (unsigned long)lag_by_phase[phase]);
+        }
+    }
+
+    print("Worst tick: %u lag frames (%s stage %u)\n", worst_tick.count,
+          level_names[worst_tick.level], worst_tick.stage);
+    print("Longest run: %u ticks with lag (%s stage %u)\n", worst_run.count,
+          level_names[worst_run.level], worst_run.stage);
+}
@@ -0,0 +1,245 @@
+/*
+ * replay.c - Input recording and replay (.RPL files)
+ *
+ * See replay.h for the file layout. Both directions go through a small
+ * buffer so that a tick costs a few bytes of memory traffic, not a DOS call;
+ * the buffer is written or refilled only when it runs out. Runs of ticks
+ * without input, which make up most of a session, are stored as a single
+ * byte per 128 ticks.
+ *
+ * The file and its buffer belong to the running game (GAME->replay, see
+ * game_state.h).
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <io.h>
+#include <sys/stat.h>
+#include "game_state.h"
+#include "replay.h"
+
+#define REPLAY_HEADER_SIZE      15
+
+#define REPLAY_END              0x00
+#define REPLAY_IDLE_BASE        0x7f  /* Idle run byte = REPLAY_IDLE_BASE + ticks */
+#define REPLAY_MAX_IDLE_RUN     128
+
+static const char replay_magic[4] = { 'C', 'R', 'P', 'L' };
+
+/*
+ * flush_buffer - Write the buffered bytes of a recording
+ *
+ * A failed write stops the recording; the game carries on unaffected.
+ */
+static void flush_buffer(void)
+{
+    if (GAME->replay.buffer_pos == 0) {
+        return;
+    }
+    if (_write(GAME->replay.handle, GAME->replay.buffer, GAME->replay.buffer_pos) != (int)GAME->replay.buffer_pos) {
+        fprintf(stderr, "ERROR: Replay write failed, recording stopped\n");
+        _close(GAME->replay.handle);
+        GAME->replay.handle = -1;
+        GAME->replay.mode = REPLAY_OFF;
+    }
+    GAME->replay.buffer_pos = 0;
+}
+
+static void put_byte(uint8_t value)
+{
+    if (GAME->replay.buffer_pos == REPLAY_BUFFER_SIZE) {
+        flush_buffer();
+        if (GAME->replay.mode != REPLAY_RECORD) {
+            return;
+        }
+    }
+    GAME->replay.buffer[GAME->replay.buffer_pos++] = value;
+}
+
+/*
+ * flush_idle_run - Write the pending run of ticks without input
+ */
+static void flush_idle_run(void)
+{
+    if (GAME->replay.idle_run > 0) {
+        put_byte((uint8_t)(REPLAY_IDLE_BASE + GAME->replay.idle_run));
+        GAME->replay.idle_run = 0;
+    }
+}
+
+/*
+ * get_byte - Next byte of a recording being played back
+ *
+ * Returns:
+ *   The byte, or -1 at end of file
+ */
+static int16_t get_byte(void)
+{
+    int bytes_read;
+
+    if (GAME->replay.buffer_pos == GAME->replay.buffer_len) {
+        bytes_read = _read(GAME->replay.handle, GAME->replay.buffer, REPLAY_BUFFER_SIZE);
+        if (bytes_read <= 0) {
+            return -1;
+        }
+        GAME->replay.buffer_len = (uint16_t)bytes_read;
+        GAME->replay.buffer_pos = 0;
+    }
+    return GAME->replay.buffer[GAME->replay.buffer_pos++];
+}
+
+int replay_open_record(const char *filename)
+{
+    replay_close();
+
+    GAME->replay.handle = _open(filename, O_WRONLY | O_CREAT | O_TRUNC | O_BINARY, S_IREAD | S_IWRITE);
+    if (GAME->replay.handle == -1) {
+        fprintf(stderr, "ERROR: Cannot create replay file '%s'\n", filename);
+        return -1;
+    }
+
+    GAME->replay.mode = REPLAY_RECORD;
+    GAME->replay.ticks = 0;
+    GAME->replay.buffer_pos = 0;
+    GAME->replay.idle_run = 0;
+    return 0;
+}
+
+int replay_write_start(const replay_start_t *start)
+{
+    uint8_t i;
+
+    if (GAME->replay.mode != REPLAY_RECORD) {
+        return -1;
+    }
+
+    for (i = 0; i < sizeof(replay_magic); i++) {
+        put_byte((uint8_t)replay_magic[i]);
+    }
+    put_byte(REPLAY_VERSION);
+    put_byte(start->level_number);
+    put_byte(start->stage_number);
+    put_byte(start->enemy_respawn_counter_cycle);
+    put_byte(start->item_animation_counter);
+    for (i = 0; i < sizeof(start->keymap); i++) {
+        put_byte(start->keymap[i]);
+    }
+    return 0;
+}
+
+void replay_record_tick(const uint8_t *scancodes, uint8_t count)
+{
+    uint8_t i;
+
+    if (GAME->replay.mode != REPLAY_RECORD) {
+        return;
+    }
+    GAME->replay.ticks++;
+
+    if (count == 0) {
+        if (++GAME->replay.idle_run == REPLAY_MAX_IDLE_RUN) {
+            flush_idle_run();
+        }
+        return;
+    }
+
+    flush_idle_run();
+    if (count > REPLAY_MAX_TICK_SCANCODES) {
+        count = REPLAY_MAX_TICK_SCANCODES;
+    }
+    put_byte(count);
+    for (i = 0; i < count; i++) {
+        put_byte(scancodes[i]);
+    }
+}
+
+int replay_open_playback(const char *filename)
+{
+    uint8_t header[REPLAY_HEADER_SIZE];
+
+    replay_close();
+
+    GAME->replay.handle = _open(filename, O_RDONLY | O_BINARY);
+    if (GAME->replay.handle == -1) {
+        fprintf(stderr, "ERROR: Cannot open replay file '%s'\n", filename);
+        return -1;
+    }
+
+    if (_read(GAME->replay.handle, header, REPLAY_HEADER_SIZE) != REPLAY_HEADER_SIZE ||
+        memcmp(header, replay_magic, sizeof(replay_magic)) != 0 ||
+        header[4] != REPLAY_VERSION) {
+        fprintf(stderr, "ERROR: '%s' is not a replay file\n", filename);
+        _close(GAME->replay.handle);
+        GAME->replay.handle = -1;
+        return -1;
+    }
+
+    GAME->replay.start.level_number = header[5];
+    GAME->replay.start.stage_number = header[6];
+    GAME->replay.start.enemy_respawn_counter_cycle = header[7];
+    GAME->replay.start.item_animation_counter = header[8];
+    memcpy(GAME->replay.start.keymap, &header[9], sizeof(GAME->replay.start.keymap));
+
+    GAME->replay.mode = REPLAY_PLAYBACK;
+    GAME->replay.ticks = 0;
+    GAME->replay.buffer_pos = 0;
+    GAME->replay.buffer_len = 0;
+    GAME->replay.idle_run = 0;
+    return 0;
+}
+
+int8_t replay_next_tick(uint8_t *scancodes)
+{
+    int16_t value;
+    uint8_t count;
+    uint8_t i;
+
+    if (GAME->replay.mode != REPLAY_PLAYBACK) {
+        return -1;
+    }
+
+    if (GAME->replay.idle_run > 0) {
+        GAME->replay.idle_run--;
+        GAME->replay.ticks++;
+        return 0;
+    }
+
+    value = get_byte();
+    if (value > REPLAY_IDLE_BASE) {
+        GAME->replay.idle_run = (uint8_t)(value - REPLAY_IDLE_BASE - 1);
+        GAME->replay.ticks++;
+        return 0;
+    }
+    if (value <= REPLAY_END || value > REPLAY_MAX_TICK_SCANCODES) {
+        return -1;  /* End marker, end of file or a corrupt stream */
+    }
+
+    count = (uint8_t)value;
+    for (i = 0; i < count; i++) {
+        value = get_byte();
+        if (value < 0) {
+            return -1;
+        }
+        scancodes[i] = (uint8_t)value;
+    }
+    GAME->replay.ticks++;
+    return (int8_t)count;
+}
+
+void replay_close(void)
+{
+    if (GAME->replay.handle != -1) {
+        if (GAME->replay.mode == REPLAY_RECORD) {
+            flush_idle_run();
+            put_byte(REPLAY_END);
+            flush_buffer();
+        }
+        if (GAME->replay.handle != -1) {
+            _close(GAME->replay.handle);
+            GAME->replay.handle = -1;
+        }
+    }
+    GAME->replay.mode = REPLAY_OFF;
+}
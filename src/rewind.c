@@ -0,0 +1,269 @@
+/*
+ * rewind.c - Step back through the last few hundred game ticks
+ *
+ * See rewind.h for the record layout. The history belongs to the running
+ * game (GAME->rewind, see game_state.h). Records are stored back to back
+ * in a byte ring allocated on first use; records[] locates each one,
+ * oldest first. newest_state, allocated after the ring, always holds the
+ * decoded state of the newest record, so recording a tick is a single
+ * XOR-and-encode pass against it, and stepping back over a delta is a
+ * single XOR pass.
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "game_state.h"
+#include "snapshot.h"
+#include "rewind.h"
+
+#define RECORD_MAX_COUNT    255
+#define RECORD_NIBBLE_MAX   15    /* Nibble value meaning "full byte follows" */
+#define RECORD_MIN_SKIP     2     /* Shorter runs of unchanged bytes stay in a literal */
+
+/* Scratch for one call; the history itself is in GAME->rewind */
+static uint8_t tick_state[SNAPSHOT_SIZE];
+/* A run costs at most one header byte more than the bytes it covers, and
+ * runs cover at least RECORD_MIN_SKIP + 1 bytes, so this is never reached */
+static uint8_t encoded[2 * SNAPSHOT_SIZE];
+
+/*
+ * ring_ready - Allocate the ring buffer and newest_state on first use
+ *
+ * Returns:
+ *   1 if the ring buffer is available, 0 if it could not be allocated
+ */
+static uint8_t ring_ready(void)
+{
+    if (GAME->rewind.ring == NULL && !GAME->rewind.ring_failed) {
+        GAME->rewind.ring = (uint8_t __far *)malloc(REWIND_BUFFER_SIZE + SNAPSHOT_SIZE);
+        if (GAME->rewind.ring == NULL) {
+            GAME->rewind.ring_failed = 1;
+        } else {
+            GAME->rewind.newest_state = (uint8_t *)(GAME->rewind.ring + REWIND_BUFFER_SIZE);
+        }
+    }
+    return (uint8_t)(GAME->rewind.ring != NULL);
+}
+
+/*
+ * encode_record - Run-length encode a tick's state into encoded[]
+ *
+ * Input:
+ *   state = the tick's snapshot
+ *   base  = the previous tick's snapshot for a delta, NULL for a keyframe
+ *
+ * Returns:
+ *   Bytes written to encoded[]
+ */
+static uint16_t encode_record(const uint8_t *state, const uint8_t *base)
+{
+    uint16_t length = 0;
+    uint16_t i = 0;
+    uint16_t run;
+    uint16_t count;
+    uint8_t skip;
+
+    while (i < SNAPSHOT_SIZE) {
+        skip = 0;
+        while (i < SNAPSHOT_SIZE && skip < RECORD_MAX_COUNT &&
+               state[i] == (base != NULL ? base[i] : 0)) {
+            skip++;
+            i++;
+        }
+
+        count = 0;
+        while (i + count < SNAPSHOT_SIZE && count < RECORD_MAX_COUNT) {
+            /* End the literal at a run of unchanged bytes worth skipping */
+            run = 0;
+            while (i + count + run < SNAPSHOT_SIZE && run < RECORD_MIN_SKIP &&
+                   state[i + count + run] == (base != NULL ? base[i + count + run] : 0)) {
+                run++;
+            }
+            if (run == RECORD_MIN_SKIP || i + count + run == SNAPSHOT_SIZE) {
+                break;
+            }
+            count += run + 1;
+            if (count > RECORD_MAX_COUNT) {
+                count = RECORD_MAX_COUNT;
+            }
+        }
+
+        encoded[length++] = (uint8_t)(((skip < RECORD_NIBBLE_MAX ? skip : RECORD_NIBBLE_MAX) << 4) |
+                                      (count < RECORD_NIBBLE_MAX ? count : RECORD_NIBBLE_MAX));
+        if (skip >= RECORD_NIBBLE_MAX) {
+            encoded[length++] = skip;
+        }
+        if (count >= RECORD_NIBBLE_MAX) {
+            encoded[length++] = (uint8_t)count;
+        }
+        while (count > 0) {
+            encoded[length++] = (uint8_t)(state[i] ^ (base != NULL ? base[i] : 0));
+            i++;
+            count--;
+        }
+    }
+    return length;
+}
+
+/*
+ * ring_byte - Read the byte at pos in the ring and advance pos
+ */
+static uint8_t ring_byte(uint16_t *pos)
+{
+    uint8_t value = GAME->rewind.ring[*pos];
+
+    *pos = (uint16_t)((*pos + 1) % REWIND_BUFFER_SIZE);
+    return value;
+}
+
+/*
+ * apply_record - XOR a record's literals into a state
+ *
+ * Applied to zeros, a keyframe gives its tick's state. A delta turns the
+ * previous tick's state into its own and, since XOR undoes itself, its own
+ * back into the previous tick's.
+ *
+ * Input:
+ *   state = state to change in place
+ *   slot  = index into records[]
+ */
+static void apply_record(uint8_t *state, uint16_t slot)
+{
+    uint16_t pos = GAME->rewind.records[slot].start;
+    uint16_t i = 0;
+    uint8_t header;
+    uint8_t skip;
+    uint8_t count;
+
+    while (i < SNAPSHOT_SIZE) {
+        header = ring_byte(&pos);
+        skip = (uint8_t)(header >> 4);
+        count = (uint8_t)(header & 0x0f);
+        if (skip == RECORD_NIBBLE_MAX) {
+            skip = ring_byte(&pos);
+        }
+        if (count == RECORD_NIBBLE_MAX) {
+            count = ring_byte(&pos);
+        }
+
+        i += skip;
+        while (count > 0) {
+            state[i++] ^= ring_byte(&pos);
+            count--;
+        }
+    }
+}
+
+/*
+ * drop_oldest_group - Drop the oldest keyframe and the deltas that follow it
+ */
+static void drop_oldest_group(void)
+{
+    do {
+        GAME->rewind.ring_used -= GAME->rewind.records[GAME->rewind.first_record].length;
+        GAME->rewind.first_record = (uint16_t)((GAME->rewind.first_record + 1) % REWIND_MAX_TICKS);
+        GAME->rewind.num_records--;
+    } while (GAME->rewind.num_records > 0 && !GAME->rewind.records[GAME->rewind.first_record].keyframe);
+}
+
+/*
+ * decode_newest_state - Rebuild newest_state from the newest keyframe on
+ */
+static void decode_newest_state(void)
+{
+    uint16_t index = GAME->rewind.num_records - 1;
+
+    while (!GAME->rewind.records[(GAME->rewind.first_record + index) % REWIND_MAX_TICKS].keyframe) {
+        index--;
+    }
+    GAME->rewind.deltas_since_keyframe = (uint8_t)(GAME->rewind.num_records - 1 - index);
+
+    memset(GAME->rewind.newest_state, 0, SNAPSHOT_SIZE);
+    for (; index < GAME->rewind.num_records; index++) {
+        apply_record(GAME->rewind.newest_state, (uint16_t)((GAME->rewind.first_record + index) % REWIND_MAX_TICKS));
+    }
+}
+
+void rewind_record_tick(void)
+{
+    uint8_t keyframe;
+    uint16_t length;
+    uint16_t slot;
+    uint16_t i;
+
+    if (!ring_ready()) {
+        return;
+    }
+
+    snapshot_save(tick_state);
+    keyframe = (uint8_t)(GAME->rewind.num_records == 0 || GAME->rewind.deltas_since_keyframe + 1 >= REWIND_KEYFRAME_INTERVAL);
+    length = encode_record(tick_state, keyframe ? NULL : GAME->rewind.newest_state);
+
+    while (GAME->rewind.num_records == REWIND_MAX_TICKS || REWIND_BUFFER_SIZE - GAME->rewind.ring_used < length) {
+        drop_oldest_group();
+    }
+    if (GAME->rewind.num_records == 0 && !keyframe) {
+        /* The delta's own group was dropped to make room */
+        keyframe = 1;
+        length = encode_record(tick_state, NULL);
+    }
+
+    slot = (uint16_t)((GAME->rewind.first_record + GAME->rewind.num_records) % REWIND_MAX_TICKS);
+    GAME->rewind.records[slot].start = GAME->rewind.ring_head;
+    GAME->rewind.records[slot].length = length;
+    GAME->rewind.records[slot].keyframe = keyframe;
+    for (i = 0; i < length; i++) {
+        GAME->rewind.ring[GAME->rewind.ring_head] = encoded[i];
+        GAME->rewind.ring_head = (uint16_t)((GAME->rewind.ring_head + 1) % REWIND_BUFFER_SIZE);
+    }
+    GAME->rewind.ring_used += length;
+    GAME->rewind.num_records++;
+
+    GAME->rewind.deltas_since_keyframe = (uint8_t)(keyframe ? 0 : GAME->rewind.deltas_since_keyframe + 1);
+    memcpy(GAME->rewind.newest_state, tick_state, SNAPSHOT_SIZE);
+}
+
+int rewind_step_back(void)
+{
+    uint16_t slot;
+
+    if (GAME->rewind.num_records == 0) {
+        return -1;
+    }
+
+    memcpy(tick_state, GAME->rewind.newest_state, SNAPSHOT_SIZE);
+
+    slot = (uint16_t)((GAME->rewind.first_record + GAME->rewind.num_records - 1) % REWIND_MAX_TICKS);
+    GAME->rewind.ring_head = GAME->rewind.records[slot].start;
+    GAME->rewind.ring_used -= GAME->rewind.records[slot].length;
+    GAME->rewind.num_records--;
+
+    if (!GAME->rewind.records[slot].keyframe) {
+        apply_record(GAME->rewind.newest_state, slot);
+        GAME->rewind.deltas_since_keyframe--;
+    } else if (GAME->rewind.num_records > 0) {
+        decode_newest_state();
+    }
+
+    return snapshot_restore(tick_state);
+}
+
+void rewind_reset(void)
+{
+    GAME->rewind.ring_head = 0;
+    GAME->rewind.ring_used = 0;
+    GAME->rewind.first_record = 0;
+    GAME->rewind.num_records = 0;
+    GAME->rewind.deltas_since_keyframe = 0;
+}
+
+uint16_t rewind_ticks_held(void)
+{
+    return GAME->rewind.num_records;
+}
+
+uint16_t rewind_bytes_used(void)
+{
+    return GAME->rewind.ring_used;
+}
@@ -0,0 +1,32 @@
+/*
+ * snapshot.c - In-memory save states
+ *
+ * See snapshot.h. The screen side of a restore (level reload, map render,
+ * UI redraw) is done by restore_stage_view() in game_main.c.
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include "game_state.h"
+#include "snapshot.h"
+
+/* From game_main.c */
+int restore_stage_view(uint8_t level_changed, uint8_t stage_changed, uint8_t lives_shown);
+
+void snapshot_save(uint8_t *buffer)
+{
+    memcpy(buffer, (const uint8_t *)GAME + SNAPSHOT_FIRST_OFFSET, SNAPSHOT_SIZE);
+}
+
+int snapshot_restore(const uint8_t *buffer)
+{
+    uint8_t old_level = GAME->current_level_number;
+    uint8_t old_stage = GAME->current_stage_number;
+    uint8_t old_lives = GAME->comic_num_lives;
+
+    memcpy((uint8_t *)GAME + SNAPSHOT_FIRST_OFFSET, buffer, SNAPSHOT_SIZE);
+
+    return restore_stage_view((uint8_t)(GAME->current_level_number != old_level),
+                              (uint8_t)(GAME->current_stage_number != old_stage),
+                              old_lives);
+}
@@ -13,6 +13,7 @@
 #include <dos.h>
 #include <conio.h>
 #include "sound.h"
+#include "trace.h"
 
 /**
  * Sound playback state
@@ -194,6 +195,7 @@ void sound_advance_tick(void)
 		sound_state.is_playing = 0;
 		sound_state.priority = 0;
 		speaker_disable();
+		TRACE_INSTANT(SOUND_NOTE, 0);
 		return;
 	}
 	
@@ -207,6 +209,7 @@ void sound_advance_tick(void)
 	
 	/* Program PIT with new frequency */
 	pit_set_frequency(frequency);
+	TRACE_INSTANT(SOUND_NOTE, frequency);
 	
 	/* Enable speaker output if sound is unmuted */
 	if (sound_state.is_enabled) {
@@ -0,0 +1,35 @@
+/*
+ * tile_query.c - Tile and solidity probes on the current stage's map
+ *
+ * See tile_query.h; the probes themselves are macros there. This file
+ * builds the solidity bitmap they read.
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include "globals.h"
+#include "game_state.h"
+#include "tile_query.h"
+
+void tile_query_build(void)
+{
+    const uint8_t *tiles = GAME->current_tiles_ptr;
+    uint8_t last_passable = GAME->tileset_last_passable;
+    uint8_t tile_x;
+    uint8_t tile_y;
+
+    memset(GAME->solid_rows, 0, sizeof(GAME->solid_rows));
+    memset(GAME->solid_columns, 0, sizeof(GAME->solid_columns));
+    if (tiles == NULL) {
+        return;
+    }
+
+    for (tile_y = 0; tile_y < MAP_HEIGHT_TILES; tile_y++) {
+        for (tile_x = 0; tile_x < MAP_WIDTH_TILES; tile_x++) {
+            if (*tiles++ > last_passable) {
+                GAME->solid_rows[tile_y][tile_x >> 3] |= (uint8_t)(1 << (tile_x & 7));
+                GAME->solid_columns[tile_x] |= (uint16_t)(1 << tile_y);
+            }
+        }
+    }
+}
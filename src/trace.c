@@ -0,0 +1,157 @@
+/*
+ * trace.c - Binary event trace of game ticks, dumped to TRACE.BIN
+ *
+ * See trace.h for the file layout. Records are written as they sit in
+ * memory, which is the file's little-endian layout on the PC and on the
+ * hosts the simulation runs on.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <fcntl.h>
+#include <io.h>
+#include <i86.h>
+#include <sys/stat.h>
+#include "profile.h"
+#include "trace.h"
+
+#define TRACE_FILENAME      "TRACE.BIN"
+#define TRACE_CLOCK_HZ      1193182UL
+
+typedef struct {
+    uint32_t time;          /* PIT counts (profile_read_timer()) */
+    uint8_t type;           /* TRACE_TYPE_* */
+    uint8_t event;          /* TRACE_EVENT_* */
+    uint16_t arg;
+} trace_record_t;
+
+uint8_t trace_enabled = 0;
+
+static trace_record_t __far *records = NULL;
+static uint16_t record_head = 0;    /* Where the next record goes */
+static uint16_t record_count = 0;
+static uint32_t overwritten = 0;
+
+/*
+ * put_u16, put_u32 - Store a little-endian value into a header buffer
+ */
+static void put_u16(uint8_t *dst, uint16_t value)
+{
+    dst[0] = (uint8_t)value;
+    dst[1] = (uint8_t)(value >> 8);
+}
+
+static void put_u32(uint8_t *dst, uint32_t value)
+{
+    put_u16(dst, (uint16_t)value);
+    put_u16(dst + 2, (uint16_t)(value >> 16));
+}
+
+/*
+ * write_records - Write count records from index first of the ring
+ *
+ * Returns:
+ *   0 on success, -1 on a short write
+ */
+static int write_records(int handle, uint16_t first, uint16_t count)
+{
+    unsigned bytes = (unsigned)count * TRACE_RECORD_SIZE;
+
+    if (count == 0) {
+        return 0;
+    }
+    return _write(handle, &records[first], bytes) == (int)bytes ? 0 : -1;
+}
+
+int trace_start(void)
+{
+    if (records == NULL) {
+        records = (trace_record_t __far *)malloc((size_t)TRACE_MAX_RECORDS * TRACE_RECORD_SIZE);
+        if (records == NULL) {
+            fprintf(stderr, "ERROR: Not enough memory for the trace buffer\n");
+            return -1;
+        }
+    }
+    profile_clock_start();
+    record_head = 0;
+    record_count = 0;
+    overwritten = 0;
+    trace_enabled = 1;
+    return 0;
+}
+
+void trace_event(uint8_t type, uint8_t event, uint16_t arg)
+{
+    trace_record_t __far *record;
+
+    /* int8_handler() records sound notes, so claim the slot and read the
+     * clock atomically: records are then in time order */
+    _disable();
+    record = &records[record_head];
+    if (++record_head == TRACE_MAX_RECORDS) {
+        record_head = 0;
+    }
+    if (record_count < TRACE_MAX_RECORDS) {
+        record_count++;
+    } else {
+        overwritten++;
+    }
+    record->time = profile_read_timer_locked();
+    record->type = type;
+    record->event = event;
+    record->arg = arg;
+    _enable();
+}
+
+int trace_dump(void)
+{
+    uint8_t header[TRACE_HEADER_SIZE];
+    uint16_t oldest;
+    uint16_t count;
+    int handle;
+    int result;
+
+    if (!trace_enabled) {
+        return 0;
+    }
+
+    /* Events during the write would be half in, half out */
+    trace_enabled = 0;
+    count = record_count;
+    oldest = (uint16_t)(record_head >= count ? record_head - count : record_head + TRACE_MAX_RECORDS - count);
+
+    header[0] = TRACE_FILE_MAGIC[0];
+    header[1] = TRACE_FILE_MAGIC[1];
+    header[2] = TRACE_FILE_MAGIC[2];
+    header[3] = TRACE_FILE_MAGIC[3];
+    put_u16(header + 4, TRACE_FILE_VERSION);
+    put_u16(header + 6, TRACE_RECORD_SIZE);
+    put_u32(header + 8, TRACE_CLOCK_HZ);
+    put_u32(header + 12, count);
+    put_u32(header + 16, overwritten);
+
+    handle = _open(TRACE_FILENAME, O_WRONLY | O_CREAT | O_TRUNC | O_BINARY, S_IREAD | S_IWRITE);
+    if (handle == -1) {
+        fprintf(stderr, "ERROR: Cannot create trace file '%s'\n", TRACE_FILENAME);
+        return -1;
+    }
+
+    result = 0;
+    if (_write(handle, header, sizeof(header)) != (int)sizeof(header)) {
+        result = -1;
+    } else if (oldest + count <= TRACE_MAX_RECORDS) {
+        result = write_records(handle, oldest, count);
+    } else {
+        result = write_records(handle, oldest, TRACE_MAX_RECORDS - oldest);
+        if (result == 0) {
+            result = write_records(handle, 0, (uint16_t)(oldest + count - TRACE_MAX_RECORDS));
+        }
+    }
+    _close(handle);
+
+    if (result != 0) {
+        fprintf(stderr, "ERROR: Failed to write trace file '%s'\n", TRACE_FILENAME);
+    }
+    return result;
+}
@@ -0,0 +1,247 @@
+/*
+ * ui.c - Change-tracked status panel: score, inventory and meters
+ *
+ * See ui.h. Everything is drawn with the offscreen-page blitters, so it
+ * goes through the per-tick sprite batch like the playfield sprites.
+ */
+
+#include <stdint.h>
+#include "globals.h"
+#include "graphics.h"
+#include "sprite_data.h"
+#include "game_state.h"
+#include "ui.h"
+
+extern uint16_t offscreen_video_buffer_ptr;  /* Current offscreen buffer offset */
+
+#define UI_UNKNOWN          0xff    /* Cached value: redraw whatever the state is */
+
+#define SCORE_X             264     /* score_bytes[0]; each more significant pair is 16 px left */
+#define SCORE_Y             24
+#define FIREBALL_METER_X    248     /* Cell i at FIREBALL_METER_X + 8 * i */
+#define FIREBALL_METER_Y    54
+#define HP_METER_X          240     /* Cell i (1..MAX_HP) at HP_METER_X + 8 * i */
+#define HP_METER_Y          82
+
+/* Meter cell fills, as drawn */
+#define CELL_EMPTY          0
+#define CELL_HALF           1
+#define CELL_FULL           2
+
+/* Inventory slots after the Blastola Cola, one bit each */
+#define NUM_ITEM_SLOTS      8
+
+typedef struct {
+    uint16_t x;
+    uint16_t y;
+    const uint8_t __far *sprite;
+} item_slot_t;
+
+typedef struct {
+    uint8_t score_bytes[3];
+    uint8_t firepower;              /* Blastola Cola drawn for this firepower, 0 = none */
+    uint8_t items;                  /* Bit per item_slots[] entry drawn */
+    uint8_t fireball_meter;
+    uint8_t hp;
+} page_state_t;
+
+/* Row 1 (Y=112) after the Blastola Cola, row 2 (Y=136), row 3 (Y=160) */
+static const item_slot_t item_slots[NUM_ITEM_SLOTS] = {
+    { 256, 112, sprite_corkscrew_even_16x16m },
+    { 280, 112, sprite_door_key_even_16x16m },
+    { 232, 136, sprite_boots_even_16x16m },
+    { 256, 136, sprite_lantern_even_16x16m },
+    { 280, 136, sprite_teleport_wand_even_16x16m },
+    { 232, 160, sprite_gems_even_16x16m },
+    { 256, 160, sprite_crown_even_16x16m },
+    { 280, 160, sprite_gold_even_16x16m }
+};
+
+static const uint8_t __far *const digit_sprites[10] = {
+    sprite_score_digit_0_8x16,
+    sprite_score_digit_1_8x16,
+    sprite_score_digit_2_8x16,
+    sprite_score_digit_3_8x16,
+    sprite_score_digit_4_8x16,
+    sprite_score_digit_5_8x16,
+    sprite_score_digit_6_8x16,
+    sprite_score_digit_7_8x16,
+    sprite_score_digit_8_8x16,
+    sprite_score_digit_9_8x16
+};
+
+static const uint8_t __far *const cell_sprites[3] = {
+    sprite_meter_empty_8x16,
+    sprite_meter_half_8x16,
+    sprite_meter_full_8x16
+};
+
+/* Indexed 0 for page A, 1 for page B */
+static page_state_t pages[2];
+
+/*
+ * items_held - Inventory items Comic has, as item_slots[] bits
+ */
+static uint8_t items_held(void)
+{
+    uint8_t held = 0;
+
+    if (GAME->comic_has_corkscrew)      held |= 0x01;
+    if (GAME->comic_has_door_key)       held |= 0x02;
+    if (GAME->comic_jump_power > 4)     held |= 0x04;  /* Boots raise jump power to 5 */
+    if (GAME->comic_has_lantern)        held |= 0x08;
+    if (GAME->comic_has_teleport_wand)  held |= 0x10;
+    if (GAME->comic_has_gems)           held |= 0x20;
+    if (GAME->comic_has_crown)          held |= 0x40;
+    if (GAME->comic_has_gold)           held |= 0x80;
+    return held;
+}
+
+/*
+ * blastola_sprite - Inventory Blastola Cola for a firepower (1-5 cans shown)
+ */
+static const uint8_t __far *blastola_sprite(uint8_t firepower)
+{
+    switch (firepower) {
+    case 1:
+        return sprite_blastola_cola_inventory_1_even_16x16m;
+    case 2:
+        return sprite_blastola_cola_inventory_2_even_16x16m;
+    case 3:
+        return sprite_blastola_cola_inventory_3_even_16x16m;
+    case 4:
+        return sprite_blastola_cola_inventory_4_even_16x16m;
+    case 5:
+        return sprite_blastola_cola_inventory_5_even_16x16m;
+    default:
+        return sprite_blastola_cola_even_16x16m;
+    }
+}
+
+/*
+ * fireball_cell - Fill of fireball meter cell i; it holds meter units 2i+1 and 2i+2
+ */
+static uint8_t fireball_cell(uint8_t meter, uint8_t i)
+{
+    if (meter >= i * 2 + 2) {
+        return CELL_FULL;
+    }
+    return (uint8_t)(meter == i * 2 + 1 ? CELL_HALF : CELL_EMPTY);
+}
+
+/*
+ * update_score - Redraw the score digit pairs that changed
+ *
+ * The score is 3 base-100 digit pairs (see globals.h), score_bytes[0]
+ * rightmost at X=264, each shown as two 8x16 decimal digits.
+ */
+static void update_score(page_state_t *page)
+{
+    uint8_t i;
+    uint8_t value;
+    uint16_t x;
+
+    for (i = 0; i < 3; i++) {
+        value = GAME->score_bytes[i];
+        if (value == page->score_bytes[i]) {
+            continue;
+        }
+        x = SCORE_X - i * 16;
+        blit_8x16_sprite(x + 8, SCORE_Y, digit_sprites[value % 10]);
+        blit_8x16_sprite(x, SCORE_Y, digit_sprites[value / 10]);
+        page->score_bytes[i] = value;
+    }
+}
+
+/*
+ * update_inventory - Draw newly collected items and a changed Blastola Cola
+ *
+ * Items are masked over their empty slot. The Blastola Cola is unmasked,
+ * so a higher firepower's can replaces the last one.
+ */
+static void update_inventory(page_state_t *page)
+{
+    uint8_t held = items_held();
+    uint8_t added = (uint8_t)(held & ~page->items);
+    uint8_t i;
+
+    if (GAME->comic_firepower != page->firepower && GAME->comic_firepower > 0) {
+        blit_sprite_16x16_unmasked(232, 112, blastola_sprite(GAME->comic_firepower));
+    }
+    page->firepower = GAME->comic_firepower;
+
+    for (i = 0; i < NUM_ITEM_SLOTS; i++) {
+        if (added & (1 << i)) {
+            blit_sprite_16x16_masked(item_slots[i].x, item_slots[i].y, item_slots[i].sprite);
+        }
+    }
+    page->items = held;
+}
+
+/*
+ * update_meters - Redraw the fireball and HP meter cells whose fill changed
+ */
+static void update_meters(page_state_t *page)
+{
+    uint8_t meter = GAME->fireball_meter;
+    uint8_t hp = GAME->comic_hp;
+    uint8_t fill;
+    uint8_t i;
+
+    if (meter != page->fireball_meter) {
+        for (i = 0; i < MAX_FIREBALL_METER / 2; i++) {
+            fill = fireball_cell(meter, i);
+            if (page->fireball_meter == UI_UNKNOWN || fill != fireball_cell(page->fireball_meter, i)) {
+                blit_8x16_sprite(FIREBALL_METER_X + (i << 3), FIREBALL_METER_Y, cell_sprites[fill]);
+            }
+        }
+        page->fireball_meter = meter;
+    }
+
+    if (hp != page->hp) {
+        for (i = 1; i <= MAX_HP; i++) {
+            fill = (uint8_t)(i <= hp ? CELL_FULL : CELL_EMPTY);
+            if (page->hp == UI_UNKNOWN || (i <= page->hp) != (i <= hp)) {
+                blit_8x16_sprite(HP_METER_X + (i << 3), HP_METER_Y, cell_sprites[fill]);
+            }
+        }
+        page->hp = hp;
+    }
+}
+
+void ui_reset(void)
+{
+    uint8_t i;
+
+    for (i = 0; i < 2; i++) {
+        pages[i].score_bytes[0] = UI_UNKNOWN;
+        pages[i].score_bytes[1] = UI_UNKNOWN;
+        pages[i].score_bytes[2] = UI_UNKNOWN;
+        pages[i].firepower = 0;
+        pages[i].items = 0;
+        pages[i].fireball_meter = UI_UNKNOWN;
+        pages[i].hp = UI_UNKNOWN;
+    }
+}
+
+void ui_update(void)
+{
+    page_state_t *page = &pages[offscreen_video_buffer_ptr == GRAPHICS_BUFFER_GAMEPLAY_B ? 1 : 0];
+
+    update_meters(page);
+    update_inventory(page);
+    update_score(page);
+}
+
+uint8_t ui_shows_more(void)
+{
+    uint8_t held = items_held();
+    uint8_t i;
+
+    for (i = 0; i < 2; i++) {
+        if ((pages[i].items & ~held) != 0 || pages[i].firepower > GAME->comic_firepower) {
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,161 @@
+/*
+ * vram_stats.c - Video memory and EGA register traffic counters
+ *
+ * See vram.h. Only built into the game with make VRAM_STATS=1; otherwise
+ * the counting macros expand to the plain accesses and this file is empty.
+ *
+ * Call sites are kept in a small open-addressed table keyed by the
+ * __FILE__ string and line of the macro (line 0 for a whole generated
+ * compiled sprite file, see VRAM_STATS_LINE); sites that do not fit are
+ * counted together as "(other)".
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include "vram.h"
+#include "trace.h"
+
+#ifdef VRAM_STATS
+
+#define MAX_SITES           256     /* Power of two */
+#define TOP_SITES           16      /* Busiest sites in the report */
+
+typedef struct {
+    const char *file;               /* NULL = free slot */
+    uint16_t line;
+    uint32_t counts[VRAM_STATS_KINDS];
+} vram_site_t;
+
+typedef struct {
+    uint32_t sum;
+    uint32_t max;
+} frame_stats_t;
+
+static const char *kind_names[VRAM_STATS_KINDS] = {
+    "bytes read", "bytes written", "port writes"
+};
+
+static vram_site_t __far sites[MAX_SITES];
+static vram_site_t other_sites = { "(other)", 0, { 0, 0, 0 } };
+static uint32_t frame_counts[VRAM_STATS_KINDS];     /* The frame being drawn */
+static frame_stats_t frame_stats[VRAM_STATS_KINDS];
+static uint32_t frames = 0;
+
+/*
+ * find_site - Table slot for a call site, claiming a free one
+ */
+static vram_site_t __far *find_site(const char *file, uint16_t line)
+{
+    uint16_t index = (uint16_t)(line * 7) & (MAX_SITES - 1);
+    uint16_t probes;
+
+    for (probes = 0; probes < MAX_SITES; probes++) {
+        if (sites[index].file == NULL) {
+            sites[index].file = file;
+            sites[index].line = line;
+            return &sites[index];
+        }
+        if (sites[index].line == line && sites[index].file == file) {
+            return &sites[index];
+        }
+        index = (index + 1) & (MAX_SITES - 1);
+    }
+    return &other_sites;
+}
+
+/*
+ * clamp16 - A count as a trace argument
+ */
+static uint16_t clamp16(uint32_t value)
+{
+    return (uint16_t)(value > 0xffffUL ? 0xffffU : value);
+}
+
+void vram_stats_count(const char *file, uint16_t line, uint8_t kind, uint16_t amount)
+{
+    find_site(file, line)->counts[kind] += amount;
+    frame_counts[kind] += amount;
+}
+
+void vram_stats_frame(void)
+{
+    uint8_t kind;
+
+    TRACE_INSTANT(VRAM_READS, clamp16(frame_counts[VRAM_STATS_READ]));
+    TRACE_INSTANT(VRAM_WRITES, clamp16(frame_counts[VRAM_STATS_WRITE]));
+    TRACE_INSTANT(PORT_WRITES, clamp16(frame_counts[VRAM_STATS_PORT]));
+
+    for (kind = 0; kind < VRAM_STATS_KINDS; kind++) {
+        frame_stats[kind].sum += frame_counts[kind];
+        if (frame_counts[kind] > frame_stats[kind].max) {
+            frame_stats[kind].max = frame_counts[kind];
+        }
+        frame_counts[kind] = 0;
+    }
+    frames++;
+}
+
+void vram_stats_report(void (*print)(const char *format, ...))
+{
+    static uint8_t reported[MAX_SITES];
+    char name[48];
+    vram_site_t __far *site;
+    uint32_t total;
+    uint32_t best_total;
+    uint16_t best;
+    uint16_t i;
+    uint8_t rank;
+    uint8_t kind;
+
+    if (frames == 0) {
+        return;
+    }
+
+    print("VRAM traffic: %lu frames\n", (unsigned long)frames);
+    print("%-14s %10s %10s\n", "per frame", "avg", "max");
+    for (kind = 0; kind < VRAM_STATS_KINDS; kind++) {
+        print("%-14s %10lu %10lu\n", kind_names[kind],
+              (unsigned long)(frame_stats[kind].sum / frames), (unsigned long)frame_stats[kind].max);
+    }
+
+    /* Selection of the busiest sites, by all three counts together */
+    print("%-24s %10s %10s %10s\n", "call site", "read", "written", "ports");
+    for (i = 0; i < MAX_SITES; i++) {
+        reported[i] = 0;
+    }
+    for (rank = 0; rank < TOP_SITES; rank++) {
+        best = MAX_SITES;
+        best_total = 0;
+        for (i = 0; i < MAX_SITES; i++) {
+            site = &sites[i];
+            if (site->file == NULL || reported[i]) {
+                continue;
+            }
+            total = site->counts[VRAM_STATS_READ] + site->counts[VRAM_STATS_WRITE] +
+                    site->counts[VRAM_STATS_PORT];
+            if (best == MAX_SITES || total > best_total) {
+                best = i;
+                best_total = total;
+            }
+        }
+        if (best == MAX_SITES) {
+            break;
+        }
+        reported[best] = 1;
+        site = &sites[best];
+        snprintf(name, sizeof(name), "%s:%u", site->file, site->line);
+        print("%-24s %10lu %10lu %10lu\n", name,
+              (unsigned long)site->counts[VRAM_STATS_READ],
+              (unsigned long)site->counts[VRAM_STATS_WRITE],
+              (unsigned long)site->counts[VRAM_STATS_PORT]);
+    }
+    site = &other_sites;
+    if (site->counts[VRAM_STATS_READ] || site->counts[VRAM_STATS_WRITE] || site->counts[VRAM_STATS_PORT]) {
+        print("%-24s %10lu %10lu %10lu\n", site->file,
+              (unsigned long)site->counts[VRAM_STATS_READ],
+              (unsigned long)site->counts[VRAM_STATS_WRITE],
+              (unsigned long)site->counts[VRAM_STATS_PORT]);
+    }
+}
+
+#endif /* VRAM_STATS */
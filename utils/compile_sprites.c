@@ -0,0 +1,172 @@
+/*
+ * compile_sprites.c - Build-time generator for compiled sprite routines
+ *
+ * Host tool (built with the host C compiler, not Open Watcom). It links
+ * against src/sprite_data.c and, for one group from
+ * include/compiled_sprite_list.h, writes a C file containing four
+ * straight-line blit routines per sprite, one per plane:
+ *   - fully transparent bytes (mask 0xff) produce no code
+ *   - fully opaque bytes (mask 0x00) become direct stores, paired into
+ *     word stores when both bytes of a row are opaque
+ *   - partially masked bytes become a read-modify-write with constants
+ *   - planes with nothing to draw get an empty routine
+ * Video memory is accessed through the VRAM_* macros from include/vram.h,
+ * so the same output also runs against the host build's software EGA
+ * (and, with make VRAM_STATS=1, is counted as one call site per group).
+ *
+ * Usage:
+ *   compile_sprites <group> <output.c>
+ *
+ * Build (done by the Makefile):
+ *   gcc -D__far= -Iinclude -o compile_sprites utils/compile_sprites.c src/sprite_data.c
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#define SCREEN_BYTES_PER_ROW 40
+
+/* Sprite data arrays from sprite_data.c */
+#define COMPILED_SPRITE(id, group, data, rows) extern const uint8_t data[];
+#include "compiled_sprite_list.h"
+#undef COMPILED_SPRITE
+
+typedef struct {
+    const char *group;
+    const char *name;
+    const uint8_t *data;
+    int rows;
+} sprite_entry_t;
+
+static const sprite_entry_t sprite_entries[] = {
+#define COMPILED_SPRITE(id, group, data, rows) { #group, #data, data, rows },
+#include "compiled_sprite_list.h"
+#undef COMPILED_SPRITE
+    { NULL, NULL, NULL, 0 }
+};
+
+/*
+ * emit_sprite - Write the compiled plane routines for one 16-pixel-wide sprite
+ *
+ * Sprite layout: 4 planes of (rows * 2) bytes followed by a mask of the
+ * same size (mask bit = 1 keeps the background). One routine is emitted
+ * per plane; the caller selects the plane (Map Mask and Read Map Select)
+ * so that several sprites can share one register setup.
+ */
+static void emit_sprite(FILE *out, const sprite_entry_t *s)
+{
+    int plane_size = s->rows * 2;
+    const uint8_t *mask = s->data + plane_size * 4;
+    int plane;
+    int row;
+    int col;
+    int stores = 0;
+    int rmws = 0;
+
+    for (plane = 0; plane < 4; plane++) {
+        const uint8_t *pixels = s->data + plane * plane_size;
+        int emitted = 0;
+
+        fprintf(out, "void cspr_%s_p%d(uint8_t __far *dst)\n{\n", s->name, plane);
+
+        for (row = 0; row < s->rows; row++) {
+            int offset = row * SCREEN_BYTES_PER_ROW;
+            uint8_t m0 = mask[row * 2];
+            uint8_t m1 = mask[row * 2 + 1];
+
+            if (m0 == 0x00 && m1 == 0x00) {
+                /* Both bytes opaque: one word store (little-endian) */
+                fprintf(out, "    VRAM_WRITE16(dst + %d, 0x%02x%02x);\n",
+                        offset, pixels[row * 2 + 1], pixels[row * 2]);
+                stores += 2;
+                emitted++;
+                continue;
+            }
+
+            for (col = 0; col < 2; col++) {
+                uint8_t m = mask[row * 2 + col];
+                uint8_t p = (uint8_t)(pixels[row * 2 + col] & (uint8_t)~m);
+
+                if (m == 0xff) {
+                    continue;
+                }
+                if (m == 0x00) {
+                    fprintf(out, "    VRAM_WRITE(dst + %d, 0x%02x);\n", offset + col, p);
+                    stores++;
+                } else if (p == 0x00) {
+                    /* Only clearing bits under the mask */
+                    fprintf(out, "    VRAM_WRITE(dst + %d, VRAM_READ(dst + %d) & 0x%02x);\n",
+                            offset + col, offset + col, m);
+                    rmws++;
+                } else {
+                    fprintf(out, "    VRAM_WRITE(dst + %d, (uint8_t)((VRAM_READ(dst + %d) & 0x%02x) | 0x%02x));\n",
+                            offset + col, offset + col, m, p);
+                    rmws++;
+                }
+                emitted++;
+            }
+        }
+
+        if (emitted == 0) {
+            /* Nothing visible in this plane */
+            fprintf(out, "    (void)dst;\n");
+        }
+        fprintf(out, "}\n\n");
+    }
+
+    fprintf(out, "/* %s: %d direct stores, %d read-modify-writes */\n\n",
+            s->name, stores, rmws);
+}
+
+int main(int argc, char *argv[])
+{
+    const sprite_entry_t *s;
+    FILE *out;
+    int count = 0;
+
+    if (argc != 3) {
+        fprintf(stderr, "Usage: %s <group> <output.c>\n", argv[0]);
+        return 1;
+    }
+
+    out = fopen(argv[2], "w");
+    if (out == NULL) {
+        fprintf(stderr, "ERROR: Cannot create '%s'\n", argv[2]);
+        return 1;
+    }
+
+    fprintf(out,
+            "/*\n"
+            " * cspr_%s.c - Compiled sprite routines (group '%s')\n"
+            " * \n"
+            " * Generated by utils/compile_sprites.c from src/sprite_data.c\n"
+            " * DO NOT EDIT MANUALLY\n"
+            " */\n\n"
+            "#include <stdint.h>\n"
+            "#include \"compiled_sprites.h\"\n"
+            "#define VRAM_STATS_LINE 0   /* make VRAM_STATS=1: one call site per group */\n"
+            "#include \"vram.h\"\n\n",
+            argv[1], argv[1]);
+
+    for (s = sprite_entries; s->name != NULL; s++) {
+        if (strcmp(s->group, argv[1]) != 0) {
+            continue;
+        }
+        if (s->rows != 8 && s->rows != 16 && s->rows != 32) {
+            fprintf(stderr, "ERROR: %s has unsupported height %d\n", s->name, s->rows);
+            fclose(out);
+            return 1;
+        }
+        emit_sprite(out, s);
+        count++;
+    }
+
+    fclose(out);
+
+    if (count == 0) {
+        fprintf(stderr, "ERROR: No sprites in group '%s'\n", argv[1]);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,244 @@
+/*
+ * trace2json.c - Convert a TRACE.BIN tick trace to Chrome trace JSON
+ *
+ * Host tool (built with the host C compiler, not Open Watcom). Reads the
+ * file written by /TRACE or comic-sim -T (layout in include/trace.h) and
+ * writes the Trace Event Format that chrome://tracing and
+ * ui.perfetto.dev load:
+ *   - thread 1 "ticks": one span per game tick, from one tick start to
+ *     the next
+ *   - thread 2 "game": each tick's phases (from one PROFILE_MARK() to the
+ *     next, see profile.h), with the load, render, blit and door and
+ *     teleport spans nested in them
+ *   - thread 3 "sound": a counter of the speaker frequency, changing at
+ *     every note
+ *   - with make VRAM_STATS=1, counters of each frame's video memory reads
+ *     and writes and EGA register writes (see vram.h)
+ * Timestamps are microseconds from the first record. The ring may have
+ * dropped the start of a span; its end is skipped. Spans still open at
+ * the end of the trace are closed at the last record.
+ *
+ * Usage:
+ *   trace2json TRACE.BIN [trace.json]     (JSON to stdout without a name)
+ *
+ * Build (done by the Makefile):
+ *   gcc -D__far= -Iinclude -o trace2json utils/trace2json.c
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "profile.h"
+#include "trace.h"
+
+#define TID_TICKS   1
+#define TID_GAME    2
+#define TID_SOUND   3
+
+#define MAX_OPEN_SPANS  32
+
+static const char *event_names[TRACE_NUM_EVENTS] = {
+#define TRACE_EVENT_DEF(id, name) name,
+#include "trace_events.h"
+#undef TRACE_EVENT_DEF
+};
+
+/* In PROFILE_* order */
+static const char *phase_names[PROFILE_NUM_PHASES] = {
+    "wait", "rewind", "input", "physics", "map", "comic", "enemies",
+    "fireballs", "items", "ui", "swap", "other"
+};
+
+static FILE *out;
+static double clock_hz;
+static unsigned long events_written = 0;
+static uint8_t open_spans[MAX_OPEN_SPANS];     /* Events begun and not ended, innermost last */
+static unsigned num_open_spans = 0;
+
+/*
+ * get_u16, get_u32 - Read a little-endian value
+ */
+static uint16_t get_u16(const uint8_t *src)
+{
+    return (uint16_t)(src[0] | (src[1] << 8));
+}
+
+static uint32_t get_u32(const uint8_t *src)
+{
+    return (uint32_t)get_u16(src) | ((uint32_t)get_u16(src + 2) << 16);
+}
+
+/*
+ * to_us - Clock counts since the first record in microseconds
+ */
+static double to_us(int64_t counts)
+{
+    return (double)counts * 1e6 / clock_hz;
+}
+
+/*
+ * begin_event - Start a JSON event object; the caller adds fields and "}"
+ */
+static void begin_event(const char *name, const char *ph, int tid, int64_t time)
+{
+    fprintf(out, "%s\n{\"name\":\"%s\",\"ph\":\"%s\",\"pid\":1,\"tid\":%d,\"ts\":%.3f",
+            events_written++ ? "," : "", name, ph, tid, to_us(time));
+}
+
+static void complete_event(const char *name, int tid, int64_t start, int64_t end)
+{
+    begin_event(name, "X", tid, start);
+    fprintf(out, ",\"dur\":%.3f}", to_us(end) - to_us(start));
+}
+
+/*
+ * end_span - End the innermost open span of an event, and any inside it
+ *
+ * An end with no open span (its begin was overwritten in the ring) is
+ * dropped.
+ */
+static void end_span(uint8_t event, int64_t time)
+{
+    unsigned depth = num_open_spans;
+
+    while (depth > 0 && open_spans[depth - 1] != event) {
+        depth--;
+    }
+    if (depth == 0) {
+        return;
+    }
+    while (num_open_spans >= depth) {
+        num_open_spans--;
+        begin_event(event_names[open_spans[num_open_spans]], "E", TID_GAME, time);
+        fprintf(out, "}");
+    }
+}
+
+static void thread_name(int tid, const char *name)
+{
+    fprintf(out, "%s\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,"
+            "\"args\":{\"name\":\"%s\"}}", events_written++ ? "," : "", tid, name);
+}
+
+int main(int argc, char *argv[])
+{
+    FILE *in;
+    uint8_t header[TRACE_HEADER_SIZE];
+    uint8_t record[TRACE_RECORD_SIZE];
+    uint32_t count;
+    uint32_t i;
+    uint32_t raw;
+    uint32_t last_raw = 0;
+    int64_t time = 0;           /* Counts since the first record, unwrapped */
+    int64_t tick_start = -1;
+    int64_t phase_start = -1;
+    unsigned long ticks = 0;
+    uint8_t type;
+    uint8_t event;
+    uint16_t arg;
+    char name[32];
+
+    if (argc != 2 && argc != 3) {
+        fprintf(stderr, "Usage: %s TRACE.BIN [trace.json]\n", argv[0]);
+        return 1;
+    }
+
+    in = fopen(argv[1], "rb");
+    if (in == NULL) {
+        fprintf(stderr, "ERROR: Cannot open '%s'\n", argv[1]);
+        return 1;
+    }
+    if (fread(header, 1, sizeof(header), in) != sizeof(header) ||
+        memcmp(header, TRACE_FILE_MAGIC, 4) != 0 ||
+        get_u16(header + 4) != TRACE_FILE_VERSION ||
+        get_u16(header + 6) != TRACE_RECORD_SIZE) {
+        fprintf(stderr, "ERROR: '%s' is not a version %d trace file\n", argv[1], TRACE_FILE_VERSION);
+        fclose(in);
+        return 1;
+    }
+    clock_hz = (double)get_u32(header + 8);
+    count = get_u32(header + 12);
+    if (clock_hz <= 0.0) {
+        fprintf(stderr, "ERROR: '%s' has no clock rate\n", argv[1]);
+        fclose(in);
+        return 1;
+    }
+
+    out = stdout;
+    if (argc == 3) {
+        out = fopen(argv[2], "w");
+        if (out == NULL) {
+            fprintf(stderr, "ERROR: Cannot create '%s'\n", argv[2]);
+            fclose(in);
+            return 1;
+        }
+    }
+
+    fprintf(out, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+    thread_name(TID_TICKS, "ticks");
+    thread_name(TID_GAME, "game");
+    thread_name(TID_SOUND, "sound");
+
+    for (i = 0; i < count; i++) {
+        if (fread(record, 1, sizeof(record), in) != sizeof(record)) {
+            fprintf(stderr, "ERROR: '%s' ends after %lu of %lu records\n", argv[1],
+                    (unsigned long)i, (unsigned long)count);
+            break;
+        }
+        raw = get_u32(record);
+        type = record[4];
+        event = record[5];
+        arg = get_u16(record + 6);
+
+        /* The clock wraps every hour or so */
+        if (i > 0) {
+            time += (uint32_t)(raw - last_raw);
+        }
+        last_raw = raw;
+
+        if (event >= TRACE_NUM_EVENTS) {
+            continue;
+        }
+
+        if (event == TRACE_EVENT_TICK) {
+            if (tick_start >= 0) {
+                sprintf(name, "tick %lu", ticks++);
+                complete_event(name, TID_TICKS, tick_start, time);
+            }
+            tick_start = time;
+            phase_start = time;
+        } else if (event == TRACE_EVENT_PHASE) {
+            if (phase_start >= 0 && arg < PROFILE_NUM_PHASES) {
+                complete_event(phase_names[arg], TID_GAME, phase_start, time);
+            }
+            phase_start = time;
+        } else if (event == TRACE_EVENT_SOUND_NOTE) {
+            begin_event("speaker Hz", "C", TID_SOUND, time);
+            fprintf(out, ",\"args\":{\"Hz\":%.0f}}", arg ? clock_hz / arg : 0.0);
+        } else if (event == TRACE_EVENT_VRAM_READS || event == TRACE_EVENT_VRAM_WRITES ||
+                   event == TRACE_EVENT_PORT_WRITES) {
+            begin_event(event_names[event], "C", TID_GAME, time);
+            fprintf(out, ",\"args\":{\"count\":%u}}", arg);
+        } else if (type == TRACE_TYPE_BEGIN && num_open_spans < MAX_OPEN_SPANS) {
+            begin_event(event_names[event], "B", TID_GAME, time);
+            fprintf(out, ",\"args\":{\"arg\":%u}}", arg);
+            open_spans[num_open_spans++] = event;
+        } else if (type == TRACE_TYPE_END) {
+            end_span(event, time);
+        } else if (type == TRACE_TYPE_INSTANT) {
+            begin_event(event_names[event], "i", TID_GAME, time);
+            fprintf(out, ",\"s\":\"t\",\"args\":{\"arg\":%u}}", arg);
+        }
+    }
+    fclose(in);
+
+    if (num_open_spans > 0) {
+        end_span(open_spans[0], time);
+    }
+    fprintf(out, "\n]}\n");
+
+    if (out != stdout) {
+        fclose(out);
+    }
+    return 0;
+}